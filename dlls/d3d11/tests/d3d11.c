@@ -34411,6 +34411,73 @@ static void test_dynamic_map_synchronization(void)
     release_test_context(&test_context);
 }
 
+static void test_dynamic_map_discard(void)
+{
+    struct d3d11_test_context test_context;
+    ID3D11Buffer *buffer, *dst_buffer;
+    D3D11_BUFFER_DESC buffer_desc = {0};
+    D3D11_MAPPED_SUBRESOURCE map_desc;
+    ID3D11DeviceContext *immediate;
+    struct resource_readback rb;
+    unsigned int i, j, value;
+    ID3D11Device *device;
+    DWORD start_time;
+    D3D11_BOX box;
+    HRESULT hr;
+
+    static const unsigned int map_count = 4096;
+    static const unsigned int buffer_size = 16 * 1024;
+
+    if (!init_test_context(&test_context, NULL))
+        return;
+    device = test_context.device;
+    immediate = test_context.immediate_context;
+
+    buffer_desc.ByteWidth = buffer_size;
+    buffer_desc.Usage = D3D11_USAGE_DYNAMIC;
+    buffer_desc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+    buffer_desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+    hr = ID3D11Device_CreateBuffer(device, &buffer_desc, NULL, &buffer);
+    ok(hr == S_OK, "Got unexpected hr %#lx.\n", hr);
+
+    dst_buffer = create_buffer(device, 0, map_count * sizeof(value), NULL);
+
+    /* Discard the whole buffer every time, and copy one value out of it, so
+     * that every discarded copy has to stay valid until it's been used. */
+    start_time = GetTickCount();
+    for (i = 0; i < map_count; ++i)
+    {
+        hr = ID3D11DeviceContext_Map(immediate, (ID3D11Resource *)buffer,
+                0, D3D11_MAP_WRITE_DISCARD, 0, &map_desc);
+        ok(hr == S_OK, "Got unexpected hr %#lx.\n", hr);
+        for (j = 0; j < buffer_size / sizeof(value); ++j)
+            ((unsigned int *)map_desc.pData)[j] = i;
+        ID3D11DeviceContext_Unmap(immediate, (ID3D11Resource *)buffer, 0);
+
+        set_box(&box, (i % (buffer_size / sizeof(value))) * sizeof(value), 0, 0,
+                (i % (buffer_size / sizeof(value)) + 1) * sizeof(value), 1, 1);
+        ID3D11DeviceContext_CopySubresourceRegion(immediate, (ID3D11Resource *)dst_buffer, 0,
+                i * sizeof(value), 0, 0, (ID3D11Resource *)buffer, 0, &box);
+    }
+
+    get_buffer_readback(dst_buffer, &rb);
+    if (winetest_debug > 1)
+        trace("%u discard maps of a %u byte buffer took %lu ms.\n",
+                map_count, buffer_size, GetTickCount() - start_time);
+    for (i = 0; i < map_count; ++i)
+    {
+        value = get_readback_u32(&rb, i, 0, 0);
+        ok(value == i, "Got unexpected value %#x at %u.\n", value, i);
+        if (value != i)
+            break;
+    }
+    release_resource_readback(&rb);
+
+    ID3D11Buffer_Release(dst_buffer);
+    ID3D11Buffer_Release(buffer);
+    release_test_context(&test_context);
+}
+
 static void test_user_defined_annotation(void)
 {
     struct d3d11_test_context test_context;
@@ -35611,6 +35678,117 @@ static void test_stencil_export(void)
     release_test_context(&test_context);
 }
 
+static void test_shader_cache_child(void)
+{
+    static const struct vec4 green = {0.0f, 1.0f, 0.0f, 1.0f};
+    struct d3d11_test_context test_context;
+
+    if (!init_test_context(&test_context, NULL))
+        return;
+
+    draw_color_quad(&test_context, &green);
+    check_texture_color(test_context.backbuffer, 0xff00ff00, 1);
+
+    release_test_context(&test_context);
+}
+
+static unsigned int count_shader_cache_entries(const char *dir, BOOL delete)
+{
+    char path[MAX_PATH];
+    WIN32_FIND_DATAA data;
+    unsigned int count = 0;
+    HANDLE find;
+
+    sprintf(path, "%s\\*.bin", dir);
+    if ((find = FindFirstFileA(path, &data)) == INVALID_HANDLE_VALUE)
+        return 0;
+    do
+    {
+        ++count;
+        if (delete)
+        {
+            sprintf(path, "%s\\%s", dir, data.cFileName);
+            DeleteFileA(path);
+        }
+    } while (FindNextFileA(find, &data));
+    FindClose(find);
+
+    return count;
+}
+
+static void test_shader_cache(void)
+{
+    char temp_dir[MAX_PATH], cache_dir[MAX_PATH], cmdline[MAX_PATH + 32];
+    char old_config[256], config[ARRAY_SIZE(old_config) + MAX_PATH + 64];
+    unsigned int i, count, first_count = 0;
+    STARTUPINFOA si = {sizeof(si)};
+    PROCESS_INFORMATION pi;
+    DWORD old_config_len;
+    char **argv;
+    BOOL ret;
+
+    /* The cache is only used by the wined3d GL renderer, for linked GLSL programs. */
+    if (strcmp(winetest_platform, "wine") || damavand)
+    {
+        skip("Shader cache tests require the wined3d GL renderer.\n");
+        return;
+    }
+
+    winetest_get_mainargs(&argv);
+
+    GetTempPathA(ARRAY_SIZE(temp_dir), temp_dir);
+    ret = GetTempFileNameA(temp_dir, "d3d", 0, cache_dir);
+    ok(ret, "Failed to get a temporary file name, error %lu.\n", GetLastError());
+    DeleteFileA(cache_dir);
+    ret = CreateDirectoryA(cache_dir, NULL);
+    ok(ret, "Failed to create directory \"%s\", error %lu.\n", cache_dir, GetLastError());
+
+    old_config_len = GetEnvironmentVariableA("WINE_D3D_CONFIG", old_config, ARRAY_SIZE(old_config));
+    if (old_config_len >= ARRAY_SIZE(old_config))
+    {
+        skip("WINE_D3D_CONFIG is too long.\n");
+        RemoveDirectoryA(cache_dir);
+        return;
+    }
+    sprintf(config, "%s%sShaderCacheSize=16,ShaderCachePath=%s",
+            old_config, old_config_len ? "," : "", cache_dir);
+    SetEnvironmentVariableA("WINE_D3D_CONFIG", config);
+
+    /* The first child populates the cache, the second one draws with the
+     * programs loaded from it. */
+    for (i = 0; i < 2; ++i)
+    {
+        sprintf(cmdline, "\"%s\" d3d11 shader_cache", argv[0]);
+        ret = CreateProcessA(NULL, cmdline, NULL, NULL, FALSE, 0, NULL, NULL, &si, &pi);
+        ok(ret, "Failed to create process, error %lu.\n", GetLastError());
+        if (!ret)
+            break;
+        wait_child_process(pi.hProcess);
+        CloseHandle(pi.hProcess);
+        CloseHandle(pi.hThread);
+
+        count = count_shader_cache_entries(cache_dir, FALSE);
+        if (!i)
+        {
+            if (!count)
+            {
+                skip("No shader cache entries were written.\n");
+                break;
+            }
+            first_count = count;
+        }
+        else
+        {
+            ok(count == first_count, "Got %u cache entries, expected %u.\n", count, first_count);
+        }
+    }
+
+    SetEnvironmentVariableA("WINE_D3D_CONFIG", old_config_len ? old_config : NULL);
+    count_shader_cache_entries(cache_dir, TRUE);
+    ret = RemoveDirectoryA(cache_dir);
+    ok(ret, "Failed to remove directory \"%s\", error %lu.\n", cache_dir, GetLastError());
+}
+
 START_TEST(d3d11)
 {
     unsigned int argc, i;
@@ -35634,6 +35812,12 @@ START_TEST(d3d11)
         use_mt = FALSE;
 
     argc = winetest_get_mainargs(&argv);
+    if (argc >= 3 && !strcmp(argv[2], "shader_cache"))
+    {
+        test_shader_cache_child();
+        return;
+    }
+
     for (i = 2; i < argc; ++i)
     {
         if (!strcmp(argv[i], "--validate"))
@@ -35800,6 +35984,7 @@ START_TEST(d3d11)
     queue_test(test_texture_compressed_3d);
     queue_test(test_constant_buffer_offset);
     queue_test(test_dynamic_map_synchronization);
+    queue_test(test_dynamic_map_discard);
     queue_test(test_user_defined_annotation);
     queue_test(test_logic_op);
     queue_test(test_rtv_depth_slice);
@@ -35809,6 +35994,7 @@ START_TEST(d3d11)
     queue_test(test_keyed_mutex);
     queue_test(test_clear_during_render);
     queue_test(test_stencil_export);
+    queue_test(test_shader_cache);
 
     run_queued_tests();
 
@@ -1497,6 +1497,435 @@ static void test_invalid_command_queue_types(void)
     ok(!refcount, "Device has %lu references left.\n", refcount);
 }
 
+static const DWORD simple_cs_code[] =
+{
+#if 0
+    [numthreads(1, 1, 1)]
+    void main() { }
+#endif
+    0x43425844, 0x1acc3ad0, 0x71c7b057, 0xc72c4306, 0xf432cb57, 0x00000001, 0x00000074, 0x00000003,
+    0x0000002c, 0x0000003c, 0x0000004c, 0x4e475349, 0x00000008, 0x00000000, 0x00000008, 0x4e47534f,
+    0x00000008, 0x00000000, 0x00000008, 0x58454853, 0x00000020, 0x00050050, 0x00000008, 0x0100086a,
+    0x0400009b, 0x00000001, 0x00000001, 0x00000001, 0x0100003e,
+};
+
+static ID3D12RootSignature *create_empty_root_signature(ID3D12Device *device)
+{
+    D3D12_ROOT_SIGNATURE_DESC root_signature_desc = {0};
+    ID3D12RootSignature *root_signature = NULL;
+    HRESULT hr;
+
+    hr = create_root_signature(device, &root_signature_desc, &root_signature);
+    ok(hr == S_OK, "Got unexpected hr %#lx.\n", hr);
+
+    return root_signature;
+}
+
+static void test_cached_pso(void)
+{
+    ID3D12RootSignature *root_signature, *root_signature2;
+    D3D12_FEATURE_DATA_SHADER_CACHE shader_cache;
+    D3D12_COMPUTE_PIPELINE_STATE_DESC desc;
+    ID3D12PipelineState *state, *state2;
+    ID3D12Device *device;
+    ID3DBlob *blob;
+    ULONG refcount;
+    HRESULT hr;
+
+    if (!(device = create_device()))
+    {
+        skip("Failed to create device.\n");
+        return;
+    }
+
+    hr = ID3D12Device_CheckFeatureSupport(device, D3D12_FEATURE_SHADER_CACHE, &shader_cache, sizeof(shader_cache));
+    if (FAILED(hr) || !(shader_cache.SupportFlags & D3D12_SHADER_CACHE_SUPPORT_SINGLE_PSO))
+    {
+        skip("Cached PSOs are not supported.\n");
+        ID3D12Device_Release(device);
+        return;
+    }
+
+    root_signature = create_default_root_signature(device);
+    root_signature2 = create_empty_root_signature(device);
+
+    memset(&desc, 0, sizeof(desc));
+    desc.pRootSignature = root_signature;
+    desc.CS.pShaderBytecode = simple_cs_code;
+    desc.CS.BytecodeLength = sizeof(simple_cs_code);
+    hr = ID3D12Device_CreateComputePipelineState(device, &desc, &IID_ID3D12PipelineState, (void **)&state);
+    ok(hr == S_OK, "Got unexpected hr %#lx.\n", hr);
+
+    hr = ID3D12PipelineState_GetCachedBlob(state, &blob);
+    ok(hr == S_OK, "Got unexpected hr %#lx.\n", hr);
+    ok(ID3D10Blob_GetBufferSize(blob) > 0, "Got empty cached blob.\n");
+
+    desc.CachedPSO.pCachedBlob = ID3D10Blob_GetBufferPointer(blob);
+    desc.CachedPSO.CachedBlobSizeInBytes = ID3D10Blob_GetBufferSize(blob);
+    hr = ID3D12Device_CreateComputePipelineState(device, &desc, &IID_ID3D12PipelineState, (void **)&state2);
+    ok(hr == S_OK, "Got unexpected hr %#lx.\n", hr);
+    ID3D12PipelineState_Release(state2);
+
+    /* The cached blob must match the description. */
+    desc.pRootSignature = root_signature2;
+    hr = ID3D12Device_CreateComputePipelineState(device, &desc, &IID_ID3D12PipelineState, (void **)&state2);
+    ok(hr == E_INVALIDARG, "Got unexpected hr %#lx.\n", hr);
+
+    desc.CachedPSO.pCachedBlob = NULL;
+    hr = ID3D12Device_CreateComputePipelineState(device, &desc, &IID_ID3D12PipelineState, (void **)&state2);
+    ok(hr == E_INVALIDARG, "Got unexpected hr %#lx.\n", hr);
+
+    ID3D10Blob_Release(blob);
+    ID3D12PipelineState_Release(state);
+    ID3D12RootSignature_Release(root_signature2);
+    ID3D12RootSignature_Release(root_signature);
+    refcount = ID3D12Device_Release(device);
+    ok(!refcount, "Device has %lu references left.\n", refcount);
+}
+
+static void test_pipeline_library(void)
+{
+    ID3D12RootSignature *root_signature, *root_signature2;
+    D3D12_FEATURE_DATA_SHADER_CACHE shader_cache;
+    ID3D12PipelineLibrary *library, *library2;
+    D3D12_COMPUTE_PIPELINE_STATE_DESC desc;
+    ID3D12PipelineState *state, *state2;
+    SIZE_T size, size2;
+    ID3D12Device1 *device1;
+    ID3D12Device *device;
+    ULONG refcount;
+    void *data;
+    HRESULT hr;
+
+    if (!(device = create_device()))
+    {
+        skip("Failed to create device.\n");
+        return;
+    }
+
+    hr = ID3D12Device_CheckFeatureSupport(device, D3D12_FEATURE_SHADER_CACHE, &shader_cache, sizeof(shader_cache));
+    if (FAILED(hr) || !(shader_cache.SupportFlags & D3D12_SHADER_CACHE_SUPPORT_LIBRARY)
+            || FAILED(ID3D12Device_QueryInterface(device, &IID_ID3D12Device1, (void **)&device1)))
+    {
+        skip("Pipeline libraries are not supported.\n");
+        ID3D12Device_Release(device);
+        return;
+    }
+
+    root_signature = create_default_root_signature(device);
+    root_signature2 = create_empty_root_signature(device);
+
+    memset(&desc, 0, sizeof(desc));
+    desc.pRootSignature = root_signature;
+    desc.CS.pShaderBytecode = simple_cs_code;
+    desc.CS.BytecodeLength = sizeof(simple_cs_code);
+    hr = ID3D12Device_CreateComputePipelineState(device, &desc, &IID_ID3D12PipelineState, (void **)&state);
+    ok(hr == S_OK, "Got unexpected hr %#lx.\n", hr);
+
+    hr = ID3D12Device1_CreatePipelineLibrary(device1, NULL, 0, &IID_ID3D12PipelineLibrary, (void **)&library);
+    ok(hr == S_OK, "Got unexpected hr %#lx.\n", hr);
+
+    hr = ID3D12PipelineLibrary_StorePipeline(library, NULL, state);
+    ok(hr == E_INVALIDARG, "Got unexpected hr %#lx.\n", hr);
+    hr = ID3D12PipelineLibrary_StorePipeline(library, L"compute", state);
+    ok(hr == S_OK, "Got unexpected hr %#lx.\n", hr);
+    hr = ID3D12PipelineLibrary_StorePipeline(library, L"compute", state);
+    ok(hr == E_INVALIDARG, "Got unexpected hr %#lx.\n", hr);
+
+    hr = ID3D12PipelineLibrary_LoadComputePipeline(library, L"compute", &desc,
+            &IID_ID3D12PipelineState, (void **)&state2);
+    ok(hr == S_OK, "Got unexpected hr %#lx.\n", hr);
+    ID3D12PipelineState_Release(state2);
+    hr = ID3D12PipelineLibrary_LoadComputePipeline(library, L"missing", &desc,
+            &IID_ID3D12PipelineState, (void **)&state2);
+    ok(hr == E_INVALIDARG, "Got unexpected hr %#lx.\n", hr);
+
+    desc.pRootSignature = root_signature2;
+    hr = ID3D12PipelineLibrary_LoadComputePipeline(library, L"compute", &desc,
+            &IID_ID3D12PipelineState, (void **)&state2);
+    ok(hr == E_INVALIDARG, "Got unexpected hr %#lx.\n", hr);
+    desc.pRootSignature = root_signature;
+
+    size = ID3D12PipelineLibrary_GetSerializedSize(library);
+    ok(size > 0, "Got unexpected size %Iu.\n", size);
+    data = malloc(size);
+    hr = ID3D12PipelineLibrary_Serialize(library, data, size - 1);
+    ok(hr == E_INVALIDARG, "Got unexpected hr %#lx.\n", hr);
+    hr = ID3D12PipelineLibrary_Serialize(library, data, size);
+    ok(hr == S_OK, "Got unexpected hr %#lx.\n", hr);
+
+    hr = ID3D12Device1_CreatePipelineLibrary(device1, data, size, &IID_ID3D12PipelineLibrary, (void **)&library2);
+    ok(hr == S_OK, "Got unexpected hr %#lx.\n", hr);
+    size2 = ID3D12PipelineLibrary_GetSerializedSize(library2);
+    ok(size2 == size, "Got unexpected size %Iu, expected %Iu.\n", size2, size);
+
+    hr = ID3D12PipelineLibrary_StorePipeline(library2, L"compute", state);
+    ok(hr == E_INVALIDARG, "Got unexpected hr %#lx.\n", hr);
+    hr = ID3D12PipelineLibrary_LoadComputePipeline(library2, L"compute", &desc,
+            &IID_ID3D12PipelineState, (void **)&state2);
+    ok(hr == S_OK, "Got unexpected hr %#lx.\n", hr);
+    ID3D12PipelineState_Release(state2);
+
+    desc.pRootSignature = root_signature2;
+    hr = ID3D12PipelineLibrary_LoadComputePipeline(library2, L"compute", &desc,
+            &IID_ID3D12PipelineState, (void **)&state2);
+    ok(hr == E_INVALIDARG, "Got unexpected hr %#lx.\n", hr);
+
+    ID3D12PipelineLibrary_Release(library2);
+    free(data);
+
+    ID3D12PipelineLibrary_Release(library);
+    ID3D12PipelineState_Release(state);
+    ID3D12RootSignature_Release(root_signature2);
+    ID3D12RootSignature_Release(root_signature);
+    ID3D12Device1_Release(device1);
+    refcount = ID3D12Device_Release(device);
+    ok(!refcount, "Device has %lu references left.\n", refcount);
+}
+
+static void test_committed_resource_zeroed(void)
+{
+    static const float color[] = {1.0f, 1.0f, 1.0f, 1.0f};
+    static const unsigned int buffer_size = 0x1000;
+    D3D12_CPU_DESCRIPTOR_HANDLE rtv_handle;
+    D3D12_DESCRIPTOR_HEAP_DESC heap_desc;
+    D3D12_HEAP_PROPERTIES heap_properties;
+    struct test_context_desc desc = {0};
+    ID3D12Resource *buffer, *upload, *rb;
+    D3D12_RESOURCE_DESC resource_desc;
+    ID3D12GraphicsCommandList *list;
+    struct test_context context;
+    ID3D12DescriptorHeap *heap;
+    ID3D12Resource *texture;
+    unsigned int i, j;
+    ID3D12Device *device;
+    D3D12_RANGE range;
+    DWORD *data;
+    HRESULT hr;
+
+    desc.no_render_target = TRUE;
+    if (!init_test_context(&context, &desc))
+        return;
+    device = context.device;
+    list = context.list[0];
+
+    /* Small committed resources may be placed in memory which previously
+     * belonged to a released resource. It must still read back as zero. */
+    upload = create_buffer(device, D3D12_HEAP_TYPE_UPLOAD, buffer_size,
+            D3D12_RESOURCE_FLAG_NONE, D3D12_RESOURCE_STATE_GENERIC_READ);
+    hr = ID3D12Resource_Map(upload, 0, NULL, (void **)&data);
+    ok(hr == S_OK, "Got unexpected hr %#lx.\n", hr);
+    memset(data, 0xcc, buffer_size);
+    ID3D12Resource_Unmap(upload, 0, NULL);
+    rb = create_readback_buffer(device, buffer_size);
+
+    for (i = 0; i < 16; ++i)
+    {
+        buffer = create_buffer(device, D3D12_HEAP_TYPE_DEFAULT, buffer_size,
+                D3D12_RESOURCE_FLAG_NONE, D3D12_RESOURCE_STATE_COPY_SOURCE);
+
+        reset_command_list(&context, 0);
+        ID3D12GraphicsCommandList_CopyBufferRegion(list, rb, 0, buffer, 0, buffer_size);
+        transition_sub_resource_state(list, buffer, 0,
+                D3D12_RESOURCE_STATE_COPY_SOURCE, D3D12_RESOURCE_STATE_COPY_DEST);
+        ID3D12GraphicsCommandList_CopyBufferRegion(list, buffer, 0, upload, 0, buffer_size);
+        hr = ID3D12GraphicsCommandList_Close(list);
+        ok(hr == S_OK, "Got unexpected hr %#lx.\n", hr);
+        exec_command_list(context.queue, list);
+        wait_queue_idle(device, context.queue);
+
+        range.Begin = 0;
+        range.End = buffer_size;
+        hr = ID3D12Resource_Map(rb, 0, &range, (void **)&data);
+        ok(hr == S_OK, "Got unexpected hr %#lx.\n", hr);
+        for (j = 0; j < buffer_size / sizeof(*data); ++j)
+        {
+            if (data[j])
+                break;
+        }
+        ok(j == buffer_size / sizeof(*data), "Buffer %u: got unexpected data at %u.\n", i, j);
+        range.End = 0;
+        ID3D12Resource_Unmap(rb, 0, &range);
+
+        ID3D12Resource_Release(buffer);
+    }
+
+    /* The same for upload buffers, which are written from the CPU. */
+    for (i = 0; i < 16; ++i)
+    {
+        buffer = create_buffer(device, D3D12_HEAP_TYPE_UPLOAD, buffer_size,
+                D3D12_RESOURCE_FLAG_NONE, D3D12_RESOURCE_STATE_GENERIC_READ);
+        hr = ID3D12Resource_Map(buffer, 0, NULL, (void **)&data);
+        ok(hr == S_OK, "Got unexpected hr %#lx.\n", hr);
+        for (j = 0; j < buffer_size / sizeof(*data); ++j)
+        {
+            if (data[j])
+                break;
+        }
+        ok(j == buffer_size / sizeof(*data), "Upload buffer %u: got unexpected data at %u.\n", i, j);
+        memset(data, 0xcc, buffer_size);
+        ID3D12Resource_Unmap(buffer, 0, NULL);
+        ID3D12Resource_Release(buffer);
+    }
+
+    /* And for textures. */
+    heap_desc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
+    heap_desc.NumDescriptors = 1;
+    heap_desc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+    heap_desc.NodeMask = 0;
+    hr = ID3D12Device_CreateDescriptorHeap(device, &heap_desc, &IID_ID3D12DescriptorHeap, (void **)&heap);
+    ok(hr == S_OK, "Got unexpected hr %#lx.\n", hr);
+    rtv_handle = ID3D12DescriptorHeap_GetCPUDescriptorHandleForHeapStart(heap);
+
+    memset(&heap_properties, 0, sizeof(heap_properties));
+    heap_properties.Type = D3D12_HEAP_TYPE_DEFAULT;
+    resource_desc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+    resource_desc.Alignment = 0;
+    resource_desc.Width = 32;
+    resource_desc.Height = 32;
+    resource_desc.DepthOrArraySize = 1;
+    resource_desc.MipLevels = 1;
+    resource_desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    resource_desc.SampleDesc.Count = 1;
+    resource_desc.SampleDesc.Quality = 0;
+    resource_desc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+    resource_desc.Flags = D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET;
+
+    for (i = 0; i < 16; ++i)
+    {
+        hr = ID3D12Device_CreateCommittedResource(device, &heap_properties, D3D12_HEAP_FLAG_NONE,
+                &resource_desc, D3D12_RESOURCE_STATE_COPY_SOURCE, NULL, &IID_ID3D12Resource, (void **)&texture);
+        ok(hr == S_OK, "Got unexpected hr %#lx.\n", hr);
+
+        reset_command_list(&context, 0);
+        check_sub_resource_uint(texture, 0, context.queue, list, 0x00000000, 0);
+
+        reset_command_list(&context, 0);
+        transition_sub_resource_state(list, texture, 0,
+                D3D12_RESOURCE_STATE_COPY_SOURCE, D3D12_RESOURCE_STATE_RENDER_TARGET);
+        ID3D12Device_CreateRenderTargetView(device, texture, NULL, rtv_handle);
+        ID3D12GraphicsCommandList_ClearRenderTargetView(list, rtv_handle, color, 0, NULL);
+        hr = ID3D12GraphicsCommandList_Close(list);
+        ok(hr == S_OK, "Got unexpected hr %#lx.\n", hr);
+        exec_command_list(context.queue, list);
+        wait_queue_idle(device, context.queue);
+
+        ID3D12Resource_Release(texture);
+    }
+
+    ID3D12DescriptorHeap_Release(heap);
+    ID3D12Resource_Release(rb);
+    ID3D12Resource_Release(upload);
+    destroy_test_context(&context);
+}
+
+struct copy_descriptors_thread_data
+{
+    ID3D12Device *device;
+    D3D12_CPU_DESCRIPTOR_HANDLE dst, src;
+    unsigned int count, increment, iterations;
+};
+
+static DWORD WINAPI copy_descriptors_thread(void *param)
+{
+    const struct copy_descriptors_thread_data *data = param;
+    D3D12_CPU_DESCRIPTOR_HANDLE dst, src;
+    unsigned int i, j;
+
+    for (i = 0; i < data->iterations; ++i)
+    {
+        /* Rotate the copies, so that every one changes the destination. */
+        j = i % data->count;
+        dst.ptr = data->dst.ptr;
+        src.ptr = data->src.ptr + j * data->increment;
+        ID3D12Device_CopyDescriptorsSimple(data->device, data->count - j, dst, src,
+                D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+        dst.ptr = data->dst.ptr + (data->count - j) * data->increment;
+        src.ptr = data->src.ptr;
+        if (j)
+            ID3D12Device_CopyDescriptorsSimple(data->device, j, dst, src,
+                    D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+    }
+
+    return 0;
+}
+
+static void test_copy_descriptors_throughput(void)
+{
+    static const unsigned int descriptor_count = 4096, thread_count = 4, iterations = 256;
+    struct copy_descriptors_thread_data thread_data[4];
+    ID3D12DescriptorHeap *cpu_heap, *gpu_heap;
+    D3D12_CONSTANT_BUFFER_VIEW_DESC cbv_desc;
+    D3D12_DESCRIPTOR_HEAP_DESC heap_desc;
+    D3D12_CPU_DESCRIPTOR_HANDLE handle;
+    unsigned int increment, i;
+    ID3D12Resource *buffer;
+    ID3D12Device *device;
+    HANDLE threads[4];
+    DWORD start_time;
+    ULONG refcount;
+    HRESULT hr;
+
+    if (!(device = create_device()))
+    {
+        skip("Failed to create device.\n");
+        return;
+    }
+
+    buffer = create_buffer(device, D3D12_HEAP_TYPE_UPLOAD, descriptor_count * 256,
+            D3D12_RESOURCE_FLAG_NONE, D3D12_RESOURCE_STATE_GENERIC_READ);
+
+    heap_desc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+    heap_desc.NumDescriptors = descriptor_count;
+    heap_desc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+    heap_desc.NodeMask = 0;
+    hr = ID3D12Device_CreateDescriptorHeap(device, &heap_desc, &IID_ID3D12DescriptorHeap, (void **)&cpu_heap);
+    ok(hr == S_OK, "Got unexpected hr %#lx.\n", hr);
+    heap_desc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+    hr = ID3D12Device_CreateDescriptorHeap(device, &heap_desc, &IID_ID3D12DescriptorHeap, (void **)&gpu_heap);
+    ok(hr == S_OK, "Got unexpected hr %#lx.\n", hr);
+
+    increment = ID3D12Device_GetDescriptorHandleIncrementSize(device, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+    handle = ID3D12DescriptorHeap_GetCPUDescriptorHandleForHeapStart(cpu_heap);
+    for (i = 0; i < descriptor_count; ++i)
+    {
+        cbv_desc.BufferLocation = ID3D12Resource_GetGPUVirtualAddress(buffer) + i * 256;
+        cbv_desc.SizeInBytes = 256;
+        ID3D12Device_CreateConstantBufferView(device, &cbv_desc, handle);
+        handle.ptr += increment;
+    }
+
+    /* Each thread copies to its own part of the shader visible heap. */
+    start_time = GetTickCount();
+    for (i = 0; i < thread_count; ++i)
+    {
+        thread_data[i].device = device;
+        thread_data[i].count = descriptor_count / thread_count;
+        thread_data[i].increment = increment;
+        thread_data[i].iterations = iterations;
+        thread_data[i].src = ID3D12DescriptorHeap_GetCPUDescriptorHandleForHeapStart(cpu_heap);
+        thread_data[i].src.ptr += i * thread_data[i].count * increment;
+        thread_data[i].dst = ID3D12DescriptorHeap_GetCPUDescriptorHandleForHeapStart(gpu_heap);
+        thread_data[i].dst.ptr += i * thread_data[i].count * increment;
+        threads[i] = CreateThread(NULL, 0, copy_descriptors_thread, &thread_data[i], 0, NULL);
+        ok(!!threads[i], "Failed to create thread, error %lu.\n", GetLastError());
+    }
+    for (i = 0; i < thread_count; ++i)
+    {
+        ok(WaitForSingleObject(threads[i], 30000) == WAIT_OBJECT_0, "Thread %u didn't finish.\n", i);
+        CloseHandle(threads[i]);
+    }
+    if (winetest_debug > 1)
+        trace("Copied %u descriptors on %u threads in %lu ms.\n", descriptor_count * iterations,
+                thread_count, GetTickCount() - start_time);
+
+    ID3D12DescriptorHeap_Release(gpu_heap);
+    ID3D12DescriptorHeap_Release(cpu_heap);
+    ID3D12Resource_Release(buffer);
+    refcount = ID3D12Device_Release(device);
+    ok(!refcount, "Device has %lu references left.\n", refcount);
+}
+
 START_TEST(d3d12)
 {
     BOOL enable_debug_layer = FALSE;
@@ -1533,4 +1962,8 @@ START_TEST(d3d12)
     test_swapchain_backbuffer_index();
     test_desktop_window();
     test_invalid_command_queue_types();
+    test_cached_pso();
+    test_pipeline_library();
+    test_committed_resource_zeroed();
+    test_copy_descriptors_throughput();
 }
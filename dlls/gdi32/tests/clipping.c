@@ -559,6 +559,167 @@ static void test_CreatePolyPolygonRgn(void)
     DeleteObject(region);
 }
 
+static HRGN create_checkerboard_rgn( int count, int size )
+{
+    HRGN rgn = CreateRectRgn( 0, 0, 0, 0 ), tmp;
+    int x, y;
+
+    for (y = 0; y < count; y++)
+    {
+        for (x = y % 2; x < count; x += 2)
+        {
+            tmp = CreateRectRgn( x * size, y * size, (x + 1) * size, (y + 1) * size );
+            CombineRgn( rgn, rgn, tmp, RGN_OR );
+            DeleteObject( tmp );
+        }
+    }
+    return rgn;
+}
+
+static void test_RectInRegion(void)
+{
+    HRGN rgn, rect_rgn, tmp;
+    RECT rect;
+    int x, y, w, h, ret;
+    BOOL expect;
+
+    rgn = create_checkerboard_rgn( 16, 10 );
+    rect_rgn = CreateRectRgn( 0, 0, 0, 0 );
+    tmp = CreateRectRgn( 0, 0, 0, 0 );
+
+    for (y = -5; y < 170; y += 7)
+    {
+        for (x = -5; x < 170; x += 7)
+        {
+            for (h = 1; h < 30; h += 9)
+            {
+                for (w = 1; w < 30; w += 9)
+                {
+                    SetRect( &rect, x, y, x + w, y + h );
+                    SetRectRgn( rect_rgn, rect.left, rect.top, rect.right, rect.bottom );
+                    expect = CombineRgn( tmp, rgn, rect_rgn, RGN_AND ) != NULLREGION;
+                    ret = RectInRegion( rgn, &rect );
+                    ok( ret == expect, "%s: got %d, expected %d\n", wine_dbgstr_rect(&rect), ret, expect );
+
+                    /* the rectangle is normalized */
+                    SetRect( &rect, x + w, y + h, x, y );
+                    ret = RectInRegion( rgn, &rect );
+                    ok( ret == expect, "%s: got %d, expected %d\n", wine_dbgstr_rect(&rect), ret, expect );
+                }
+            }
+        }
+    }
+
+    /* rectangle spanning many bands, only overlapping the last one */
+    SetRectRgn( rgn, 0, 0, 10, 10 );
+    for (y = 1; y < 20; y++)
+    {
+        SetRectRgn( rect_rgn, 0, y * 10, 10, y * 10 + 5 );
+        CombineRgn( rgn, rgn, rect_rgn, RGN_OR );
+    }
+    SetRectRgn( rect_rgn, 500, 195, 510, 200 );
+    CombineRgn( rgn, rgn, rect_rgn, RGN_OR );
+    SetRect( &rect, 20, 0, 505, 196 );
+    ok( RectInRegion( rgn, &rect ), "%s: not in region\n", wine_dbgstr_rect(&rect) );
+    SetRect( &rect, 20, 0, 500, 196 );
+    ok( !RectInRegion( rgn, &rect ), "%s: in region\n", wine_dbgstr_rect(&rect) );
+    SetRect( &rect, 20, 0, 505, 195 );
+    ok( !RectInRegion( rgn, &rect ), "%s: in region\n", wine_dbgstr_rect(&rect) );
+
+    DeleteObject( tmp );
+    DeleteObject( rect_rgn );
+    DeleteObject( rgn );
+}
+
+static void test_CombineRgn_dest(void)
+{
+    HRGN big, small, dst, tmp;
+    RGNDATA *data;
+    DWORD size;
+    int ret, i;
+
+    big = create_checkerboard_rgn( 32, 4 );
+    small = CreateRectRgn( 0, 0, 100, 100 );
+    dst = CreateRectRgn( 0, 0, 0, 0 );
+
+    for (i = 0; i < 3; i++)
+    {
+        /* combine into a destination that isn't one of the sources */
+        ret = CombineRgn( dst, big, small, RGN_AND );
+        ok( ret == COMPLEXREGION, "%d: got %d\n", i, ret );
+        size = GetRegionData( dst, 0, NULL );
+        data = malloc( size );
+        GetRegionData( dst, size, data );
+        ok( data->rdh.nCount == 313, "%d: got %lu rectangles\n", i, data->rdh.nCount );
+        free( data );
+
+        ret = CombineRgn( dst, small, small, RGN_OR );
+        ok( ret == SIMPLEREGION, "%d: got %d\n", i, ret );
+        size = GetRegionData( dst, 0, NULL );
+        data = malloc( size );
+        GetRegionData( dst, size, data );
+        ok( data->rdh.nCount == 1, "%d: got %lu rectangles\n", i, data->rdh.nCount );
+        ok( EqualRect( (RECT *)data->Buffer, &data->rdh.rcBound ), "%d: wrong rect %s\n", i,
+            wine_dbgstr_rect( (RECT *)data->Buffer ));
+        free( data );
+        ok( EqualRgn( dst, small ), "%d: regions differ\n", i );
+    }
+
+    tmp = CreateRectRgn( 0, 0, 0, 0 );
+    ret = CombineRgn( tmp, big, small, RGN_AND );
+    ok( ret == COMPLEXREGION, "got %d\n", ret );
+    ret = CombineRgn( dst, big, small, RGN_DIFF );
+    ok( ret == COMPLEXREGION, "got %d\n", ret );
+    ret = CombineRgn( dst, dst, big, RGN_XOR );
+    ok( ret == COMPLEXREGION, "got %d\n", ret );
+    ok( EqualRgn( dst, tmp ), "regions differ\n" );
+
+    DeleteObject( tmp );
+    DeleteObject( dst );
+    DeleteObject( small );
+    DeleteObject( big );
+}
+
+static void test_clipped_fill(void)
+{
+    BITMAPINFO info = {{ sizeof(info.bmiHeader), 64, -64, 1, 32, BI_RGB }};
+    HBITMAP bitmap, old_bitmap;
+    HRGN rgn;
+    DWORD *bits;
+    int x, y, ret;
+    BOOL inside;
+    HDC hdc;
+
+    hdc = CreateCompatibleDC( 0 );
+    bitmap = CreateDIBSection( hdc, &info, DIB_RGB_COLORS, (void **)&bits, NULL, 0 );
+    ok( bitmap != NULL, "CreateDIBSection failed\n" );
+    old_bitmap = SelectObject( hdc, bitmap );
+
+    /* fill a rectangle crossing many bands of a complex clip region */
+    rgn = create_checkerboard_rgn( 16, 4 );
+    ret = SelectClipRgn( hdc, rgn );
+    ok( ret == COMPLEXREGION, "got %d\n", ret );
+    ret = PatBlt( hdc, 10, 3, 37, 50, WHITENESS );
+    ok( ret, "PatBlt failed\n" );
+    GdiFlush();
+
+    for (y = 0; y < 64; y++)
+    {
+        for (x = 0; x < 64; x++)
+        {
+            inside = x >= 10 && x < 47 && y >= 3 && y < 53 && PtInRegion( rgn, x, y );
+            if (bits[y * 64 + x] != (inside ? 0xffffff : 0)) break;
+        }
+        if (x < 64) break;
+    }
+    ok( y == 64, "wrong pixel %08lx at %d,%d\n", y < 64 ? bits[y * 64 + x] : 0, x, y );
+
+    SelectObject( hdc, old_bitmap );
+    DeleteObject( rgn );
+    DeleteObject( bitmap );
+    DeleteDC( hdc );
+}
+
 START_TEST(clipping)
 {
     test_GetRandomRgn();
@@ -567,4 +728,7 @@ START_TEST(clipping)
     test_memory_dc_clipping();
     test_window_dc_clipping();
     test_CreatePolyPolygonRgn();
+    test_RectInRegion();
+    test_CombineRgn_dest();
+    test_clipped_fill();
 }
@@ -2140,6 +2140,87 @@ static void test_write_watch(void)
     VirtualFree( base, 0, MEM_RELEASE );
 }
 
+static void test_write_watch_many_pages(void)
+{
+    static void *results[256];
+    ULONG_PTR count;
+    ULONG i, pagesize;
+    SIZE_T size;
+    char *base;
+    UINT ret;
+
+    if (!pGetWriteWatch || !pResetWriteWatch)
+    {
+        win_skip( "GetWriteWatch not supported\n" );
+        return;
+    }
+
+    size = 512 * 0x1000;
+    base = VirtualAlloc( 0, size, MEM_RESERVE | MEM_COMMIT | MEM_WRITE_WATCH, PAGE_READWRITE );
+    if (!base &&
+        (GetLastError() == ERROR_INVALID_PARAMETER || GetLastError() == ERROR_NOT_SUPPORTED))
+    {
+        win_skip( "MEM_WRITE_WATCH not supported\n" );
+        return;
+    }
+    ok( base != NULL, "VirtualAlloc failed %lu\n", GetLastError() );
+
+    count = ARRAY_SIZE(results);
+    ret = pGetWriteWatch( 0, base, size, results, &count, &pagesize );
+    ok( !ret, "GetWriteWatch failed %lu\n", GetLastError() );
+    ok( count == 0, "wrong count %Iu\n", count );
+
+    /* every other page, so that each written page is a separate range */
+    for (i = 0; i < 512; i += 2) base[i * pagesize] = 1;
+
+    count = ARRAY_SIZE(results);
+    ret = pGetWriteWatch( 0, base, size, results, &count, &pagesize );
+    ok( !ret, "GetWriteWatch failed %lu\n", GetLastError() );
+    ok( count == 256, "wrong count %Iu\n", count );
+    for (i = 0; i < count; i++)
+        if (results[i] != base + 2 * i * pagesize) break;
+    ok( i == count, "wrong result %p at %lu\n", i < count ? results[i] : NULL, i );
+
+    /* results are truncated to the buffer size, and only the returned pages are reset */
+    count = 100;
+    ret = pGetWriteWatch( WRITE_WATCH_FLAG_RESET, base, size, results, &count, &pagesize );
+    ok( !ret, "GetWriteWatch failed %lu\n", GetLastError() );
+    ok( count == 100, "wrong count %Iu\n", count );
+    ok( results[0] == base, "wrong result %p\n", results[0] );
+    ok( results[99] == base + 198 * pagesize, "wrong result %p\n", results[99] );
+
+    count = ARRAY_SIZE(results);
+    ret = pGetWriteWatch( 0, base, size, results, &count, &pagesize );
+    ok( !ret, "GetWriteWatch failed %lu\n", GetLastError() );
+    ok( count == 156, "wrong count %Iu\n", count );
+    ok( results[0] == base + 200 * pagesize, "wrong result %p\n", results[0] );
+
+    /* contiguous written pages are reported one by one */
+    for (i = 0; i < 512; i++) base[i * pagesize + 5] = 2;
+
+    count = ARRAY_SIZE(results);
+    ret = pGetWriteWatch( WRITE_WATCH_FLAG_RESET, base, size, results, &count, &pagesize );
+    ok( !ret, "GetWriteWatch failed %lu\n", GetLastError() );
+    ok( count == 256, "wrong count %Iu\n", count );
+    ok( results[255] == base + 255 * pagesize, "wrong result %p\n", results[255] );
+
+    count = ARRAY_SIZE(results);
+    ret = pGetWriteWatch( 0, base, size, results, &count, &pagesize );
+    ok( !ret, "GetWriteWatch failed %lu\n", GetLastError() );
+    ok( count == 256, "wrong count %Iu\n", count );
+    ok( results[0] == base + 256 * pagesize, "wrong result %p\n", results[0] );
+
+    ret = pResetWriteWatch( base, size );
+    ok( !ret, "ResetWriteWatch failed %lu\n", GetLastError() );
+
+    count = ARRAY_SIZE(results);
+    ret = pGetWriteWatch( 0, base, size, results, &count, &pagesize );
+    ok( !ret, "GetWriteWatch failed %lu\n", GetLastError() );
+    ok( count == 0, "wrong count %Iu\n", count );
+
+    VirtualFree( base, 0, MEM_RELEASE );
+}
+
 #if defined(__i386__) || defined(__x86_64__)
 
 static DWORD WINAPI stack_commit_func( void *arg )
@@ -4340,6 +4421,7 @@ START_TEST(virtual)
     test_IsBadWritePtr();
     test_IsBadCodePtr();
     test_write_watch();
+    test_write_watch_many_pages();
     test_PrefetchVirtualMemory();
 #if defined(__i386__) || defined(__x86_64__)
     test_stack_commit();
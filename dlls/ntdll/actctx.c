@@ -3236,6 +3236,133 @@ static WCHAR *lookup_manifest_file( HANDLE dir, struct assembly_identity *ai )
     return ret;
 }
 
+/* cache of winsxs manifest lookups, flushed whenever the manifests directory is modified */
+struct winsxs_lookup
+{
+    struct assembly_version version;  /* minimum version requested */
+    struct assembly_version found;    /* version of the returned manifest */
+    WCHAR                  *pattern;  /* file name pattern looked up */
+    WCHAR                  *file;     /* resulting file name, NULL if not found */
+};
+
+static struct winsxs_lookup *winsxs_cache;
+static unsigned int winsxs_cache_count;
+static unsigned int winsxs_cache_size;
+static LARGE_INTEGER winsxs_cache_write_time;
+static LARGE_INTEGER winsxs_cache_change_time;
+
+static RTL_CRITICAL_SECTION winsxs_cache_section;
+static RTL_CRITICAL_SECTION_DEBUG winsxs_cache_critsect_debug =
+{
+    0, 0, &winsxs_cache_section,
+    { &winsxs_cache_critsect_debug.ProcessLocksList, &winsxs_cache_critsect_debug.ProcessLocksList },
+      0, 0, { (DWORD_PTR)(__FILE__ ": winsxs_cache_section") }
+};
+static RTL_CRITICAL_SECTION winsxs_cache_section = { &winsxs_cache_critsect_debug, -1, 0, 0, 0, 0 };
+
+static WCHAR *build_winsxs_pattern( const struct assembly_identity *ai )
+{
+    const WCHAR *lang = ai->language;
+    WCHAR *ret;
+    unsigned int len;
+
+    if (!lang || !wcsicmp( lang, L"neutral" )) lang = L"*";
+
+    len = wcslen(ai->arch) + wcslen(ai->name) + wcslen(ai->public_key) + wcslen(lang) + 40;
+    if (!(ret = RtlAllocateHeap( GetProcessHeap(), 0, len * sizeof(WCHAR) ))) return NULL;
+    swprintf( ret, len, L"%s_%s_%s_%u.%u_%s", ai->arch, ai->name, ai->public_key,
+              ai->version.major, ai->version.minor, lang );
+    return ret;
+}
+
+static void flush_winsxs_cache(void)
+{
+    unsigned int i;
+
+    for (i = 0; i < winsxs_cache_count; i++)
+    {
+        RtlFreeHeap( GetProcessHeap(), 0, winsxs_cache[i].pattern );
+        RtlFreeHeap( GetProcessHeap(), 0, winsxs_cache[i].file );
+    }
+    winsxs_cache_count = 0;
+}
+
+static void add_winsxs_cache_entry( WCHAR *pattern, const struct assembly_version *version,
+                                    const struct assembly_identity *ai, const WCHAR *file )
+{
+    struct winsxs_lookup *entry;
+
+    if (winsxs_cache_count == winsxs_cache_size)
+    {
+        unsigned int new_size = max( 16, winsxs_cache_size * 2 );
+        void *ptr;
+
+        if (winsxs_cache)
+            ptr = RtlReAllocateHeap( GetProcessHeap(), 0, winsxs_cache, new_size * sizeof(*winsxs_cache) );
+        else
+            ptr = RtlAllocateHeap( GetProcessHeap(), 0, new_size * sizeof(*winsxs_cache) );
+        if (!ptr) goto failed;
+        winsxs_cache = ptr;
+        winsxs_cache_size = new_size;
+    }
+    entry = &winsxs_cache[winsxs_cache_count];
+    entry->version = *version;
+    entry->found   = ai->version;
+    entry->pattern = pattern;
+    entry->file    = NULL;
+    if (file && !(entry->file = strdupW( file ))) goto failed;
+    winsxs_cache_count++;
+    return;
+
+failed:
+    RtlFreeHeap( GetProcessHeap(), 0, pattern );
+}
+
+/* same as lookup_manifest_file, but avoids rescanning the directory if it didn't change */
+static WCHAR *lookup_manifest_file_cached( HANDLE dir, struct assembly_identity *ai )
+{
+    struct assembly_version version = ai->version;
+    FILE_BASIC_INFORMATION info;
+    IO_STATUS_BLOCK io;
+    WCHAR *pattern, *ret = NULL;
+    unsigned int i;
+
+    if (NtQueryInformationFile( dir, &io, &info, sizeof(info), FileBasicInformation ))
+        return lookup_manifest_file( dir, ai );
+    if (!(pattern = build_winsxs_pattern( ai ))) return NULL;
+
+    RtlEnterCriticalSection( &winsxs_cache_section );
+
+    if (info.LastWriteTime.QuadPart != winsxs_cache_write_time.QuadPart ||
+        info.ChangeTime.QuadPart != winsxs_cache_change_time.QuadPart)
+    {
+        TRACE( "winsxs directory changed, flushing %u entries\n", winsxs_cache_count );
+        flush_winsxs_cache();
+        winsxs_cache_write_time = info.LastWriteTime;
+        winsxs_cache_change_time = info.ChangeTime;
+    }
+
+    for (i = 0; i < winsxs_cache_count; i++)
+    {
+        struct winsxs_lookup *entry = &winsxs_cache[i];
+
+        if (entry->version.build != version.build || entry->version.revision != version.revision) continue;
+        if (wcsicmp( entry->pattern, pattern )) continue;
+
+        TRACE( "found cached lookup %s -> %s\n", debugstr_w(pattern), debugstr_w(entry->file) );
+        if (entry->file && (ret = strdupW( entry->file ))) ai->version = entry->found;
+        RtlFreeHeap( GetProcessHeap(), 0, pattern );
+        RtlLeaveCriticalSection( &winsxs_cache_section );
+        return ret;
+    }
+
+    ret = lookup_manifest_file( dir, ai );
+    add_winsxs_cache_entry( pattern, &version, ai, ret );
+
+    RtlLeaveCriticalSection( &winsxs_cache_section );
+    return ret;
+}
+
 static NTSTATUS lookup_winsxs(struct actctx_loader* acl, struct assembly_identity* ai)
 {
     struct assembly_identity    sxs_ai;
@@ -3272,7 +3399,7 @@ static NTSTATUS lookup_winsxs(struct actctx_loader* acl, struct assembly_identit
                      FILE_DIRECTORY_FILE | FILE_SYNCHRONOUS_IO_NONALERT ))
     {
         sxs_ai = *ai;
-        file = lookup_manifest_file( handle, &sxs_ai );
+        file = lookup_manifest_file_cached( handle, &sxs_ai );
         NtClose( handle );
     }
     if (!file)
@@ -382,7 +382,8 @@ LONGLONG WINAPI RtlGetSystemTimePrecise( void )
  */
 BOOL WINAPI DECLSPEC_HOTPATCH RtlQueryPerformanceCounter( LARGE_INTEGER *counter )
 {
-    NtQueryPerformanceCounter( counter, NULL );
+    /* a unix call is cheaper than a full syscall */
+    WINE_UNIX_CALL( unix_query_performance_counter, counter );
     return TRUE;
 }
 
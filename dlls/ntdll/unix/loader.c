@@ -138,11 +138,24 @@ static BYTE syscall_args[ARRAY_SIZE(syscalls)] =
 #undef SYSCALL_ENTRY
 };
 
+static const char * const syscall_names[ARRAY_SIZE(syscalls)] =
+{
+#define SYSCALL_ENTRY(id,name,args) #name,
+#ifdef _WIN64
+    ALL_SYSCALLS64
+#else
+    ALL_SYSCALLS32
+#endif
+#undef SYSCALL_ENTRY
+};
+
 SYSTEM_SERVICE_TABLE KeServiceDescriptorTable[4] =
 {
     { (ULONG_PTR *)syscalls, NULL, ARRAY_SIZE(syscalls), syscall_args }
 };
 
+static BOOL syscall_profiling;
+
 #ifdef __GNUC__
 static void fatal_error( const char *err, ... ) __attribute__((noreturn, format(printf,1,2)));
 #endif
@@ -633,6 +646,7 @@ BOOLEAN KeAddSystemServiceTable( ULONG_PTR *funcs, ULONG_PTR *counters, ULONG li
                                  BYTE *arguments, ULONG index )
 {
     if (index >= ARRAY_SIZE(KeServiceDescriptorTable)) return FALSE;
+    if (!counters && syscall_profiling) counters = calloc( 2 * limit, sizeof(*counters) );
     KeServiceDescriptorTable[index].ServiceTable  = funcs;
     KeServiceDescriptorTable[index].CounterTable  = counters;
     KeServiceDescriptorTable[index].ServiceLimit  = limit;
@@ -641,6 +655,85 @@ BOOLEAN KeAddSystemServiceTable( ULONG_PTR *funcs, ULONG_PTR *counters, ULONG li
 }
 
 
+/***********************************************************************
+ *           init_syscall_profiling
+ *
+ * Enable the syscall counters if WINESYSCALLPROFILE is set. The dispatcher
+ * stores a pair of call count and cumulative cycles for each syscall.
+ */
+static void init_syscall_profiling(void)
+{
+#ifdef __x86_64__  /* only supported by the x86_64 dispatcher for now */
+    const char *env = getenv( "WINESYSCALLPROFILE" );
+
+    if (!env || !atoi( env )) return;
+    if (!(KeServiceDescriptorTable[0].CounterTable = calloc( 2 * ARRAY_SIZE(syscalls), sizeof(ULONG_PTR) )))
+        return;
+    syscall_profiling = TRUE;
+#endif
+}
+
+
+struct syscall_profile
+{
+    ULONG      id;
+    ULONG_PTR  calls;
+    ULONG_PTR  cycles;
+};
+
+static int compare_syscall_profile( const void *p1, const void *p2 )
+{
+    const struct syscall_profile *prof1 = p1, *prof2 = p2;
+
+    if (prof1->cycles != prof2->cycles) return prof1->cycles < prof2->cycles ? 1 : -1;
+    return prof1->id - prof2->id;
+}
+
+/***********************************************************************
+ *           dump_syscall_profile
+ *
+ * Print the syscall counters, most expensive first.
+ */
+void dump_syscall_profile(void)
+{
+    struct syscall_profile *profile;
+    unsigned int i, j, count = 0, total = 0;
+
+    if (!syscall_profiling) return;
+
+    for (i = 0; i < ARRAY_SIZE(KeServiceDescriptorTable); i++)
+        if (KeServiceDescriptorTable[i].CounterTable) total += KeServiceDescriptorTable[i].ServiceLimit;
+    if (!(profile = malloc( total * sizeof(*profile) ))) return;
+
+    for (i = 0; i < ARRAY_SIZE(KeServiceDescriptorTable); i++)
+    {
+        const ULONG_PTR *counters = KeServiceDescriptorTable[i].CounterTable;
+
+        if (!counters) continue;
+        for (j = 0; j < KeServiceDescriptorTable[i].ServiceLimit; j++)
+        {
+            if (!counters[2 * j]) continue;
+            profile[count].id     = (i << 12) | j;
+            profile[count].calls  = counters[2 * j];
+            profile[count].cycles = counters[2 * j + 1];
+            count++;
+        }
+    }
+    qsort( profile, count, sizeof(*profile), compare_syscall_profile );
+
+    MESSAGE( "syscall profile for process %04x:\n", (int)GetCurrentProcessId() );
+    MESSAGE( "  %-4s %-40s %12s %16s %10s\n", "id", "name", "calls", "cycles", "avg" );
+    for (i = 0; i < count; i++)
+    {
+        const char *name = profile[i].id < ARRAY_SIZE(syscall_names) ? syscall_names[profile[i].id] : "";
+
+        MESSAGE( "  %04x %-40s %12lu %16lu %10lu\n", (int)profile[i].id, name, (unsigned long)profile[i].calls,
+                 (unsigned long)profile[i].cycles, (unsigned long)(profile[i].cycles / profile[i].calls) );
+    }
+    free( profile );
+}
+
+
 /*************************************************************************
  *		map_so_dll
  *
@@ -984,6 +1077,7 @@ static const unixlib_entry_t unix_call_funcs[] =
     unixcall_wine_server_handle_to_fd,
     unixcall_wine_spawnvp,
     system_time_precise,
+    query_performance_counter,
 };
 
 
@@ -1002,6 +1096,7 @@ const unixlib_entry_t unix_call_wow64_funcs[] =
     wow64_wine_server_handle_to_fd,
     wow64_wine_spawnvp,
     system_time_precise,
+    query_performance_counter,
 };
 
 #endif  /* _WIN64 */
@@ -1805,6 +1900,7 @@ static void start_main_thread(void)
 {
     TEB *teb = virtual_alloc_first_teb();
 
+    init_syscall_profiling();
     signal_init_threading();
     signal_alloc_thread( teb );
     dbg_init();
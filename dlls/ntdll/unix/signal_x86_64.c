@@ -421,11 +421,12 @@ struct syscall_frame
     void                 *syscall_cfa;   /* 00a8 */
     DWORD                 syscall_flags; /* 00b0 */
     DWORD                 restore_flags; /* 00b4 */
-    DWORD                 align[2];      /* 00b8 */
+    ULONG64               syscall_start; /* 00b8 timestamp for syscall profiling */
     XMM_SAVE_AREA32       xsave;         /* 00c0 */
     DECLSPEC_ALIGN(64) XSAVE_AREA_HEADER xstate;    /* 02c0 */
 };
 
+C_ASSERT( offsetof( struct syscall_frame, syscall_start ) == 0xb8 );
 C_ASSERT( offsetof( struct syscall_frame, xsave ) == 0xc0 );
 C_ASSERT( offsetof( struct syscall_frame, xstate ) == 0x2c0 );
 C_ASSERT( sizeof( struct syscall_frame ) == 0x300);
@@ -1541,7 +1542,10 @@ NTSTATUS call_user_exception_dispatcher( EXCEPTION_RECORD *rec, CONTEXT *context
         XSAVE_AREA_HEADER *dst_xs = (XSAVE_AREA_HEADER *)(stack + 1);
         assert( !((ULONG_PTR)dst_xs & 63) );
         context_init_xstate( &stack->context, dst_xs );
-        memcpy( dst_xs, &frame->xstate, sizeof(XSAVE_AREA_HEADER) + xstate_features_size );
+        memcpy( dst_xs, &frame->xstate, sizeof(XSAVE_AREA_HEADER) );
+        /* the extended components are only valid if they are not in their initial state */
+        if (frame->xstate.Mask & xstate_extended_features())
+            memcpy( dst_xs + 1, &frame->xstate + 1, xstate_features_size );
     }
     else context_init_xstate( &stack->context, NULL );
 
@@ -2754,7 +2758,10 @@ __ASM_GLOBAL_FUNC( __wine_syscall_dispatcher,
                    "movq %r15,%rsi\n\t"
                    "cld\n\t"
                    "rep; movsq\n"
-                   "1:\tmovq %r10,%rdi\n\t"        /* 1st argument */
+                   "1:\tmovq 8(%rbx),%r15\n\t"      /* table->CounterTable */
+                   "testq %r15,%r15\n\t"
+                   "jnz 6f\n"
+                   "8:\tmovq %r10,%rdi\n\t"        /* 1st argument */
                    "movq %r11,%rsi\n\t"            /* 2nd argument */
                    "movq %r8,%rdx\n\t"             /* 3rd argument */
                    "movq %r9,%rcx\n\t"             /* 4th argument */
@@ -2762,7 +2769,9 @@ __ASM_GLOBAL_FUNC( __wine_syscall_dispatcher,
                    "movq %r13,%r9\n\t"             /* 6th argument */
                    "movq (%rbx),%r10\n\t"          /* table->ServiceTable */
                    "callq *(%r10,%rax,8)\n\t"
-                   "leaq -0x98(%rbp),%rcx\n\t"
+                   "testq %r15,%r15\n\t"
+                   "jnz 7f\n"
+                   "9:\tleaq -0x98(%rbp),%rcx\n\t"
                    __ASM_LOCAL_LABEL("__wine_syscall_dispatcher_return") ":\n\t"
                    "movl 0xb4(%rcx),%edx\n\t"      /* frame->restore_flags */
                    "testl $0x48,%edx\n\t"          /* CONTEXT_FLOATING_POINT | CONTEXT_XSTATE */
@@ -2860,6 +2869,25 @@ __ASM_GLOBAL_FUNC( __wine_syscall_dispatcher,
                    "5:\tmovl $0xc000000d,%eax\n\t" /* STATUS_INVALID_PARAMETER */
                    "movq %rsp,%rcx\n\t"
                    "jmp " __ASM_LOCAL_LABEL("__wine_syscall_dispatcher_return") "\n\t"
+                   /* syscall profiling, counters are pairs of call count and cycles */
+                   "6:\tmovq %rax,%rcx\n\t"
+                   "shlq $4,%rcx\n\t"
+                   "addq %rcx,%r15\n\t"
+                   "lock incq (%r15)\n\t"
+                   "movq %rax,%rcx\n\t"
+                   "rdtsc\n\t"
+                   "movl %eax,0x20(%rbp)\n\t"     /* frame->syscall_start */
+                   "movl %edx,0x24(%rbp)\n\t"
+                   "movq %rcx,%rax\n\t"
+                   "jmp 8b\n"
+                   "7:\tmovq %rax,%rcx\n\t"
+                   "rdtsc\n\t"
+                   "shlq $32,%rdx\n\t"
+                   "orq %rdx,%rax\n\t"
+                   "subq 0x20(%rbp),%rax\n\t"     /* frame->syscall_start */
+                   "lock addq %rax,8(%r15)\n\t"
+                   "movq %rcx,%rax\n\t"
+                   "jmp 9b\n\t"
                    ".globl " __ASM_NAME("__wine_syscall_dispatcher_return") "\n"
                    __ASM_NAME("__wine_syscall_dispatcher_return") ":\n\t"
                    "movq %rdi,%rcx\n\t"
@@ -1691,6 +1691,16 @@ NTSTATUS system_time_precise( void *args )
 }
 
 
+/* unix call helper for RtlQueryPerformanceCounter */
+NTSTATUS query_performance_counter( void *args )
+{
+    LARGE_INTEGER *counter = args;
+
+    counter->QuadPart = monotonic_counter();
+    return STATUS_SUCCESS;
+}
+
+
 /******************************************************************************
  *              NtCreateKeyedEvent (NTDLL.@)
  */
@@ -1449,6 +1449,7 @@ static DECLSPEC_NORETURN void exit_thread( int status )
 void exit_process( int status )
 {
     pthread_sigmask( SIG_BLOCK, &server_block_set, NULL );
+    dump_syscall_profile();
     process_exit_wrapper( get_unix_exit_code( status ));
 }
 
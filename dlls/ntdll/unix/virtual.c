@@ -54,6 +54,11 @@
 #ifdef HAVE_LIBPROCSTAT_H
 # include <libprocstat.h>
 #endif
+#ifdef HAVE_LINUX_USERFAULTFD_H
+# include <linux/userfaultfd.h>
+# include <sys/ioctl.h>
+# include <sys/syscall.h>
+#endif
 #include <unistd.h>
 #include <dlfcn.h>
 #ifdef HAVE_VALGRIND_VALGRIND_H
@@ -127,6 +132,7 @@ struct file_view
 #define VPROT_SYSTEM           0x0200  /* system view (underlying mmap not under our control) */
 #define VPROT_PLACEHOLDER      0x0400
 #define VPROT_FREE_PLACEHOLDER 0x0800
+#define VPROT_KERNEL_WRITEWATCH 0x1000 /* write watches are tracked by the kernel */
 
 /* Conversion from VPROT_* to Win32 flags */
 static const BYTE VIRTUAL_Win32Flags[16] =
@@ -152,6 +158,11 @@ static const BYTE VIRTUAL_Win32Flags[16] =
 static struct wine_rb_tree views_tree;
 static pthread_mutex_t virtual_mutex;
 
+/* sequence counter for lockless readers of the views tree and page protections,
+ * odd while they are being modified (with virtual_mutex held) */
+static LONG views_seq;
+static unsigned int views_write_depth;
+
 static const UINT page_shift = 12;
 static const UINT_PTR page_mask = 0xfff;
 static const UINT_PTR granularity_mask = 0xffff;
@@ -195,6 +206,60 @@ static struct list teb_list = LIST_INIT( teb_list );
 #define MAP_NORESERVE 0
 #endif
 
+#if defined(HAVE_LINUX_USERFAULTFD_H) && defined(__NR_userfaultfd)
+
+/* definitions from recent kernel headers, in case we are built against older ones */
+#ifndef UFFD_USER_MODE_ONLY
+#define UFFD_USER_MODE_ONLY 1
+#endif
+#ifndef UFFD_FEATURE_WP_UNPOPULATED
+#define UFFD_FEATURE_WP_UNPOPULATED (1 << 13)
+#endif
+#ifndef UFFD_FEATURE_WP_ASYNC
+#define UFFD_FEATURE_WP_ASYNC (1 << 15)
+#endif
+
+#ifndef PAGEMAP_SCAN
+#define PAGE_IS_WPALLOWED (1 << 0)
+#define PAGE_IS_WRITTEN   (1 << 1)
+
+struct page_region
+{
+    UINT64 start;
+    UINT64 end;
+    UINT64 categories;
+};
+
+#define PM_SCAN_WP_MATCHING   (1 << 0)
+#define PM_SCAN_CHECK_WPASYNC (1 << 1)
+
+struct pm_scan_arg
+{
+    UINT64 size;
+    UINT64 flags;
+    UINT64 start;
+    UINT64 end;
+    UINT64 walk_end;
+    UINT64 vec;
+    UINT64 vec_len;
+    UINT64 max_pages;
+    UINT64 category_inverted;
+    UINT64 category_mask;
+    UINT64 category_anyof_mask;
+    UINT64 return_mask;
+};
+
+#define PAGEMAP_SCAN _IOWR('f', 16, struct pm_scan_arg)
+#endif
+
+#define HAVE_KERNEL_WRITEWATCH
+static int uffd_fd = -1;
+static int pagemap_scan_fd = -1;
+#endif
+
+/* write watches can be tracked by the kernel instead of through page protections */
+static BOOL use_kernel_writewatch;
+
 #ifdef _WIN64  /* on 64-bit the page protection bytes use a 2-level table */
 static const size_t pages_vprot_shift = 20;
 static const size_t pages_vprot_mask = (1 << 20) - 1;
@@ -868,6 +933,28 @@ static inline int is_view_valloc( const struct file_view *view )
     return !(view->protect & (SEC_FILE | SEC_RESERVE | SEC_COMMIT));
 }
 
+
+/***********************************************************************
+ *           views_write_begin
+ *
+ * Start modifying views or page protections. virtual_mutex must be held by caller.
+ */
+static void views_write_begin(void)
+{
+    if (!views_write_depth++) InterlockedIncrement( &views_seq );
+}
+
+
+/***********************************************************************
+ *           views_write_end
+ *
+ * Finish modifying views or page protections. virtual_mutex must be held by caller.
+ */
+static void views_write_end(void)
+{
+    if (!--views_write_depth) InterlockedIncrement( &views_seq );
+}
+
 /***********************************************************************
  *           get_page_vprot
  *
@@ -951,6 +1038,7 @@ static void set_page_vprot( const void *addr, size_t size, BYTE vprot )
     size_t idx = (size_t)addr >> page_shift;
     size_t end = ((size_t)addr + size + page_mask) >> page_shift;
 
+    views_write_begin();
 #ifdef _WIN64
     while (idx >> pages_vprot_shift != end >> pages_vprot_shift)
     {
@@ -962,6 +1050,7 @@ static void set_page_vprot( const void *addr, size_t size, BYTE vprot )
 #else
     memset( pages_vprot + idx, vprot, end - idx );
 #endif
+    views_write_end();
 }
 
 
@@ -975,6 +1064,7 @@ static void set_page_vprot_bits( const void *addr, size_t size, BYTE set, BYTE c
     size_t idx = (size_t)addr >> page_shift;
     size_t end = ((size_t)addr + size + page_mask) >> page_shift;
 
+    views_write_begin();
 #ifdef _WIN64
     for ( ; idx < end; idx++)
     {
@@ -984,6 +1074,7 @@ static void set_page_vprot_bits( const void *addr, size_t size, BYTE set, BYTE c
 #else
     for ( ; idx < end; idx++) pages_vprot[idx] = (pages_vprot[idx] & ~clear) | set;
 #endif
+    views_write_end();
 }
 
 
@@ -1215,6 +1306,16 @@ static inline BOOL is_write_watch_range( const void *addr, size_t size )
 }
 
 
+/***********************************************************************
+ *           is_kernel_write_watch_range
+ */
+static inline BOOL is_kernel_write_watch_range( const void *addr, size_t size )
+{
+    struct file_view *view = find_view( addr, size );
+    return view && (view->protect & VPROT_KERNEL_WRITEWATCH);
+}
+
+
 /***********************************************************************
  *           find_view_range
  *
@@ -1510,8 +1611,11 @@ static struct file_view *alloc_view(void)
  */
 static void free_view( struct file_view *view )
 {
+    views_write_begin();
+    view->size = 0;  /* lockless readers may still be looking at it */
     *(struct file_view **)view = next_free_view;
     next_free_view = view;
+    views_write_end();
 }
 
 
@@ -1522,11 +1626,171 @@ static void free_view( struct file_view *view )
  */
 static void unregister_view( struct file_view *view )
 {
+    views_write_begin();
     if (mmap_is_in_reserved_area( view->base, view->size ))
         free_ranges_remove_view( view );
     wine_rb_remove( &views_tree, &view->entry );
+    views_write_end();
+}
+
+
+#ifdef HAVE_KERNEL_WRITEWATCH
+
+/***********************************************************************
+ *           kernel_writewatch_init
+ *
+ * Check whether the kernel supports asynchronous userfaultfd write protection
+ * combined with PAGEMAP_SCAN, and use it for write watches if so.
+ */
+static void kernel_writewatch_init(void)
+{
+    struct uffdio_api uffdio_api;
+    struct pm_scan_arg arg = { sizeof(arg) };
+    const char *env = getenv( "WINE_DISABLE_KERNEL_WRITEWATCH" );
+
+    if (env && atoi( env )) return;
+
+    if ((uffd_fd = syscall( __NR_userfaultfd, O_CLOEXEC | O_NONBLOCK | UFFD_USER_MODE_ONLY )) == -1)
+    {
+        TRACE( "userfaultfd not available: %s\n", strerror(errno) );
+        return;
+    }
+    uffdio_api.api = UFFD_API;
+    uffdio_api.features = UFFD_FEATURE_WP_ASYNC | UFFD_FEATURE_WP_UNPOPULATED;
+    if (ioctl( uffd_fd, UFFDIO_API, &uffdio_api ) || uffdio_api.api != UFFD_API)
+    {
+        TRACE( "userfaultfd async write protection not supported\n" );
+        goto failed;
+    }
+    if ((pagemap_scan_fd = open( "/proc/self/pagemap", O_RDONLY | O_CLOEXEC )) == -1) goto failed;
+
+    /* an empty scan validates the ioctl and its argument layout */
+    if (ioctl( pagemap_scan_fd, PAGEMAP_SCAN, &arg ) < 0)
+    {
+        TRACE( "PAGEMAP_SCAN not supported: %s\n", strerror(errno) );
+        close( pagemap_scan_fd );
+        pagemap_scan_fd = -1;
+        goto failed;
+    }
+    TRACE( "using kernel write watch tracking\n" );
+    use_kernel_writewatch = TRUE;
+    return;
+
+failed:
+    close( uffd_fd );
+    uffd_fd = -1;
+}
+
+
+/***********************************************************************
+ *           kernel_writewatch_reset
+ *
+ * Write-protect a range so that the next write to each page gets tracked.
+ */
+static void kernel_writewatch_reset( void *base, size_t size )
+{
+    struct uffdio_writeprotect wp;
+
+    wp.range.start = (UINT_PTR)base;
+    wp.range.len   = size;
+    wp.mode        = UFFDIO_WRITEPROTECT_MODE_WP;
+    if (ioctl( uffd_fd, UFFDIO_WRITEPROTECT, &wp ))
+        ERR( "failed to write-protect %p-%p: %s\n", base, (char *)base + size, strerror(errno) );
+}
+
+
+/***********************************************************************
+ *           kernel_writewatch_register
+ *
+ * Start kernel write tracking on a newly mapped range.
+ */
+static BOOL kernel_writewatch_register( void *base, size_t size )
+{
+    struct uffdio_register reg;
+
+    /* write tracking is done at page granularity, avoid huge pages */
+    madvise( base, size, MADV_NOHUGEPAGE );
+
+    reg.range.start = (UINT_PTR)base;
+    reg.range.len   = size;
+    reg.mode        = UFFDIO_REGISTER_MODE_WP;
+    if (ioctl( uffd_fd, UFFDIO_REGISTER, &reg ))
+    {
+        WARN( "failed to register %p-%p, using page protections: %s\n",
+              base, (char *)base + size, strerror(errno) );
+        return FALSE;
+    }
+    kernel_writewatch_reset( base, size );
+    return TRUE;
+}
+
+
+/***********************************************************************
+ *           kernel_get_write_watches
+ *
+ * Retrieve the pages written since the last reset, optionally resetting them.
+ */
+static NTSTATUS kernel_get_write_watches( void *base, size_t size, void **addresses,
+                                          ULONG_PTR *count, BOOL reset )
+{
+    struct page_region regions[64];
+    struct pm_scan_arg arg = { sizeof(arg) };
+    char *addr = base, *end = addr + size;
+    ULONG_PTR pos = 0;
+    int i, ret;
+
+    arg.vec         = (UINT_PTR)regions;
+    arg.vec_len     = ARRAY_SIZE(regions);
+    arg.flags       = reset ? PM_SCAN_WP_MATCHING | PM_SCAN_CHECK_WPASYNC : 0;
+    arg.category_mask = PAGE_IS_WRITTEN;
+    arg.return_mask = PAGE_IS_WRITTEN;
+
+    while (pos < *count && addr < end)
+    {
+        arg.start     = (UINT_PTR)addr;
+        arg.end       = (UINT_PTR)end;
+        arg.max_pages = *count - pos;
+        if ((ret = ioctl( pagemap_scan_fd, PAGEMAP_SCAN, &arg )) < 0)
+        {
+            ERR( "PAGEMAP_SCAN failed for %p-%p: %s\n", addr, end, strerror(errno) );
+            return errno_to_status( errno );
+        }
+        for (i = 0; i < ret; i++)
+        {
+            char *page;
+            for (page = (char *)(UINT_PTR)regions[i].start; page < (char *)(UINT_PTR)regions[i].end; page += page_size)
+                addresses[pos++] = page;
+        }
+        addr = (char *)(UINT_PTR)arg.walk_end;
+        if (ret < ARRAY_SIZE(regions)) break;
+    }
+    *count = pos;
+    return STATUS_SUCCESS;
+}
+
+#else  /* HAVE_KERNEL_WRITEWATCH */
+
+static void kernel_writewatch_init(void)
+{
 }
 
+static void kernel_writewatch_reset( void *base, size_t size )
+{
+}
+
+static BOOL kernel_writewatch_register( void *base, size_t size )
+{
+    return FALSE;
+}
+
+static NTSTATUS kernel_get_write_watches( void *base, size_t size, void **addresses,
+                                          ULONG_PTR *count, BOOL reset )
+{
+    return STATUS_NOT_IMPLEMENTED;
+}
+
+#endif  /* HAVE_KERNEL_WRITEWATCH */
+
 
 /***********************************************************************
  *           delete_view
@@ -1535,11 +1799,13 @@ static void unregister_view( struct file_view *view )
  */
 static void delete_view( struct file_view *view ) /* [in] View */
 {
+    views_write_begin();
     if (!(view->protect & VPROT_SYSTEM)) unmap_area( view->base, view->size );
     set_page_vprot( view->base, view->size, 0 );
     if (view->protect & VPROT_ARM64EC) clear_arm64ec_range( view->base, view->size );
     unregister_view( view );
     free_view( view );
+    views_write_end();
 }
 
 
@@ -1550,9 +1816,11 @@ static void delete_view( struct file_view *view ) /* [in] View */
  */
 static void register_view( struct file_view *view )
 {
+    views_write_begin();
     wine_rb_put( &views_tree, view->base, &view->entry );
     if (mmap_is_in_reserved_area( view->base, view->size ))
         free_ranges_insert_view( view );
+    views_write_end();
 }
 
 
@@ -1591,12 +1859,19 @@ static NTSTATUS create_view( struct file_view **view_ret, void *base, size_t siz
         return STATUS_NO_MEMORY;
     }
 
+    views_write_begin();
     view->base    = base;
     view->size    = size;
     view->protect = vprot;
-    set_page_vprot( base, size, vprot );
+    if ((vprot & VPROT_WRITEWATCH) && use_kernel_writewatch && kernel_writewatch_register( base, size ))
+    {
+        view->protect |= VPROT_KERNEL_WRITEWATCH;
+        set_page_vprot( base, size, vprot & ~VPROT_WRITEWATCH );
+    }
+    else set_page_vprot( base, size, vprot );
 
     register_view( view );
+    views_write_end();
 
     *view_ret = view;
 
@@ -1776,7 +2051,9 @@ static void commit_arm64ec_map( struct file_view *view )
     size_t size = ROUND_SIZE( start, end + 1 - start );
     void *base = ROUND_ADDR( (char *)arm64ec_view->base + start, page_mask );
 
+    views_write_begin();
     view->protect |= VPROT_ARM64EC;
+    views_write_end();
     set_vprot( arm64ec_view, base, size, VPROT_READ | VPROT_WRITE | VPROT_COMMITTED );
 }
 
@@ -1801,11 +2078,31 @@ static void update_write_watches( void *base, size_t size, size_t accessed_size
  */
 static void reset_write_watches( void *base, SIZE_T size )
 {
+    if (is_kernel_write_watch_range( base, size ))
+    {
+        kernel_writewatch_reset( base, size );
+        return;
+    }
     set_page_vprot_bits( base, size, VPROT_WRITEWATCH, 0 );
     mprotect_range( base, size, 0, 0 );
 }
 
 
+/***********************************************************************
+ *           disable_kernel_writewatch
+ *
+ * Switch a view back to write watches based on page protections. The pages
+ * don't have VPROT_WRITEWATCH set, so the writes that the kernel tracked so far
+ * are not lost: all the pages are reported as written until the next reset.
+ */
+static void disable_kernel_writewatch( struct file_view *view )
+{
+    views_write_begin();
+    view->protect &= ~VPROT_KERNEL_WRITEWATCH;
+    views_write_end();
+}
+
+
 /***********************************************************************
  *           unmap_extra_space
  *
@@ -1990,9 +2287,20 @@ static NTSTATUS map_view( struct file_view **view_ret, void *base, size_t size,
 
         TRACE( "found view %p, size %p, protect %#x.\n", view->base, (void *)view->size, view->protect );
 
+        views_write_begin();
         view->protect = vprot | VPROT_PLACEHOLDER;
+        views_write_end();
         set_vprot( view, base, size, vprot );
-        if (vprot & VPROT_WRITEWATCH) reset_write_watches( base, size );
+        if (vprot & VPROT_WRITEWATCH)
+        {
+            if (use_kernel_writewatch && kernel_writewatch_register( base, size ))
+            {
+                views_write_begin();
+                view->protect |= VPROT_KERNEL_WRITEWATCH;
+                views_write_end();
+            }
+            else reset_write_watches( base, size );
+        }
         *view_ret = view;
         return STATUS_SUCCESS;
     }
@@ -2189,6 +2497,10 @@ static NTSTATUS decommit_pages( struct file_view *view, size_t start, size_t siz
     if (anon_mmap_fixed( (char *)view->base + start, size, PROT_NONE, 0 ) != MAP_FAILED)
     {
         set_page_vprot_bits( (char *)view->base + start, size, 0, VPROT_COMMITTED );
+        /* the new mapping is no longer registered for write tracking */
+        if ((view->protect & VPROT_KERNEL_WRITEWATCH)
+            && !kernel_writewatch_register( (char *)view->base + start, size ))
+            disable_kernel_writewatch( view );
         return STATUS_SUCCESS;
     }
     return STATUS_NO_MEMORY;
@@ -2205,6 +2517,7 @@ static NTSTATUS remove_pages_from_view( struct file_view *view, char *base, size
 {
     assert( size < view->size );
 
+    views_write_begin();
     if (view->base != base && base + size != (char *)view->base + view->size)
     {
         struct file_view *new_view = alloc_view();
@@ -2212,6 +2525,7 @@ static NTSTATUS remove_pages_from_view( struct file_view *view, char *base, size
         if (!new_view)
         {
             ERR( "out of memory for %p-%p\n", base, base + size );
+            views_write_end();
             return STATUS_NO_MEMORY;
         }
         new_view->base    = base + size;
@@ -2239,6 +2553,7 @@ static NTSTATUS remove_pages_from_view( struct file_view *view, char *base, size
         register_view( view );
         VIRTUAL_DEBUG_DUMP_VIEW( view );
     }
+    views_write_end();
     return STATUS_SUCCESS;
 }
 
@@ -2266,8 +2581,10 @@ static NTSTATUS free_pages_preserve_placeholder( struct file_view *view, char *b
         if (status) return status;
     }
 
+    views_write_begin();
     view->protect = VPROT_PLACEHOLDER | VPROT_FREE_PLACEHOLDER;
     set_page_vprot( view->base, view->size, 0 );
+    views_write_end();
     anon_mmap_fixed( view->base, view->size, PROT_NONE, 0 );
     return STATUS_SUCCESS;
 }
@@ -2331,6 +2648,7 @@ static NTSTATUS coalesce_placeholders( struct file_view *view, char *base, size_
 
     if (view_count < 2 || size != views_size) return STATUS_CONFLICTING_ADDRESSES;
 
+    views_write_begin();
     for (i = 1; i < view_count; ++i)
     {
         curr_view = RB_ENTRY_VALUE( rb_next( &view->entry ), struct file_view, entry );
@@ -2341,6 +2659,7 @@ static NTSTATUS coalesce_placeholders( struct file_view *view, char *base, size_
     unregister_view( view );
     view->size = views_size;
     register_view( view );
+    views_write_end();
 
     VIRTUAL_DEBUG_DUMP_VIEW( view );
 
@@ -3301,6 +3620,7 @@ void virtual_init(void)
             mmap_add_reserved_area( (*preload_info)[i].addr, (*preload_info)[i].size );
 
     mmap_init( preload_info ? *preload_info : NULL );
+    kernel_writewatch_init();
 
     if ((preload = getenv("WINEPRELOADRESERVE")))
     {
@@ -3981,6 +4301,14 @@ NTSTATUS virtual_handle_fault( void *addr, DWORD err, void *stack )
     char *page = ROUND_ADDR( addr, page_mask );
     BYTE vprot;
 
+    /* Faults on pages that are neither guard, write watched nor writable are plain
+     * access violations, there's no need to take the lock for them. The guard and
+     * write watch bits are set before the page protections are changed, so they
+     * are always visible here if they caused the fault. */
+    vprot = get_page_vprot( page );
+    if (!(vprot & (VPROT_GUARD | VPROT_WRITEWATCH)) && !(get_unix_prot( vprot ) & PROT_WRITE))
+        return ret;
+
     mutex_lock( &virtual_mutex );  /* no need for signal masking inside signal handler */
     vprot = get_page_vprot( page );
 
@@ -4937,6 +5265,115 @@ NTSTATUS WINAPI NtProtectVirtualMemory( HANDLE process, PVOID *addr_ptr, SIZE_T
 }
 
 
+/***********************************************************************
+ *           fill_basic_memory_info_lockless
+ *
+ * Try to fill the info structure without taking virtual_mutex. The views tree is
+ * walked optimistically and the result is discarded if views_seq changed meanwhile;
+ * view structures are never unmapped so reading stale ones is harmless.
+ * Returns FALSE if the caller should fall back to the locked path.
+ */
+static BOOL fill_basic_memory_info_lockless( char *base, MEMORY_BASIC_INFORMATION *info )
+{
+    struct ntdll_thread_data *thread_data = ntdll_get_thread_data();
+    struct wine_rb_entry *ptr = NULL;
+    struct file_view *view = thread_data->last_view;
+    char *alloc_base = 0, *alloc_end = working_set_limit, *view_base, *view_end, *end;
+    unsigned int depth, protect = 0;
+    SIZE_T size = 0;
+    BYTE vprot = 0;
+    LONG seq;
+
+    seq = ReadAcquire( &views_seq );
+    if (seq & 1) return FALSE;
+
+    /* check the view found by the last query of this thread first */
+    if (view)
+    {
+        view_base = *(void * volatile *)&view->base;
+        view_end = view_base + *(volatile size_t *)&view->size;
+        if (view_base > base || view_end <= base) view = NULL;
+    }
+    if (!view)
+    {
+        /* the tree depth is bounded, so a longer walk means we followed stale pointers */
+        for (depth = 0, ptr = *(struct wine_rb_entry * volatile *)&views_tree.root; ptr; depth++)
+        {
+            struct file_view *curr = WINE_RB_ENTRY_VALUE( ptr, struct file_view, entry );
+
+            if (depth >= 2 * 8 * sizeof(void *)) return FALSE;
+            view_base = *(void * volatile *)&curr->base;
+            view_end = view_base + *(volatile size_t *)&curr->size;
+            if (view_base > base)
+            {
+                alloc_end = view_base;
+                ptr = *(struct wine_rb_entry * volatile *)&ptr->left;
+            }
+            else if (view_end <= base)
+            {
+                alloc_base = view_end;
+                ptr = *(struct wine_rb_entry * volatile *)&ptr->right;
+            }
+            else
+            {
+                view = curr;
+                break;
+            }
+        }
+    }
+
+    if (view)
+    {
+        protect = *(volatile unsigned int *)&view->protect;
+        /* committed ranges of SEC_RESERVE mappings need a server call */
+        if (protect & SEC_RESERVE) return FALSE;
+        alloc_base = view_base;
+        alloc_end = view_end;
+        end = view_end;
+#ifdef _WIN64
+        {
+            size_t idx = (size_t)base >> page_shift;
+
+            /* don't scan past the current page protection block */
+            if (!*(BYTE * volatile *)&pages_vprot[idx >> pages_vprot_shift]) return FALSE;
+            end = min( end, (char *)(((idx | pages_vprot_mask) + 1) << page_shift) );
+        }
+#endif
+        size = get_vprot_range_size( base, end - base, ~VPROT_WRITEWATCH, &vprot );
+        if (base + size == end && end != view_end) return FALSE;
+    }
+#ifdef __i386__
+    else return FALSE;  /* free ranges depend on the reserved areas */
+#endif
+
+    MemoryBarrier();
+    if (ReadNoFence( &views_seq ) != seq) return FALSE;
+
+    info->BaseAddress = base;
+    if (!view)
+    {
+        info->RegionSize        = alloc_end - base;
+        info->State             = MEM_FREE;
+        info->Protect           = PAGE_NOACCESS;
+        info->AllocationBase    = 0;
+        info->AllocationProtect = 0;
+        info->Type              = 0;
+        return TRUE;
+    }
+
+    thread_data->last_view = view;
+    info->AllocationBase = alloc_base;
+    info->RegionSize = size;
+    info->State = (vprot & VPROT_COMMITTED) ? MEM_COMMIT : MEM_RESERVE;
+    info->Protect = (vprot & VPROT_COMMITTED) ? get_win32_prot( vprot, protect ) : 0;
+    info->AllocationProtect = get_win32_prot( protect, protect );
+    if (protect & SEC_IMAGE) info->Type = MEM_IMAGE;
+    else if (protect & (SEC_FILE | SEC_RESERVE | SEC_COMMIT)) info->Type = MEM_MAPPED;
+    else info->Type = MEM_PRIVATE;
+    return TRUE;
+}
+
+
 static unsigned int fill_basic_memory_info( const void *addr, MEMORY_BASIC_INFORMATION *info )
 {
     char *base, *alloc_base = 0, *alloc_end = working_set_limit;
@@ -4948,6 +5385,8 @@ static unsigned int fill_basic_memory_info( const void *addr, MEMORY_BASIC_INFOR
 
     if (is_beyond_limit( base, 1, working_set_limit )) return STATUS_INVALID_PARAMETER;
 
+    if (fill_basic_memory_info_lockless( base, info )) return STATUS_SUCCESS;
+
     /* Find the view containing the address */
 
     server_enter_uninterrupted_section( &virtual_mutex, &sigset );
@@ -5838,7 +6277,12 @@ NTSTATUS WINAPI NtGetWriteWatch( HANDLE process, ULONG flags, PVOID base, SIZE_T
 
     server_enter_uninterrupted_section( &virtual_mutex, &sigset );
 
-    if (is_write_watch_range( base, size ))
+    if (is_kernel_write_watch_range( base, size ))
+    {
+        status = kernel_get_write_watches( base, size, addresses, count, flags & WRITE_WATCH_FLAG_RESET );
+        if (!status) *granularity = page_size;
+    }
+    else if (is_write_watch_range( base, size ))
     {
         ULONG_PTR pos = 0;
         char *addr = base;
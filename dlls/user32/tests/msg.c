@@ -14571,6 +14571,99 @@ static void test_quit_message(void)
     ok_sequence(WmStopQuitSeq, "WmStopQuitSeq", FALSE);
 }
 
+static LONG prefetch_sent_count;
+
+static LRESULT CALLBACK prefetch_wnd_proc(HWND hwnd, UINT message, WPARAM wparam, LPARAM lparam)
+{
+    if (message == WM_USER + 100) prefetch_sent_count++;
+    return DefWindowProcA(hwnd, message, wparam, lparam);
+}
+
+static DWORD WINAPI send_notify_thread(void *arg)
+{
+    BOOL ret = SendNotifyMessageA(arg, WM_USER + 100, 0, 0);
+    ok(ret, "SendNotifyMessageA failed with error %lu\n", GetLastError());
+    return 0;
+}
+
+static void test_posted_message_order(void)
+{
+    HANDLE thread;
+    HWND hwnd;
+    MSG msg;
+    BOOL ret;
+    int i;
+
+    flush_events();
+
+    /* the quit message comes after all the posted messages, whatever the filters used in between */
+    for (i = 0; i < 40; i++)
+    {
+        ret = PostThreadMessageA(GetCurrentThreadId(), WM_USER + i, i, 0);
+        ok(ret, "PostThreadMessage failed with error %lu\n", GetLastError());
+    }
+    PostQuitMessage(0xbeef);
+
+    ret = GetMessageA(&msg, NULL, 0, 0);
+    ok(ret > 0, "GetMessage failed with error %lu\n", GetLastError());
+    ok(msg.message == WM_USER, "Received message 0x%04x instead of WM_USER\n", msg.message);
+
+    ret = PeekMessageA(&msg, NULL, WM_USER + 30, WM_USER + 30, PM_REMOVE);
+    ok(ret, "PeekMessage failed with error %lu\n", GetLastError());
+    ok(msg.message == WM_USER + 30, "Received message 0x%04x instead of WM_USER + 30\n", msg.message);
+    ret = PeekMessageA(&msg, NULL, WM_USER + 30, WM_USER + 30, PM_REMOVE);
+    ok(!ret, "Received message 0x%04x\n", msg.message);
+
+    for (i = 1; i < 40; i++)
+    {
+        if (i == 30) continue;
+        ret = GetMessageA(&msg, NULL, 0, 0);
+        ok(ret > 0, "GetMessage failed with error %lu\n", GetLastError());
+        ok(msg.message == WM_USER + i, "%d: received message 0x%04x\n", i, msg.message);
+        ok(msg.wParam == i, "%d: wParam was 0x%Ix\n", i, msg.wParam);
+    }
+
+    ret = GetMessageA(&msg, NULL, 0, 0);
+    ok(!ret, "GetMessage return %d with error %lu instead of FALSE\n", ret, GetLastError());
+    ok(msg.message == WM_QUIT, "Received message 0x%04x instead of WM_QUIT\n", msg.message);
+    ok(msg.wParam == 0xbeef, "wParam was 0x%Ix instead of 0xbeef\n", msg.wParam);
+
+    /* messages sent while posted messages are pending are received first */
+    hwnd = CreateWindowExA(0, "static", NULL, WS_POPUP, 0, 0, 10, 10, 0, 0, 0, NULL);
+    ok(hwnd != 0, "Failed to create window\n");
+    SetWindowLongPtrA(hwnd, GWLP_WNDPROC, (LONG_PTR)prefetch_wnd_proc);
+    flush_events();
+
+    for (i = 0; i < 8; i++)
+    {
+        ret = PostMessageA(hwnd, WM_USER + i, 0, 0);
+        ok(ret, "PostMessage failed with error %lu\n", GetLastError());
+    }
+
+    ret = PeekMessageA(&msg, hwnd, 0, 0, PM_REMOVE);
+    ok(ret, "PeekMessage failed with error %lu\n", GetLastError());
+    ok(msg.message == WM_USER, "Received message 0x%04x instead of WM_USER\n", msg.message);
+
+    prefetch_sent_count = 0;
+    thread = CreateThread(NULL, 0, send_notify_thread, hwnd, 0, NULL);
+    ok(thread != NULL, "CreateThread failed with error %lu\n", GetLastError());
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+    ok(!prefetch_sent_count, "sent message received too early\n");
+
+    for (i = 1; i < 8; i++)
+    {
+        ret = PeekMessageA(&msg, hwnd, 0, 0, PM_REMOVE);
+        ok(ret, "PeekMessage failed with error %lu\n", GetLastError());
+        ok(msg.message == WM_USER + i, "%d: received message 0x%04x\n", i, msg.message);
+        ok(prefetch_sent_count == 1, "%d: sent message received %ld times\n", i, prefetch_sent_count);
+    }
+    ret = PeekMessageA(&msg, hwnd, 0, 0, PM_REMOVE);
+    ok(!ret, "Received message 0x%04x\n", msg.message);
+
+    DestroyWindow(hwnd);
+}
+
 static const struct message WmNotifySeq[] = {
     { WM_NOTIFY, sent|wparam|lparam, 0x1234, 0xdeadbeef },
     { 0 }
@@ -20525,6 +20618,7 @@ START_TEST(msg)
     test_SendMessageTimeout();
     test_edit_messages();
     test_quit_message();
+    test_posted_message_order();
     test_notify_message();
     test_SetActiveWindow();
     test_restore_messages();
@@ -11365,6 +11365,66 @@ static void test_LockWindowUpdate(HWND parent)
     DestroyWindow(child);
 }
 
+static void test_surface_flush(void)
+{
+    static const RECT rects[] =
+    {
+        {   2,   2,  12,  12 },
+        { 188, 188, 198, 198 },
+        {  95,  95, 105, 105 },
+        { 188,   2, 198,  12 },
+        {   2, 188,  12, 198 },
+    };
+    HDC hdc, screen;
+    COLORREF color;
+    HBRUSH brush;
+    HWND hwnd;
+    RECT rect;
+    UINT i;
+
+    hwnd = CreateWindowExA(WS_EX_TOPMOST, "static", NULL, WS_POPUP | WS_VISIBLE,
+                           100, 100, 200, 200, 0, 0, NULL, NULL);
+    ok(hwnd != 0, "CreateWindowEx failed\n");
+    SetForegroundWindow(hwnd);
+    flush_events(TRUE);
+
+    screen = GetDC(0);
+    hdc = GetDC(hwnd);
+    SetRect(&rect, 0, 0, 200, 200);
+    FillRect(hdc, &rect, GetStockObject(WHITE_BRUSH));
+    flush_events(TRUE);
+
+    color = GetPixel(screen, 150, 150);
+    if (color != RGB(255, 255, 255))
+    {
+        skip("window contents not visible on the screen, color %#lx\n", color);
+        goto done;
+    }
+
+    /* small updates scattered over the window, all drawn before the next flush */
+    brush = CreateSolidBrush(RGB(255, 0, 0));
+    for (i = 0; i < ARRAY_SIZE(rects); i++) FillRect(hdc, &rects[i], brush);
+    SetPixel(hdc, 50, 150, RGB(0, 0, 255));
+    flush_events(TRUE);
+
+    for (i = 0; i < ARRAY_SIZE(rects); i++)
+    {
+        color = GetPixel(screen, 100 + (rects[i].left + rects[i].right) / 2,
+                         100 + (rects[i].top + rects[i].bottom) / 2);
+        ok(color == RGB(255, 0, 0), "%u: got color %#lx\n", i, color);
+    }
+    color = GetPixel(screen, 150, 250);
+    ok(color == RGB(0, 0, 255), "got color %#lx\n", color);
+    color = GetPixel(screen, 150, 150);
+    ok(color == RGB(255, 255, 255), "got color %#lx\n", color);
+    DeleteObject(brush);
+
+done:
+    ReleaseDC(hwnd, hdc);
+    ReleaseDC(0, screen);
+    DestroyWindow(hwnd);
+}
+
 static void test_hide_window(void)
 {
     HWND hwnd, hwnd2, hwnd3;
@@ -12758,6 +12818,56 @@ static void other_process_proc(HWND hwnd)
     CloseHandle(test_done_event);
 }
 
+static void other_process_info_proc(HWND hwnd)
+{
+    HANDLE window_ready_event, test_done_event;
+    DWORD ret, pid, tid;
+    HWND parent;
+    RECT rect;
+
+    window_ready_event = OpenEventA(EVENT_ALL_ACCESS, FALSE, "test_opwi_window");
+    ok(!!window_ready_event, "OpenEvent failed.\n");
+    test_done_event = OpenEventA(EVENT_ALL_ACCESS, FALSE, "test_opwi_test");
+    ok(!!test_done_event, "OpenEvent failed.\n");
+
+    ret = WaitForSingleObject(window_ready_event, 5000);
+    ok(ret == WAIT_OBJECT_0, "Unexpected ret %lx.\n", ret);
+    parent = GetParent(hwnd);
+    ok(!!parent, "GetParent failed.\n");
+    ok(IsWindow(hwnd), "IsWindow failed.\n");
+    ok(IsWindowVisible(hwnd), "window is not visible.\n");
+    tid = GetWindowThreadProcessId(hwnd, &pid);
+    ok(tid == GetWindowThreadProcessId(parent, NULL), "Unexpected tid %lx.\n", tid);
+    ok(pid != GetCurrentProcessId(), "Unexpected pid %lx.\n", pid);
+    ok(GetWindowLongA(hwnd, GWLP_ID) == 7, "Unexpected id %ld.\n", GetWindowLongA(hwnd, GWLP_ID));
+    GetWindowRect(hwnd, &rect);
+    ok(rect.left == 110 && rect.top == 120 && rect.right == 160 && rect.bottom == 170,
+       "Unexpected rect %s.\n", wine_dbgstr_rect(&rect));
+    SetEvent(test_done_event);
+
+    /* parent moved and child hidden */
+    ret = WaitForSingleObject(window_ready_event, 5000);
+    ok(ret == WAIT_OBJECT_0, "Unexpected ret %lx.\n", ret);
+    ok(!IsWindowVisible(hwnd), "window is visible.\n");
+    ok(!(GetWindowLongA(hwnd, GWL_STYLE) & WS_VISIBLE), "Unexpected style %#lx.\n",
+       GetWindowLongA(hwnd, GWL_STYLE));
+    GetWindowRect(hwnd, &rect);
+    ok(rect.left == 210 && rect.top == 220 && rect.right == 260 && rect.bottom == 270,
+       "Unexpected rect %s.\n", wine_dbgstr_rect(&rect));
+    SetEvent(test_done_event);
+
+    /* parent destroyed */
+    ret = WaitForSingleObject(window_ready_event, 5000);
+    ok(ret == WAIT_OBJECT_0, "Unexpected ret %lx.\n", ret);
+    ok(!IsWindow(hwnd), "window still exists.\n");
+    ok(!IsWindow(parent), "parent still exists.\n");
+    ok(!GetWindowThreadProcessId(hwnd, NULL), "window still has a thread.\n");
+    SetEvent(test_done_event);
+
+    CloseHandle(window_ready_event);
+    CloseHandle(test_done_event);
+}
+
 static void test_SC_SIZE(void)
 {
     HWND hwnd;
@@ -12854,6 +12964,56 @@ static void test_other_process_window(const char *argv0)
     DestroyWindow(hwnd);
 }
 
+static void test_other_process_window_info(const char *argv0)
+{
+    HANDLE window_ready_event, test_done_event;
+    PROCESS_INFORMATION info;
+    STARTUPINFOA startup;
+    char cmd[MAX_PATH];
+    HWND hwnd, child;
+    DWORD ret;
+
+    hwnd = CreateWindowExA(0, "static", NULL, WS_POPUP | WS_VISIBLE,
+            100, 100, 100, 100, 0, 0, NULL, NULL);
+    ok(!!hwnd, "CreateWindowEx failed.\n");
+    child = CreateWindowExA(0, "static", NULL, WS_CHILD | WS_VISIBLE,
+            10, 20, 50, 50, hwnd, (HMENU)7, NULL, NULL);
+    ok(!!child, "CreateWindowEx failed.\n");
+
+    window_ready_event = CreateEventA(NULL, FALSE, FALSE, "test_opwi_window");
+    ok(!!window_ready_event, "CreateEvent failed.\n");
+    test_done_event = CreateEventA(NULL, FALSE, FALSE, "test_opwi_test");
+    ok(!!test_done_event, "CreateEvent failed.\n");
+
+    sprintf(cmd, "%s win test_other_process_window_info %p", argv0, child);
+    memset(&startup, 0, sizeof(startup));
+    startup.cb = sizeof(startup);
+
+    ok(CreateProcessA(NULL, cmd, NULL, NULL, FALSE, 0, NULL, NULL,
+            &startup, &info), "CreateProcess failed.\n");
+
+    SetEvent(window_ready_event);
+    ret = WaitForSingleObject(test_done_event, 5000);
+    ok(ret == WAIT_OBJECT_0, "Unexpected ret %lx.\n", ret);
+
+    SetWindowPos(hwnd, 0, 200, 200, 0, 0, SWP_NOSIZE | SWP_NOZORDER | SWP_NOACTIVATE);
+    ShowWindow(child, SW_HIDE);
+    SetEvent(window_ready_event);
+    ret = WaitForSingleObject(test_done_event, 5000);
+    ok(ret == WAIT_OBJECT_0, "Unexpected ret %lx.\n", ret);
+
+    DestroyWindow(hwnd);
+    SetEvent(window_ready_event);
+    ret = WaitForSingleObject(test_done_event, 5000);
+    ok(ret == WAIT_OBJECT_0, "Unexpected ret %lx.\n", ret);
+
+    wait_child_process(info.hProcess);
+    CloseHandle(window_ready_event);
+    CloseHandle(test_done_event);
+    CloseHandle(info.hProcess);
+    CloseHandle(info.hThread);
+}
+
 static void test_cancel_mode(void)
 {
     HWND hwnd1, hwnd2, child;
@@ -13104,6 +13264,11 @@ START_TEST(win)
             other_process_proc(hwnd);
             return;
         }
+        else if (!strcmp(argv[2], "test_other_process_window_info"))
+        {
+            other_process_info_proc(hwnd);
+            return;
+        }
     }
 
     if (argc == 3 && !strcmp(argv[2], "winproc_limit"))
@@ -13233,6 +13398,7 @@ START_TEST(win)
     test_winproc_handles(argv[0]);
     test_deferwindowpos();
     test_LockWindowUpdate(hwndMain);
+    test_surface_flush();
     test_desktop();
     test_display_affinity(hwndMain);
     test_hide_window();
@@ -13242,6 +13408,7 @@ START_TEST(win)
     test_window_placement();
     test_arrange_iconic_windows();
     test_other_process_window(argv[0]);
+    test_other_process_window_info(argv[0]);
     test_SC_SIZE();
     test_cancel_mode();
     test_DragDetect();
@@ -195,7 +195,7 @@ DWORD stretch_bits( const BITMAPINFO *src_info, struct bitblt_coords *src,
                     BITMAPINFO *dst_info, struct bitblt_coords *dst,
                     struct gdi_image_bits *bits, int mode )
 {
-    void *ptr;
+    struct gdi_image_bits dst_bits;
     DWORD err;
 
     dst_info->bmiHeader.biWidth = dst->visrect.right - dst->visrect.left;
@@ -203,14 +203,15 @@ DWORD stretch_bits( const BITMAPINFO *src_info, struct bitblt_coords *src,
     dst_info->bmiHeader.biSizeImage = get_dib_image_size( dst_info );
 
     if (src_info->bmiHeader.biHeight < 0) dst_info->bmiHeader.biHeight = -dst_info->bmiHeader.biHeight;
-    if (!(ptr = malloc( dst_info->bmiHeader.biSizeImage )))
+    if (!(dst_bits.ptr = malloc( dst_info->bmiHeader.biSizeImage )))
         return ERROR_OUTOFMEMORY;
+    dst_bits.is_copy = TRUE;
+    dst_bits.free = free_heap_bits;
+    dst_bits.param = NULL;
 
-    err = stretch_bitmapinfo( src_info, bits->ptr, src, dst_info, ptr, dst, mode );
+    err = stretch_bitmapinfo( src_info, bits, src, dst_info, &dst_bits, dst, mode );
     if (bits->free) bits->free( bits );
-    bits->ptr = ptr;
-    bits->is_copy = TRUE;
-    bits->free = free_heap_bits;
+    *bits = dst_bits;
     return err;
 }
 
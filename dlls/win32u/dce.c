@@ -412,6 +412,106 @@ done:
     pthread_mutex_unlock( &surfaces_lock );
 }
 
+static inline LONGLONG get_rect_area( const RECT *rect )
+{
+    return (LONGLONG)(rect->right - rect->left) * (rect->bottom - rect->top);
+}
+
+/*******************************************************************
+ *           window_surface_add_damage
+ *
+ * Add a rectangle to the damage list of a window surface, merging it with the
+ * existing rectangles when that doesn't add too much undamaged area.
+ */
+void window_surface_add_damage( struct window_surface_damage *damage, const RECT *rect )
+{
+    RECT merged = *rect, tmp;
+    LONGLONG waste, best_waste = 0;
+    UINT i, best = 0;
+
+    if (IsRectEmpty( rect )) return;
+
+    for (i = 0; i < damage->count;)
+    {
+        union_rect( &tmp, &damage->rects[i], &merged );
+        waste = get_rect_area( &tmp ) - get_rect_area( &damage->rects[i] ) - get_rect_area( &merged );
+        if (waste > max( 1024, (get_rect_area( &damage->rects[i] ) + get_rect_area( &merged )) / 4 ))
+        {
+            i++;
+            continue;
+        }
+        /* the merged rectangle may now be close to one we already skipped, start over */
+        merged = tmp;
+        damage->rects[i] = damage->rects[--damage->count];
+        i = 0;
+    }
+
+    if (damage->count == ARRAY_SIZE(damage->rects))
+    {
+        /* the list is full, merge with the rectangle that grows the least */
+        for (i = 0; i < damage->count; i++)
+        {
+            union_rect( &tmp, &damage->rects[i], &merged );
+            waste = get_rect_area( &tmp ) - get_rect_area( &damage->rects[i] );
+            if (!i || waste < best_waste)
+            {
+                best_waste = waste;
+                best = i;
+            }
+        }
+        union_rect( &merged, &merged, &damage->rects[best] );
+        damage->rects[best] = damage->rects[--damage->count];
+        window_surface_add_damage( damage, &merged );
+        return;
+    }
+
+    damage->rects[damage->count++] = merged;
+}
+
+/*******************************************************************
+ *           window_surface_add_bounds
+ *
+ * Add a rectangle to the bounds of a window surface, and to its damage list if
+ * it has one. Surfaces that track damage must get all their bounds updates from
+ * here, the flush only uploads what is in the damage list.
+ */
+void window_surface_add_bounds( struct window_surface *surface, const RECT *rect )
+{
+    struct window_surface_damage *damage;
+
+    add_bounds_rect( surface->funcs->get_bounds( surface ), rect );
+    if (surface->funcs->get_damage && (damage = surface->funcs->get_damage( surface )))
+        window_surface_add_damage( damage, rect );
+}
+
+/*******************************************************************
+ *           window_surface_get_damage_rects
+ *
+ * Get the rectangles that need to be flushed for the given surface bounds. The
+ * bounds are used directly if the damage list doesn't cover them, which only
+ * happens when a driver updated them without window_surface_add_bounds.
+ */
+UINT window_surface_get_damage_rects( const struct window_surface_damage *damage,
+                                      const RECT *bounds, const RECT **rects )
+{
+    RECT extents;
+    UINT i;
+
+    if (IsRectEmpty( bounds )) return 0;
+
+    reset_bounds( &extents );
+    for (i = 0; i < damage->count; i++) add_bounds_rect( &extents, &damage->rects[i] );
+    if (!damage->count || !EqualRect( &extents, bounds ))
+    {
+        WARN( "bounds %s updated outside of the damage list %s\n",
+              wine_dbgstr_rect( bounds ), wine_dbgstr_rect( &extents ));
+        *rects = bounds;
+        return 1;
+    }
+    *rects = damage->rects;
+    return damage->count;
+}
+
 /***********************************************************************
  *           dump_rdw_flags
  */
@@ -23,6 +23,9 @@
 #endif
 
 #include <assert.h>
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
 
 #include "ntgdi_private.h"
 #include "dibdrv.h"
@@ -585,17 +588,198 @@ static void mask_rect( dib_info *dst, const RECT *dst_rect, const dib_info *src,
     }
 }
 
+/* Large operations are split in independent items (usually bands of rows) that are
+ * processed by a small pool of worker threads. Each item writes a distinct set of
+ * pixels, so the result doesn't depend on which thread processes it.
+ * The workers can't handle exceptions, so they are only used on bits allocated by gdi;
+ * DIB sections and app-supplied bits may be protected or freed by the app at any time. */
+
+#define TILE_MIN_PIXELS   (512 * 512)  /* below this, threading doesn't pay off */
+#define TILE_BAND_PIXELS  (64 * 1024)
+#define TILE_MAX_THREADS  8
+
+struct tile_job
+{
+    void       (*func)( struct tile_job *job, unsigned int index );
+    unsigned int count;
+    LONG         next;
+    unsigned int users;
+};
+
+static pthread_once_t tile_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t tile_job_mutex = PTHREAD_MUTEX_INITIALIZER;  /* one job at a time */
+static pthread_mutex_t tile_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t tile_start_cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t tile_done_cond = PTHREAD_COND_INITIALIZER;
+static struct tile_job *tile_current;
+static unsigned int tile_serial;
+static unsigned int tile_threads;
+
+static void process_tiles( struct tile_job *job )
+{
+    LONG index;
+
+    while ((index = InterlockedIncrement( &job->next ) - 1) < job->count) job->func( job, index );
+}
+
+static void *tile_worker( void *arg )
+{
+    unsigned int serial = 0;
+    struct tile_job *job;
+
+    for (;;)
+    {
+        pthread_mutex_lock( &tile_mutex );
+        while (serial == tile_serial) pthread_cond_wait( &tile_start_cond, &tile_mutex );
+        serial = tile_serial;
+        if ((job = tile_current)) job->users++;
+        pthread_mutex_unlock( &tile_mutex );
+        if (!job) continue;
+
+        process_tiles( job );
+
+        pthread_mutex_lock( &tile_mutex );
+        if (!--job->users) pthread_cond_signal( &tile_done_cond );
+        pthread_mutex_unlock( &tile_mutex );
+    }
+    return NULL;
+}
+
+static void init_tile_threads(void)
+{
+    long count = sysconf( _SC_NPROCESSORS_ONLN );
+    sigset_t sigset, old_sigset;
+    pthread_attr_t attr;
+    pthread_t thread;
+
+    if (count <= 1) return;
+    count = min( count, TILE_MAX_THREADS ) - 1;
+
+    /* the workers don't have a TEB, make sure they never receive signals */
+    sigfillset( &sigset );
+    pthread_sigmask( SIG_SETMASK, &sigset, &old_sigset );
+    pthread_attr_init( &attr );
+    pthread_attr_setdetachstate( &attr, PTHREAD_CREATE_DETACHED );
+    while (tile_threads < count && !pthread_create( &thread, &attr, tile_worker, NULL )) tile_threads++;
+    pthread_attr_destroy( &attr );
+    pthread_sigmask( SIG_SETMASK, &old_sigset, NULL );
+    TRACE( "started %u threads\n", tile_threads );
+}
+
+static inline BOOL is_private_dib( const dib_info *dib )
+{
+    return dib->private_bits || dib->bits.is_copy;
+}
+
+static BOOL use_tile_threads( const dib_info *dst, const dib_info *src, ULONGLONG pixels )
+{
+    if (pixels < TILE_MIN_PIXELS) return FALSE;
+    if (!is_private_dib( dst ) || (src && !is_private_dib( src ))) return FALSE;
+    pthread_once( &tile_once, init_tile_threads );
+    return tile_threads != 0;
+}
+
+/* process all the job items, using the worker threads unless they are busy with another job */
+static void run_tile_job( struct tile_job *job )
+{
+    job->next = 0;
+    job->users = 0;
+
+    if (pthread_mutex_trylock( &tile_job_mutex ))
+    {
+        process_tiles( job );
+        return;
+    }
+
+    pthread_mutex_lock( &tile_mutex );
+    tile_current = job;
+    tile_serial++;
+    pthread_cond_broadcast( &tile_start_cond );
+    pthread_mutex_unlock( &tile_mutex );
+
+    process_tiles( job );
+
+    pthread_mutex_lock( &tile_mutex );
+    tile_current = NULL;
+    while (job->users) pthread_cond_wait( &tile_done_cond, &tile_mutex );
+    pthread_mutex_unlock( &tile_mutex );
+    pthread_mutex_unlock( &tile_job_mutex );
+}
+
+/* split rectangles in bands of rows, returns NULL if the area is too small to be worth it */
+static RECT *get_tile_bands( const dib_info *dst, const dib_info *src, const RECT *rects,
+                             unsigned int count, unsigned int *band_count )
+{
+    ULONGLONG pixels = 0;
+    unsigned int i, rows, total = 0;
+    RECT *bands;
+
+    for (i = 0; i < count; i++)
+    {
+        rows = max( 1, TILE_BAND_PIXELS / (rects[i].right - rects[i].left) );
+        total += (rects[i].bottom - rects[i].top + rows - 1) / rows;
+        pixels += (ULONGLONG)(rects[i].right - rects[i].left) * (rects[i].bottom - rects[i].top);
+    }
+    if (total <= 1 || !use_tile_threads( dst, src, pixels )) return NULL;
+    if (!(bands = malloc( total * sizeof(*bands) ))) return NULL;
+
+    for (i = 0, *band_count = 0; i < count; i++)
+    {
+        RECT band = rects[i];
+
+        rows = max( 1, TILE_BAND_PIXELS / (rects[i].right - rects[i].left) );
+        for (band.top = rects[i].top; band.top < rects[i].bottom; band.top = band.bottom)
+        {
+            band.bottom = min( band.top + rows, rects[i].bottom );
+            bands[(*band_count)++] = band;
+        }
+    }
+    return bands;
+}
+
+struct blend_tile_job
+{
+    struct tile_job job;
+    dib_info       *dst;
+    const dib_info *src;
+    const RECT     *rects;
+    POINT           offset;
+    BLENDFUNCTION   blend;
+};
+
+static void blend_tile( struct tile_job *job, unsigned int index )
+{
+    struct blend_tile_job *blend = CONTAINING_RECORD( job, struct blend_tile_job, job );
+
+    blend->dst->funcs->blend_rects( blend->dst, 1, &blend->rects[index], blend->src,
+                                    &blend->offset, blend->blend );
+}
+
 static DWORD blend_rect( dib_info *dst, const RECT *dst_rect, const dib_info *src, const RECT *src_rect,
                          HRGN clip, BLENDFUNCTION blend )
 {
     POINT offset;
     struct clipped_rects clipped_rects;
+    struct blend_tile_job job;
+    RECT *bands;
 
     if (!get_clipped_rects( dst, dst_rect, clip, &clipped_rects )) return ERROR_SUCCESS;
 
     offset.x = src_rect->left - dst_rect->left;
     offset.y = src_rect->top  - dst_rect->top;
-    dst->funcs->blend_rects( dst, clipped_rects.count, clipped_rects.rects, src, &offset, blend );
+
+    if ((bands = get_tile_bands( dst, src, clipped_rects.rects, clipped_rects.count, &job.job.count )))
+    {
+        job.job.func = blend_tile;
+        job.dst      = dst;
+        job.src      = src;
+        job.rects    = bands;
+        job.offset   = offset;
+        job.blend    = blend;
+        run_tile_job( &job.job );
+        free( bands );
+    }
+    else dst->funcs->blend_rects( dst, clipped_rects.count, clipped_rects.rects, src, &offset, blend );
 
     free_clipped_rects( &clipped_rects );
     return ERROR_SUCCESS;
@@ -680,14 +864,45 @@ static void get_gradient_triangle_vertices( const GRADIENT_TRIANGLE *tri, const
     bounds->bottom = v[2].y;
 }
 
+struct gradient_tile_job
+{
+    struct tile_job job;
+    dib_info       *dib;
+    const RECT     *rects;
+    TRIVERTEX      *v;
+    int             mode;
+    BOOL            failed;
+};
+
+static void gradient_tile( struct tile_job *job, unsigned int index )
+{
+    struct gradient_tile_job *gradient = CONTAINING_RECORD( job, struct gradient_tile_job, job );
+
+    if (!gradient->dib->funcs->gradient_rect( gradient->dib, &gradient->rects[index], gradient->v, gradient->mode ))
+        gradient->failed = TRUE;
+}
+
 static BOOL gradient_rect( dib_info *dib, TRIVERTEX *v, int mode, HRGN clip, const RECT *bounds )
 {
     int i;
     struct clipped_rects clipped_rects;
+    struct gradient_tile_job job;
     BOOL ret = TRUE;
 
     if (!get_clipped_rects( dib, bounds, clip, &clipped_rects )) return TRUE;
-    for (i = 0; i < clipped_rects.count; i++)
+    if ((job.rects = get_tile_bands( dib, NULL, clipped_rects.rects, clipped_rects.count,
+                                     &job.job.count )))
+    {
+        job.job.func = gradient_tile;
+        job.dib      = dib;
+        job.v        = v;
+        job.mode     = mode;
+        job.failed   = FALSE;
+        run_tile_job( &job.job );
+        ret = !job.failed;
+        free( (RECT *)job.rects );
+    }
+    else for (i = 0; i < clipped_rects.count; i++)
     {
         if (!(ret = dib->funcs->gradient_rect( dib, &clipped_rects.rects[i], v, mode ))) break;
     }
@@ -1198,27 +1413,97 @@ static DWORD calc_1d_stretch_params( INT dst_start, INT dst_length, INT dst_vis_
 }
 
 
-DWORD stretch_bitmapinfo( const BITMAPINFO *src_info, void *src_bits, struct bitblt_coords *src,
-                          const BITMAPINFO *dst_info, void *dst_bits, struct bitblt_coords *dst,
-                          INT mode )
+/* a destination row and the rows that are copied from it, or the source rows merged into it */
+struct stretch_segment
+{
+    int dst_y;
+    int src_y;
+    int count;
+};
+
+struct stretch_tile_job
+{
+    struct tile_job               job;
+    dib_info                     *dst_dib;
+    const dib_info               *src_dib;
+    const struct stretch_segment *segments;
+    const struct stretch_params  *h_params;
+    void (* row_fn)(const dib_info *dst_dib, const POINT *dst_start,
+                    const dib_info *src_dib, const POINT *src_start,
+                    const struct stretch_params *params, int mode, BOOL keep_dst);
+    int                           dst_x;
+    int                           src_x;
+    int                           dst_inc;
+    int                           src_inc;
+    int                           width;
+    int                           mode;
+    BOOL                          vstretch;
+};
+
+static void stretch_tile( struct tile_job *job, unsigned int index )
+{
+    struct stretch_tile_job *stretch = CONTAINING_RECORD( job, struct stretch_tile_job, job );
+    const struct stretch_segment *segment = &stretch->segments[index];
+    POINT dst_start, src_start;
+    int i;
+
+    dst_start.x = stretch->dst_x;
+    dst_start.y = segment->dst_y;
+    src_start.x = stretch->src_x;
+    src_start.y = segment->src_y;
+
+    if (stretch->vstretch)
+    {
+        RECT last_row, this_row;
+
+        stretch->row_fn( stretch->dst_dib, &dst_start, stretch->src_dib, &src_start,
+                         stretch->h_params, stretch->mode, FALSE );
+        last_row.left = 0;
+        last_row.right = stretch->width;
+        for (i = 1; i < segment->count; i++)
+        {
+            last_row.top = dst_start.y;
+            last_row.bottom = last_row.top + 1;
+            dst_start.y += stretch->dst_inc;
+            this_row = last_row;
+            OffsetRect( &this_row, 0, stretch->dst_inc );
+            copy_rect( stretch->dst_dib, &this_row, stretch->dst_dib, &last_row, NULL, R2_COPYPEN );
+        }
+    }
+    else
+    {
+        for (i = 0; i < segment->count; i++, src_start.y += stretch->src_inc)
+        {
+            if (stretch->mode != STRETCH_DELETESCANS || !i)
+                stretch->row_fn( stretch->dst_dib, &dst_start, stretch->src_dib, &src_start,
+                                 stretch->h_params, stretch->mode, i != 0 );
+        }
+    }
+}
+
+DWORD stretch_bitmapinfo( const BITMAPINFO *src_info, const struct gdi_image_bits *src_bits,
+                          struct bitblt_coords *src, const BITMAPINFO *dst_info,
+                          const struct gdi_image_bits *dst_bits, struct bitblt_coords *dst, INT mode )
 {
     dib_info src_dib, dst_dib;
     POINT dst_start, src_start, dst_end, src_end;
     RECT rect;
     BOOL hstretch, vstretch;
     struct stretch_params v_params, h_params;
+    struct stretch_segment *segments, *segment = NULL;
+    struct stretch_tile_job job;
+    unsigned int i;
     int err;
     DWORD ret;
-    void (* row_fn)(const dib_info *dst_dib, const POINT *dst_start,
-                    const dib_info *src_dib, const POINT *src_start,
-                    const struct stretch_params *params, int mode, BOOL keep_dst);
 
     TRACE("dst %d, %d - %d x %d visrect %s src %d, %d - %d x %d visrect %s\n",
           dst->x, dst->y, dst->width, dst->height, wine_dbgstr_rect(&dst->visrect),
           src->x, src->y, src->width, src->height, wine_dbgstr_rect(&src->visrect));
 
-    init_dib_info_from_bitmapinfo( &src_dib, src_info, src_bits );
-    init_dib_info_from_bitmapinfo( &dst_dib, dst_info, dst_bits );
+    init_dib_info_from_bitmapinfo( &src_dib, src_info, src_bits->ptr );
+    init_dib_info_from_bitmapinfo( &dst_dib, dst_info, dst_bits->ptr );
+    src_dib.bits.is_copy = src_bits->is_copy;
+    dst_dib.bits.is_copy = dst_bits->is_copy;
 
     if (mode == HALFTONE)
     {
@@ -1253,31 +1538,40 @@ DWORD stretch_bitmapinfo( const BITMAPINFO *src_info, void *src_bits, struct bit
 
     err = v_params.err_start;
 
-    row_fn = hstretch ? dst_dib.funcs->stretch_row : dst_dib.funcs->shrink_row;
-
+    if (!(segments = malloc( max( v_params.length, 1 ) * sizeof(*segments) ))) return ERROR_OUTOFMEMORY;
+
+    job.job.func = stretch_tile;
+    job.job.count = 0;
+    job.dst_dib   = &dst_dib;
+    job.src_dib   = &src_dib;
+    job.segments  = segments;
+    job.h_params  = &h_params;
+    job.row_fn    = hstretch ? dst_dib.funcs->stretch_row : dst_dib.funcs->shrink_row;
+    job.dst_x     = dst_start.x;
+    job.src_x     = src_start.x;
+    job.dst_inc   = v_params.dst_inc;
+    job.src_inc   = v_params.src_inc;
+    job.width     = dst->visrect.right - dst->visrect.left;
+    job.mode      = mode;
+    job.vstretch  = vstretch;
+
+    /* compute the segments first, they can then be processed in any order */
     if (vstretch)
     {
         BOOL need_row = TRUE;
-        RECT last_row, this_row;
-        if (hstretch) mode = STRETCH_DELETESCANS;
-        last_row.left = 0;
-        last_row.right = dst->visrect.right - dst->visrect.left;
+        if (hstretch) job.mode = STRETCH_DELETESCANS;
 
         while (v_params.length--)
         {
             if (need_row)
             {
-                row_fn( &dst_dib, &dst_start, &src_dib, &src_start, &h_params, mode, FALSE );
+                segment = &segments[job.job.count++];
+                segment->dst_y = dst_start.y;
+                segment->src_y = src_start.y;
+                segment->count = 0;
                 need_row = FALSE;
             }
-            else
-            {
-                last_row.top = dst_start.y - v_params.dst_inc;
-                last_row.bottom = last_row.top + 1;
-                this_row = last_row;
-                OffsetRect( &this_row, 0, v_params.dst_inc );
-                copy_rect( &dst_dib, &this_row, &dst_dib, &last_row, NULL, R2_COPYPEN );
-            }
+            segment->count++;
 
             if (err > 0)
             {
@@ -1291,18 +1585,24 @@ DWORD stretch_bitmapinfo( const BITMAPINFO *src_info, void *src_bits, struct bit
     }
     else
     {
-        int merged_rows = 0;
+        BOOL new_row = TRUE;
 
         while (v_params.length--)
         {
-            if (mode != STRETCH_DELETESCANS || !merged_rows)
-                row_fn( &dst_dib, &dst_start, &src_dib, &src_start, &h_params, mode, merged_rows != 0 );
-            merged_rows++;
+            if (new_row)
+            {
+                segment = &segments[job.job.count++];
+                segment->dst_y = dst_start.y;
+                segment->src_y = src_start.y;
+                segment->count = 0;
+                new_row = FALSE;
+            }
+            segment->count++;
 
             if (err > 0)
             {
                 dst_start.y += v_params.dst_inc;
-                merged_rows = 0;
+                new_row = TRUE;
                 err += v_params.err_add_1;
             }
             else err += v_params.err_add_2;
@@ -1310,6 +1610,14 @@ DWORD stretch_bitmapinfo( const BITMAPINFO *src_info, void *src_bits, struct bit
         }
     }
 
+    if (job.job.count > 1 &&
+        use_tile_threads( &dst_dib, &src_dib, (ULONGLONG)job.width * (dst->visrect.bottom - dst->visrect.top) ))
+        run_tile_job( &job.job );
+    else
+        for (i = 0; i < job.job.count; i++) stretch_tile( &job.job, i );
+
+    free( segments );
+
 done:
     /* update coordinates, the destination rectangle is always stored at 0,0 */
     *src = *dst;
@@ -91,6 +91,7 @@ static void init_dib_info(dib_info *dib, const BITMAPINFOHEADER *bi, int stride,
     dib->bits.is_copy = FALSE;
     dib->bits.free    = NULL;
     dib->bits.param   = NULL;
+    dib->private_bits = FALSE;
 
     if(dib->height < 0) /* top-down */
     {
@@ -177,6 +178,7 @@ BOOL init_dib_info_from_bitmapobj(dib_info *dib, BITMAPOBJ *bmp)
 
         get_ddb_bitmapinfo( bmp, &info );
         init_dib_info_from_bitmapinfo( dib, &info, bmp->dib.dsBm.bmBits );
+        dib->private_bits = TRUE;
     }
     else init_dib_info( dib, &bmp->dib.dsBmih, bmp->dib.dsBm.bmWidthBytes,
                         bmp->dib.dsBitfields, bmp->color_table, bmp->dib.dsBm.bmBits );
@@ -287,6 +289,17 @@ int get_clipped_rects( const dib_info *dib, const RECT *rc, HRGN clip, struct cl
     for (i = region_find_pt( region, rect.left, rect.top, NULL ); i < region->numRects; i++)
     {
         if (region->rects[i].top >= rect.bottom) break;
+        /* skip the parts of the bands that are left or right of the rectangle */
+        if (region->rects[i].right <= rect.left)
+        {
+            i = region_find_pt( region, rect.left, region->rects[i].top, NULL ) - 1;
+            continue;
+        }
+        if (region->rects[i].left >= rect.right)
+        {
+            i = region_find_pt( region, rect.left, region->rects[i].bottom, NULL ) - 1;
+            continue;
+        }
         if (!intersect_rect( out, &rect, &region->rects[i] )) continue;
         out++;
         if (out == &clip_rects->buffer[ARRAY_SIZE( clip_rects->buffer )])
@@ -730,6 +743,7 @@ struct windrv_physdev
     struct gdi_physdev     dev;
     struct dibdrv_physdev *dibdrv;
     struct window_surface *surface;
+    RECT                   bounds;  /* bounds of the current drawing operation */
 };
 
 static const struct gdi_dc_funcs window_driver;
@@ -743,13 +757,16 @@ static inline void lock_surface( struct windrv_physdev *dev )
 {
     /* gdi_lock should not be locked */
     dev->surface->funcs->lock( dev->surface );
-    if (IsRectEmpty( dev->dibdrv->bounds ) || dev->surface->draw_start_ticks == 0)
+    if (IsRectEmpty( dev->surface->funcs->get_bounds( dev->surface )) || dev->surface->draw_start_ticks == 0)
         dev->surface->draw_start_ticks = NtGetTickCount();
+    reset_bounds( &dev->bounds );
 }
 
 static inline void unlock_surface( struct windrv_physdev *dev )
 {
     BOOL should_flush = NtGetTickCount() - dev->surface->draw_start_ticks > FLUSH_PERIOD;
+
+    if (!IsRectEmpty( &dev->bounds )) window_surface_add_bounds( dev->surface, &dev->bounds );
     dev->surface->funcs->unlock( dev->surface );
     if (should_flush) dev->surface->funcs->flush( dev->surface );
 }
@@ -790,9 +807,11 @@ void dibdrv_set_window_surface( DC *dc, struct window_surface *surface )
         dibdrv = physdev->dibdrv;
         bits = surface->funcs->get_info( surface, info );
         init_dib_info_from_bitmapinfo( &dibdrv->dib, info, bits );
+        dibdrv->dib.private_bits = TRUE;
         dibdrv->dib.rect = dc->attr->vis_rect;
         OffsetRect( &dibdrv->dib.rect, -dc->device_rect.left, -dc->device_rect.top );
-        dibdrv->bounds = surface->funcs->get_bounds( surface );
+        reset_bounds( &physdev->bounds );
+        dibdrv->bounds = &physdev->bounds;
         DC_InitDC( dc );
     }
     else if (windev)
@@ -25,6 +25,7 @@ typedef struct
     RECT rect;  /* visible rectangle relative to bitmap origin */
     int stride; /* stride in bytes.  Will be -ve for bottom-up dibs (see bits). */
     struct gdi_image_bits bits; /* bits.ptr points to the top-left corner of the dib. */
+    BOOL private_bits;          /* the bits are allocated by gdi and not visible to the app */
 
     DWORD red_mask, green_mask, blue_mask;
     int red_shift, green_shift, blue_shift;
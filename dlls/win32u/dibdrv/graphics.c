@@ -30,6 +30,7 @@
 #include "wine/debug.h"
 
 WINE_DEFAULT_DEBUG_CHANNEL(dib);
+WINE_DECLARE_DEBUG_CHANNEL(glyphcache);
 
 struct cached_glyph
 {
@@ -55,12 +56,30 @@ struct cached_font
     LOGFONTW              lf;
     XFORM                 xform;
     UINT                  aa_flags;
+    LONG64                size;  /* total size of the cached glyphs */
     struct cached_glyph **glyphs[GLYPH_NBTYPES][GLYPH_CACHE_PAGES];
 };
 
-static struct list font_cache = LIST_INIT( font_cache );
+/* The fonts are spread over several independently locked lists, each of them kept
+ * in most-recently used order. Unused fonts are freed once there are too many of
+ * them in a list, or once the glyphs of all the fonts go over the size budget. */
 
-static pthread_mutex_t font_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+#define FONT_CACHE_SHARDS       16
+#define FONT_CACHE_MAX_UNUSED   2     /* unused fonts kept around in each list */
+#define GLYPH_CACHE_MAX_SIZE    (16 * 1024 * 1024)
+
+static struct font_cache_shard
+{
+    pthread_mutex_t lock;
+    struct list     fonts;
+} font_cache[FONT_CACHE_SHARDS];
+
+static pthread_once_t font_cache_once = PTHREAD_ONCE_INIT;
+static LONG64 glyph_cache_size;
+
+/* statistics, reported on the glyphcache channel; the hit counters are only
+ * updated while that channel is enabled, to keep them off the text path */
+static LONG glyph_cache_hits, glyph_cache_misses, font_cache_evictions, font_cache_count;
 
 
 static BOOL brush_rect( dibdrv_physdev *pdev, dib_brush *brush, const RECT *rect, HRGN clip )
@@ -551,10 +570,80 @@ static int font_cache_cmp( const struct cached_font *p1, const struct cached_fon
     return ret;
 }
 
+static void init_font_cache(void)
+{
+    unsigned int i;
+
+    for (i = 0; i < FONT_CACHE_SHARDS; i++)
+    {
+        pthread_mutex_init( &font_cache[i].lock, NULL );
+        list_init( &font_cache[i].fonts );
+    }
+}
+
+static void dump_glyph_cache_stats(void)
+{
+    LONG hits = ReadNoFence( &glyph_cache_hits ), misses = ReadNoFence( &glyph_cache_misses );
+
+    TRACE_(glyphcache)( "%d fonts, %s bytes of glyphs, %d hits, %d misses (%u%% hit rate), %d evictions\n",
+                        (int)ReadNoFence( &font_cache_count ), wine_dbgstr_longlong( glyph_cache_size ),
+                        (int)hits, (int)misses, hits + misses ? (UINT)(hits * 100ull / (hits + misses)) : 0,
+                        (int)ReadNoFence( &font_cache_evictions ) );
+}
+
+/* the caller must hold the shard lock, and the font must be unused */
+static void free_cached_font( struct cached_font *font )
+{
+    UINT i, j, k;
+
+    for (i = 0; i < GLYPH_NBTYPES; i++)
+    {
+        for (j = 0; j < GLYPH_CACHE_PAGES; j++)
+        {
+            if (!font->glyphs[i][j]) continue;
+            for (k = 0; k < GLYPH_CACHE_PAGE_SIZE; k++)
+                free( font->glyphs[i][j][k] );
+            free( font->glyphs[i][j] );
+        }
+    }
+    InterlockedExchangeAdd64( &glyph_cache_size, -font->size );
+    list_remove( &font->entry );
+    free( font );
+    InterlockedDecrement( &font_cache_count );
+    InterlockedIncrement( &font_cache_evictions );
+    if (TRACE_ON(glyphcache)) dump_glyph_cache_stats();
+}
+
+static inline LONG64 get_glyph_cache_size(void)
+{
+    return InterlockedCompareExchange64( &glyph_cache_size, 0, 0 );
+}
+
+/* free the least recently used unused fonts of all the lists while over the size budget */
+static void trim_font_cache(void)
+{
+    struct cached_font *ptr, *next;
+    unsigned int i;
+
+    for (i = 0; i < FONT_CACHE_SHARDS; i++)
+    {
+        if (get_glyph_cache_size() <= GLYPH_CACHE_MAX_SIZE) break;
+
+        pthread_mutex_lock( &font_cache[i].lock );
+        LIST_FOR_EACH_ENTRY_SAFE_REV( ptr, next, &font_cache[i].fonts, struct cached_font, entry )
+        {
+            if (get_glyph_cache_size() <= GLYPH_CACHE_MAX_SIZE) break;
+            if (!ReadNoFence( &ptr->ref )) free_cached_font( ptr );
+        }
+        pthread_mutex_unlock( &font_cache[i].lock );
+    }
+}
+
 static struct cached_font *add_cached_font( DC *dc, HFONT hfont, UINT aa_flags )
 {
-    struct cached_font font, *ptr, *last_unused = NULL;
-    UINT i = 0, j, k;
+    struct cached_font font, *ptr, *next;
+    struct font_cache_shard *shard;
+    UINT unused = 0;
 
     NtGdiExtGetObjectW( hfont, sizeof(font.lf), &font.lf );
     font.xform = dc->xformWorld2Vport;
@@ -569,8 +658,11 @@ static struct cached_font *add_cached_font( DC *dc, HFONT hfont, UINT aa_flags )
     font.aa_flags = aa_flags;
     font.hash = font_cache_hash( &font );
 
-    pthread_mutex_lock( &font_cache_lock );
-    LIST_FOR_EACH_ENTRY( ptr, &font_cache, struct cached_font, entry )
+    pthread_once( &font_cache_once, init_font_cache );
+    shard = &font_cache[font.hash % FONT_CACHE_SHARDS];
+
+    pthread_mutex_lock( &shard->lock );
+    LIST_FOR_EACH_ENTRY( ptr, &shard->fonts, struct cached_font, entry )
     {
         if (!font_cache_cmp( &font, ptr ))
         {
@@ -578,40 +670,32 @@ static struct cached_font *add_cached_font( DC *dc, HFONT hfont, UINT aa_flags )
             list_remove( &ptr->entry );
             goto done;
         }
-        if (!ptr->ref)
-        {
-            i++;
-            last_unused = ptr;
-        }
     }
 
-    if (i > 5)  /* keep at least 5 of the most-recently used fonts around */
-    {
-        ptr = last_unused;
-        for (i = 0; i < GLYPH_NBTYPES; i++)
-        {
-            for (j = 0; j < GLYPH_CACHE_PAGES; j++)
-            {
-                if (!ptr->glyphs[i][j]) continue;
-                for (k = 0; k < GLYPH_CACHE_PAGE_SIZE; k++)
-                    free( ptr->glyphs[i][j][k] );
-                free( ptr->glyphs[i][j] );
-            }
-        }
-        list_remove( &ptr->entry );
-    }
-    else if (!(ptr = malloc( sizeof(*ptr) )))
+    /* keep only the most recently used of the unused fonts,
+     * the references are only taken with the shard lock held */
+    LIST_FOR_EACH_ENTRY_SAFE( ptr, next, &shard->fonts, struct cached_font, entry )
+        if (!ReadNoFence( &ptr->ref ) && ++unused > FONT_CACHE_MAX_UNUSED) free_cached_font( ptr );
+
+    if (!(ptr = malloc( sizeof(*ptr) )))
     {
-        pthread_mutex_unlock( &font_cache_lock );
+        pthread_mutex_unlock( &shard->lock );
         return NULL;
     }
 
     *ptr = font;
     ptr->ref = 1;
+    ptr->size = 0;
     memset( ptr->glyphs, 0, sizeof(ptr->glyphs) );
+    InterlockedIncrement( &font_cache_count );
+    if (TRACE_ON(glyphcache)) dump_glyph_cache_stats();
 done:
-    list_add_head( &font_cache, &ptr->entry );
-    pthread_mutex_unlock( &font_cache_lock );
+    list_add_head( &shard->fonts, &ptr->entry );
+    pthread_mutex_unlock( &shard->lock );
+
+    /* the budget covers all the lists, the locks are never nested */
+    if (get_glyph_cache_size() > GLYPH_CACHE_MAX_SIZE) trim_font_cache();
+
     TRACE( "%d %s -> %p\n", (int)ptr->lf.lfHeight, debugstr_w(ptr->lf.lfFaceName), ptr );
     return ptr;
 }
@@ -622,7 +706,7 @@ void release_cached_font( struct cached_font *font )
 }
 
 static struct cached_glyph *add_cached_glyph( struct cached_font *font, UINT index, UINT flags,
-                                              struct cached_glyph *glyph )
+                                              struct cached_glyph *glyph, DWORD size )
 {
     struct cached_glyph *ret;
     enum glyph_type type = (flags & ETO_GLYPH_INDEX) ? GLYPH_INDEX : GLYPH_WCHAR;
@@ -643,7 +727,13 @@ static struct cached_glyph *add_cached_glyph( struct cached_font *font, UINT ind
             free( ptr );
     }
     ret = InterlockedCompareExchangePointer( (void **)&font->glyphs[type][page][entry], glyph, NULL );
-    if (!ret) ret = glyph;
+    if (!ret)
+    {
+        size = FIELD_OFFSET( struct cached_glyph, bits[size] );
+        InterlockedExchangeAdd64( &font->size, size );
+        InterlockedExchangeAdd64( &glyph_cache_size, size );
+        ret = glyph;
+    }
     else free( glyph );
     return ret;
 }
@@ -804,7 +894,7 @@ static struct cached_glyph *cache_glyph_bitmap( DC *dc, struct cached_font *font
 
 done:
     glyph->metrics = metrics;
-    return add_cached_glyph( font, index, flags, glyph );
+    return add_cached_glyph( font, index, flags, glyph, size );
 }
 
 static void render_string( DC *dc, dib_info *dib, struct cached_font *font, INT x, INT y,
@@ -832,8 +922,9 @@ static void render_string( DC *dc, dib_info *dib, struct cached_font *font, INT
 
     for (i = 0; i < count; i++)
     {
-        if (!(glyph = get_cached_glyph( font, str[i], flags )) &&
-            !(glyph = cache_glyph_bitmap( dc, font, str[i], flags ))) continue;
+        glyph = get_cached_glyph( font, str[i], flags );
+        if (TRACE_ON(glyphcache)) InterlockedIncrement( glyph ? &glyph_cache_hits : &glyph_cache_misses );
+        if (!glyph && !(glyph = cache_glyph_bitmap( dc, font, str[i], flags ))) continue;
 
         glyph_dib.width       = glyph->metrics.gmBlackBoxX;
         glyph_dib.height      = glyph->metrics.gmBlackBoxY;
@@ -23,6 +23,9 @@
 #endif
 
 #include <assert.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 #include "ntgdi_private.h"
 #include "dibdrv.h"
@@ -4682,6 +4685,98 @@ static inline DWORD blend_rgb( BYTE dst_r, BYTE dst_g, BYTE dst_b, DWORD src, BL
             blend_color( dst_r, src >> 16, blend.SourceConstantAlpha ) << 16);
 }
 
+#ifdef __SSE2__
+
+/* (val + 1 + (val >> 8)) >> 8 is equal to val / 255 for all val < 65535 */
+static inline __m128i div255_epu16( __m128i val )
+{
+    return _mm_srli_epi16( _mm_add_epi16( _mm_add_epi16( val, _mm_set1_epi16( 1 ) ),
+                                          _mm_srli_epi16( val, 8 ) ), 8 );
+}
+
+/* same as blend_argb() on two pixels unpacked to 16-bit channels */
+static inline __m128i blend_argb_epi16( __m128i dst, __m128i src )
+{
+    __m128i alpha = _mm_shufflehi_epi16( _mm_shufflelo_epi16( src, 0xff ), 0xff );
+    __m128i val = _mm_mullo_epi16( dst, _mm_sub_epi16( _mm_set1_epi16( 255 ), alpha ));
+
+    return _mm_add_epi16( src, div255_epu16( _mm_add_epi16( val, _mm_set1_epi16( 127 ))));
+}
+
+/* pack the channel sums, the scalar code lets an overflow spill into the next channel */
+static inline __m128i pack_argb_sums( __m128i lo, __m128i hi )
+{
+    __m128i mask = _mm_set1_epi16( 0xff );
+    __m128i val = _mm_packus_epi16( _mm_and_si128( lo, mask ), _mm_and_si128( hi, mask ));
+    __m128i carry = _mm_packus_epi16( _mm_srli_epi16( lo, 8 ), _mm_srli_epi16( hi, 8 ));
+
+    return _mm_or_si128( val, _mm_slli_epi32( carry, 8 ));
+}
+
+/* blend_argb_alpha() four pixels at a time, returns the number of pixels done */
+static inline int blend_row_argb_simd( DWORD *dst, const DWORD *src, int len, DWORD alpha )
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i src_alpha = _mm_set1_epi16( alpha );
+    int x;
+
+    for (x = 0; x + 4 <= len; x += 4)
+    {
+        __m128i s = _mm_loadu_si128( (const __m128i *)(src + x) );
+        __m128i d = _mm_loadu_si128( (const __m128i *)(dst + x) );
+        __m128i s_lo = _mm_unpacklo_epi8( s, zero ), s_hi = _mm_unpackhi_epi8( s, zero );
+
+        if (alpha != 255)
+        {
+            s_lo = div255_epu16( _mm_add_epi16( _mm_mullo_epi16( s_lo, src_alpha ), _mm_set1_epi16( 127 )));
+            s_hi = div255_epu16( _mm_add_epi16( _mm_mullo_epi16( s_hi, src_alpha ), _mm_set1_epi16( 127 )));
+        }
+        _mm_storeu_si128( (__m128i *)(dst + x),
+                          pack_argb_sums( blend_argb_epi16( _mm_unpacklo_epi8( d, zero ), s_lo ),
+                                          blend_argb_epi16( _mm_unpackhi_epi8( d, zero ), s_hi )));
+    }
+    return x;
+}
+
+/* blend_argb_constant_alpha() four pixels at a time, src_mask is or'ed into the source pixels */
+static inline int blend_row_constant_alpha_simd( DWORD *dst, const DWORD *src, int len,
+                                                 DWORD alpha, DWORD src_mask )
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i src_alpha = _mm_set1_epi16( alpha ), dst_alpha = _mm_set1_epi16( 255 - alpha );
+    int x;
+
+    for (x = 0; x + 4 <= len; x += 4)
+    {
+        __m128i s = _mm_or_si128( _mm_loadu_si128( (const __m128i *)(src + x) ), _mm_set1_epi32( src_mask ));
+        __m128i d = _mm_loadu_si128( (const __m128i *)(dst + x) );
+        __m128i lo = _mm_add_epi16( _mm_mullo_epi16( _mm_unpacklo_epi8( s, zero ), src_alpha ),
+                                    _mm_mullo_epi16( _mm_unpacklo_epi8( d, zero ), dst_alpha ));
+        __m128i hi = _mm_add_epi16( _mm_mullo_epi16( _mm_unpackhi_epi8( s, zero ), src_alpha ),
+                                    _mm_mullo_epi16( _mm_unpackhi_epi8( d, zero ), dst_alpha ));
+
+        lo = div255_epu16( _mm_add_epi16( lo, _mm_set1_epi16( 127 )));
+        hi = div255_epu16( _mm_add_epi16( hi, _mm_set1_epi16( 127 )));
+        _mm_storeu_si128( (__m128i *)(dst + x), _mm_packus_epi16( lo, hi ));
+    }
+    return x;
+}
+
+#else  /* __SSE2__ */
+
+static inline int blend_row_argb_simd( DWORD *dst, const DWORD *src, int len, DWORD alpha )
+{
+    return 0;
+}
+
+static inline int blend_row_constant_alpha_simd( DWORD *dst, const DWORD *src, int len,
+                                                 DWORD alpha, DWORD src_mask )
+{
+    return 0;
+}
+
+#endif  /* __SSE2__ */
+
 static void blend_rects_8888(const dib_info *dst, int num, const RECT *rc,
                              const dib_info *src, const POINT *offset, BLENDFUNCTION blend)
 {
@@ -4691,25 +4786,29 @@ static void blend_rects_8888(const dib_info *dst, int num, const RECT *rc,
     {
         DWORD *src_ptr = get_pixel_ptr_32( src, rc->left + offset->x, rc->top + offset->y );
         DWORD *dst_ptr = get_pixel_ptr_32( dst, rc->left, rc->top );
+        int width = rc->right - rc->left;
 
         if (blend.AlphaFormat & AC_SRC_ALPHA)
         {
             if (blend.SourceConstantAlpha == 255)
                 for (y = rc->top; y < rc->bottom; y++, dst_ptr += dst->stride / 4, src_ptr += src->stride / 4)
-                    for (x = 0; x < rc->right - rc->left; x++)
+                    for (x = blend_row_argb_simd( dst_ptr, src_ptr, width, 255 ); x < width; x++)
                         dst_ptr[x] = blend_argb( dst_ptr[x], src_ptr[x] );
             else
                 for (y = rc->top; y < rc->bottom; y++, dst_ptr += dst->stride / 4, src_ptr += src->stride / 4)
-                    for (x = 0; x < rc->right - rc->left; x++)
+                    for (x = blend_row_argb_simd( dst_ptr, src_ptr, width, blend.SourceConstantAlpha );
+                         x < width; x++)
                         dst_ptr[x] = blend_argb_alpha( dst_ptr[x], src_ptr[x], blend.SourceConstantAlpha );
         }
         else if (src->compression == BI_RGB)
             for (y = rc->top; y < rc->bottom; y++, dst_ptr += dst->stride / 4, src_ptr += src->stride / 4)
-                for (x = 0; x < rc->right - rc->left; x++)
+                for (x = blend_row_constant_alpha_simd( dst_ptr, src_ptr, width, blend.SourceConstantAlpha, 0 );
+                     x < width; x++)
                     dst_ptr[x] = blend_argb_constant_alpha( dst_ptr[x], src_ptr[x], blend.SourceConstantAlpha );
         else
             for (y = rc->top; y < rc->bottom; y++, dst_ptr += dst->stride / 4, src_ptr += src->stride / 4)
-                for (x = 0; x < rc->right - rc->left; x++)
+                for (x = blend_row_constant_alpha_simd( dst_ptr, src_ptr, width, blend.SourceConstantAlpha,
+                                                        0xff000000 ); x < width; x++)
                     dst_ptr[x] = blend_argb_no_src_alpha( dst_ptr[x], src_ptr[x], blend.SourceConstantAlpha );
     }
 }
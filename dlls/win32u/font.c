@@ -92,6 +92,7 @@ struct gdi_font_face
     struct gdi_font_family    *family;
     struct gdi_font_enum_data *cached_enum_data;
     struct wine_rb_entry       full_name_entry;
+    struct list                short_name_entry; /* entry in the face_short_name_hash table */
 };
 
 static const struct font_backend_funcs *font_funcs;
@@ -221,6 +222,14 @@ static inline int facename_compare( const WCHAR *str1, const WCHAR *str2, SIZE_T
     return 0;
 }
 
+static inline unsigned int facename_hash( const WCHAR *str, SIZE_T len )
+{
+    unsigned int hash = 0;
+
+    while (len-- && *str) hash = hash * 31 + facename_tolower( *str++ );
+    return hash;
+}
+
   /* Device -> World size conversion */
 
 /* Performs a device to world transformation on the specified width (which
@@ -654,12 +663,25 @@ BOOL reg_delete_tree( HKEY parent, const WCHAR *name, ULONG name_len )
 struct gdi_font_subst
 {
     struct list entry;
+    struct list hash_entry;
     int         from_charset;
     int         to_charset;
     WCHAR       names[1];
 };
 
+/* every family with a localized name adds a substitution, so there can be thousands of them */
+#define FONT_SUBST_HASH_SIZE 256
+
 static struct list font_subst_list = LIST_INIT(font_subst_list);
+static struct list font_subst_hash[FONT_SUBST_HASH_SIZE];
+
+static inline struct list *get_font_subst_bucket( const WCHAR *name )
+{
+    struct list *bucket = &font_subst_hash[facename_hash( name, -1 ) % FONT_SUBST_HASH_SIZE];
+
+    if (!bucket->next) list_init( bucket );
+    return bucket;
+}
 
 static inline WCHAR *get_subst_to_name( struct gdi_font_subst *subst )
 {
@@ -684,7 +706,7 @@ static const WCHAR *get_gdi_font_subst( const WCHAR *from_name, int from_charset
 {
     struct gdi_font_subst *subst;
 
-    LIST_FOR_EACH_ENTRY( subst, &font_subst_list, struct gdi_font_subst, entry )
+    LIST_FOR_EACH_ENTRY( subst, get_font_subst_bucket( from_name ), struct gdi_font_subst, hash_entry )
     {
         if (!facename_compare( subst->names, from_name, -1 ) &&
            (subst->from_charset == from_charset || subst->from_charset == -1))
@@ -710,6 +732,7 @@ static BOOL add_gdi_font_subst( const WCHAR *from_name, int from_charset, const
     subst->from_charset = from_charset;
     subst->to_charset = to_charset;
     list_add_tail( &font_subst_list, &subst->entry );
+    list_add_tail( get_font_subst_bucket( from_name ), &subst->hash_entry );
     return TRUE;
 }
 
@@ -799,6 +822,21 @@ static int face_is_in_full_name_tree( const struct gdi_font_face *face )
     return face->full_name_entry.parent || face_full_name_tree.root == &face->full_name_entry;
 }
 
+/* Faces indexed by the first LF_FACESIZE - 1 characters of their full name, which is what
+ * gets compared against LOGFONT face names. Unlike face_full_name_tree, this contains
+ * bitmap faces and allows duplicates. */
+#define FACE_SHORT_NAME_HASH_SIZE 1024
+
+static struct list face_short_name_hash[FACE_SHORT_NAME_HASH_SIZE];
+
+static inline struct list *get_face_short_name_bucket( const WCHAR *name )
+{
+    struct list *bucket = &face_short_name_hash[facename_hash( name, LF_FACESIZE - 1 ) % FACE_SHORT_NAME_HASH_SIZE];
+
+    if (!bucket->next) list_init( bucket );
+    return bucket;
+}
+
 static struct gdi_font_family *create_family( const WCHAR *name, const WCHAR *second_name )
 {
     struct gdi_font_family *family = malloc( sizeof(*family) );
@@ -1042,6 +1080,7 @@ static void release_face( struct gdi_font_face *face )
     {
         if (face->flags & ADDFONT_ADD_TO_CACHE) remove_face_from_cache( face );
         list_remove( &face->entry );
+        list_remove( &face->short_name_entry );
         release_family( face->family );
     }
     if (face_is_in_full_name_tree( face )) wine_rb_remove( &face_full_name_tree, &face->full_name_entry );
@@ -1136,6 +1175,7 @@ static BOOL insert_face_in_family_list( struct gdi_font_face *face, struct gdi_f
                 TRACE("Replacing original %s with %s\n",
                       debugstr_w(cursor->file), debugstr_w(face->file));
                 list_add_before( &cursor->entry, &face->entry );
+                list_add_tail( get_face_short_name_bucket( face->full_name ), &face->short_name_entry );
                 face->family = family;
                 family->refcount++;
                 face->refcount++;
@@ -1154,6 +1194,7 @@ static BOOL insert_face_in_family_list( struct gdi_font_face *face, struct gdi_f
     TRACE( "Adding face %s in family %s from %s\n", debugstr_w(face->full_name),
            debugstr_w(family->family_name), debugstr_w(face->file) );
     list_add_before( &cursor->entry, &face->entry );
+    list_add_tail( get_face_short_name_bucket( face->full_name ), &face->short_name_entry );
     if (face->scalable) wine_rb_put( &face_full_name_tree, face->full_name, &face->full_name_entry );
     face->family = family;
     family->refcount++;
@@ -1247,168 +1288,270 @@ int add_gdi_face( const WCHAR *family_name, const WCHAR *second_name,
 
 /* font cache */
 
+/* The cache holds all the faces added through AddFontResource so that other processes
+ * don't need to rescan them. It is stored as a single binary value in the volatile cache
+ * key, as a sequence of variable-size records, so that loading it takes one registry
+ * request instead of enumerating a key per family and per bitmap strike. */
+
 struct cached_face
 {
+    DWORD                   record_size;
     DWORD                   index;
     DWORD                   flags;
     DWORD                   ntmflags;
     DWORD                   version;
+    DWORD                   scalable;
     struct bitmap_font_size size;
     FONTSIGNATURE           fs;
-    WCHAR                   full_name[1];
-    /* WCHAR                file_name[]; */
+    WCHAR                   names[1];
+    /* family name, second name, style name, full name and file name, all nul-terminated */
 };
 
-static void load_face_from_cache( HKEY hkey_family, struct gdi_font_family *family,
-                                  void *buffer, DWORD buffer_size, BOOL scalable )
+enum cached_face_name
 {
-    KEY_VALUE_FULL_INFORMATION *info = (KEY_VALUE_FULL_INFORMATION *)buffer;
-    KEY_NODE_INFORMATION *node_info = (KEY_NODE_INFORMATION *)buffer;
-    DWORD index = 0, total_size;
-    struct gdi_font_face *face;
-    HKEY hkey_strike;
-    WCHAR name[256];
-    struct cached_face *cached;
+    CACHED_FAMILY_NAME,
+    CACHED_SECOND_NAME,
+    CACHED_STYLE_NAME,
+    CACHED_FULL_NAME,
+    CACHED_FILE_NAME,
+    CACHED_NAME_COUNT
+};
+
+static const WCHAR cached_facesW[] = {'F','a','c','e','s',0};
+static HANDLE font_cache_mutex;
 
-    while (reg_enum_value( hkey_family, index++, info,
-                           buffer_size - sizeof(DWORD), name, sizeof(name) ))
+/* cache contents while the mutex is held, written back once it is released */
+static char *font_cache_data;
+static DWORD font_cache_size;
+static UINT font_cache_lock_count;
+static BOOL font_cache_dirty;
+
+static void *read_font_cache( DWORD *size )
+{
+    UNICODE_STRING nameW = RTL_CONSTANT_STRING( cached_facesW );
+    KEY_VALUE_PARTIAL_INFORMATION *info = NULL;
+    ULONG info_size = 4096;
+    NTSTATUS status;
+    void *ret;
+
+    *size = 0;
+    do
     {
-        cached = (struct cached_face *)((char *)info + info->DataOffset);
-        if (info->Type == REG_BINARY && info->DataLength > sizeof(*cached))
-        {
-            ((DWORD *)cached)[info->DataLength / sizeof(DWORD)] = 0;
-            if ((face = create_face( family, name, cached->full_name,
-                                     cached->full_name + lstrlenW(cached->full_name) + 1,
-                                     NULL, 0, cached->index, cached->fs, cached->ntmflags, cached->version,
-                                     cached->flags, scalable ? NULL : &cached->size )))
-            {
-                if (!scalable)
-                    TRACE("Adding bitmap size h %d w %d size %d x_ppem %d y_ppem %d\n",
-                          face->size.height, face->size.width, face->size.size >> 6,
-                          face->size.x_ppem >> 6, face->size.y_ppem >> 6);
+        free( info );
+        if (!(info = malloc( info_size ))) return NULL;
+        status = NtQueryValueKey( wine_fonts_cache_key, &nameW, KeyValuePartialInformation,
+                                  info, info_size, &info_size );
+    } while (status == STATUS_BUFFER_OVERFLOW);
 
-                TRACE("fsCsb = %08x %08x/%08x %08x %08x %08x\n",
-                      (int)face->fs.fsCsb[0], (int)face->fs.fsCsb[1],
-                      (int)face->fs.fsUsb[0], (int)face->fs.fsUsb[1],
-                      (int)face->fs.fsUsb[2], (int)face->fs.fsUsb[3]);
+    if (status || info->Type != REG_BINARY)
+    {
+        free( info );
+        return NULL;
+    }
+    *size = info->DataLength;
+    ret = info;
+    memmove( ret, info->Data, *size );
+    return ret;
+}
 
-                release_face( face );
-            }
-        }
+static void write_font_cache( const void *data, DWORD size )
+{
+    if (size) set_reg_value( wine_fonts_cache_key, cached_facesW, REG_BINARY, data, size );
+    else reg_delete_value( wine_fonts_cache_key, cached_facesW );
+}
+
+/* Acquire the cache mutex and load the cache data. Calls can be nested, so that
+ * the faces added while enumerating many fonts are only written out once. */
+static void lock_font_cache(void)
+{
+    NtWaitForSingleObject( font_cache_mutex, FALSE, NULL );
+    if (font_cache_lock_count++) return;
+    font_cache_data = read_font_cache( &font_cache_size );
+    font_cache_dirty = FALSE;
+}
+
+static void unlock_font_cache(void)
+{
+    if (!--font_cache_lock_count)
+    {
+        if (font_cache_dirty) write_font_cache( font_cache_data, font_cache_size );
+        free( font_cache_data );
+        font_cache_data = NULL;
+        font_cache_size = 0;
     }
+    NtReleaseMutant( font_cache_mutex, NULL );
+}
 
-    /* load bitmap strikes */
+/* validate the record at offset pos and return its names, or NULL when the data is truncated */
+static const struct cached_face *get_cached_face( const char *data, DWORD size, DWORD pos,
+                                                  const WCHAR *names[CACHED_NAME_COUNT] )
+{
+    const struct cached_face *cached = (const struct cached_face *)(data + pos);
+    const WCHAR *ptr, *end;
+    unsigned int i;
 
-    index = 0;
-    while (!NtEnumerateKey( hkey_family, index++, KeyNodeInformation, node_info,
-                            buffer_size, &total_size ))
+    if (size - pos < offsetof( struct cached_face, names )) return NULL;
+    if (cached->record_size < offsetof( struct cached_face, names ) ||
+        cached->record_size > size - pos || cached->record_size % sizeof(DWORD))
+        return NULL;
+
+    ptr = cached->names;
+    end = (const WCHAR *)((const char *)cached + cached->record_size);
+    for (i = 0; i < CACHED_NAME_COUNT; i++)
     {
-        if ((hkey_strike = reg_open_key( hkey_family, node_info->Name, node_info->NameLength )))
+        names[i] = ptr;
+        while (ptr < end && *ptr) ptr++;
+        if (ptr++ >= end) return NULL;
+    }
+    return cached;
+}
+
+/* faces are identified by their family and style names, and their height for bitmap fonts */
+static BOOL cached_face_matches( const struct cached_face *cached, const WCHAR *names[CACHED_NAME_COUNT],
+                                 const struct gdi_font_face *face )
+{
+    if (!cached->scalable != !face->scalable) return FALSE;
+    if (!face->scalable && cached->size.y_ppem != face->size.y_ppem) return FALSE;
+    return !wcsicmp( names[CACHED_FAMILY_NAME], face->family->family_name ) &&
+           !wcsicmp( names[CACHED_STYLE_NAME], face->style_name );
+}
+
+/* remove the record for face from the cache data, return the new data size */
+static DWORD remove_cached_face( char *data, DWORD size, const struct gdi_font_face *face )
+{
+    const struct cached_face *cached;
+    const WCHAR *names[CACHED_NAME_COUNT];
+    DWORD pos = 0;
+
+    while ((cached = get_cached_face( data, size, pos, names )))
+    {
+        if (cached_face_matches( cached, names, face ))
         {
-            load_face_from_cache( hkey_strike, family, buffer, buffer_size, FALSE );
-            NtClose( hkey_strike );
+            DWORD record_size = cached->record_size;
+            memmove( data + pos, data + pos + record_size, size - pos - record_size );
+            return size - record_size;
         }
+        pos += cached->record_size;
     }
+    return pos;  /* drop any trailing garbage */
 }
 
 static void load_font_list_from_cache(void)
 {
-    WCHAR buffer[4096];
-    KEY_VALUE_PARTIAL_INFORMATION *info = (void *)buffer;
-    KEY_NODE_INFORMATION *enum_info = (KEY_NODE_INFORMATION *)buffer;
-    DWORD family_index = 0, total_size;
+    const struct cached_face *cached;
+    const WCHAR *names[CACHED_NAME_COUNT];
     struct gdi_font_family *family;
-    HKEY hkey_family;
-    WCHAR *second_name = (WCHAR *)info->Data;
+    struct gdi_font_face *face;
+    DWORD size, pos = 0;
+    char *data;
+
+    if (!(data = read_font_cache( &size ))) return;
 
-    while (!NtEnumerateKey( wine_fonts_cache_key, family_index++, KeyNodeInformation, enum_info,
-                            sizeof(buffer), &total_size ))
+    while ((cached = get_cached_face( data, size, pos, names )))
     {
-        if (!(hkey_family = reg_open_key( wine_fonts_cache_key, enum_info->Name,
-                                          enum_info->NameLength )))
-            continue;
-        TRACE( "opened family key %s\n", debugstr_wn(enum_info->Name, enum_info->NameLength / sizeof(WCHAR)) );
-        if (!query_reg_value( hkey_family, NULL, info, sizeof(buffer) ))
-            second_name[0] = 0;
+        pos += cached->record_size;
 
-        family = create_family( buffer, second_name );
+        if ((family = find_family_from_name( names[CACHED_FAMILY_NAME] ))) family->refcount++;
+        else family = create_family( names[CACHED_FAMILY_NAME], names[CACHED_SECOND_NAME] );
 
-        load_face_from_cache( hkey_family, family, buffer, sizeof(buffer), TRUE );
+        if ((face = create_face( family, names[CACHED_STYLE_NAME], names[CACHED_FULL_NAME],
+                                 names[CACHED_FILE_NAME], NULL, 0, cached->index, cached->fs,
+                                 cached->ntmflags, cached->version, cached->flags,
+                                 cached->scalable ? NULL : &cached->size )))
+        {
+            if (!face->scalable)
+                TRACE("Adding bitmap size h %d w %d size %d x_ppem %d y_ppem %d\n",
+                      face->size.height, face->size.width, face->size.size >> 6,
+                      face->size.x_ppem >> 6, face->size.y_ppem >> 6);
+
+            TRACE("fsCsb = %08x %08x/%08x %08x %08x %08x\n",
+                  (int)face->fs.fsCsb[0], (int)face->fs.fsCsb[1],
+                  (int)face->fs.fsUsb[0], (int)face->fs.fsUsb[1],
+                  (int)face->fs.fsUsb[2], (int)face->fs.fsUsb[3]);
 
-        NtClose( hkey_family );
+            release_face( face );
+        }
         release_family( family );
     }
+    if (pos < size) WARN( "ignoring %u bytes of invalid cache data\n", (int)(size - pos) );
+    free( data );
 }
 
 static void add_face_to_cache( struct gdi_font_face *face )
 {
-    HKEY hkey_family, hkey_face;
-    DWORD len, buffer[1024];
-    struct cached_face *cached = (struct cached_face *)buffer;
+    static const WCHAR emptyW[] = {0};
+    const WCHAR *names[CACHED_NAME_COUNT];
+    struct cached_face *cached;
+    DWORD size, record_size, len[CACHED_NAME_COUNT];
+    WCHAR *ptr;
+    char *data;
+    unsigned int i;
 
-    if (!(hkey_family = reg_create_key( wine_fonts_cache_key, face->family->family_name,
-                                        lstrlenW( face->family->family_name ) * sizeof(WCHAR),
-                                        REG_OPTION_VOLATILE, NULL )))
-        return;
+    if (!font_cache_mutex) return;
 
-    if (face->family->second_name[0])
-        set_reg_value( hkey_family, NULL, REG_SZ, face->family->second_name,
-                       (lstrlenW( face->family->second_name ) + 1) * sizeof(WCHAR) );
+    names[CACHED_FAMILY_NAME] = face->family->family_name;
+    names[CACHED_SECOND_NAME] = face->family->second_name;
+    names[CACHED_STYLE_NAME]  = face->style_name;
+    names[CACHED_FULL_NAME]   = face->full_name;
+    names[CACHED_FILE_NAME]   = face->file ? face->file : emptyW;
 
-    if (!face->scalable)
+    record_size = offsetof( struct cached_face, names );
+    for (i = 0; i < CACHED_NAME_COUNT; i++)
     {
-        WCHAR nameW[10];
-        char name[10];
-
-        sprintf( name, "%d", face->size.y_ppem );
-        hkey_face = reg_create_key( hkey_family, nameW,
-                                    asciiz_to_unicode( nameW, name ) - sizeof(WCHAR),
-                                    REG_OPTION_VOLATILE, NULL );
+        len[i] = lstrlenW( names[i] ) + 1;
+        record_size += len[i] * sizeof(WCHAR);
     }
-    else hkey_face = hkey_family;
+    record_size = (record_size + sizeof(DWORD) - 1) & ~(sizeof(DWORD) - 1);
 
-    memset( cached, 0, sizeof(*cached) );
-    cached->index = face->face_index;
-    cached->flags = face->flags;
-    cached->ntmflags = face->ntmFlags;
-    cached->version = face->version;
-    cached->fs = face->fs;
-    if (!face->scalable) cached->size = face->size;
-    lstrcpyW( cached->full_name, face->full_name );
-    len = lstrlenW( face->full_name ) + 1;
-    lstrcpyW( cached->full_name + len, face->file );
-    len += lstrlenW( face->file ) + 1;
+    lock_font_cache();
 
-    set_reg_value( hkey_face, face->style_name, REG_BINARY, cached,
-                   offsetof( struct cached_face, full_name[len] ));
+    size = font_cache_data ? remove_cached_face( font_cache_data, font_cache_size, face ) : 0;
+    if (size != font_cache_size)
+    {
+        font_cache_size = size;
+        font_cache_dirty = TRUE;
+    }
 
-    if (hkey_face != hkey_family) NtClose( hkey_face );
-    NtClose( hkey_family );
+    if ((data = realloc( font_cache_data, size + record_size )))
+    {
+        cached = (struct cached_face *)(data + size);
+        memset( cached, 0, record_size );
+        cached->record_size = record_size;
+        cached->index = face->face_index;
+        cached->flags = face->flags;
+        cached->ntmflags = face->ntmFlags;
+        cached->version = face->version;
+        cached->scalable = face->scalable;
+        cached->fs = face->fs;
+        if (!face->scalable) cached->size = face->size;
+        ptr = cached->names;
+        for (i = 0; i < CACHED_NAME_COUNT; i++)
+        {
+            memcpy( ptr, names[i], len[i] * sizeof(WCHAR) );
+            ptr += len[i];
+        }
+        font_cache_data = data;
+        font_cache_size = size + record_size;
+        font_cache_dirty = TRUE;
+    }
+
+    unlock_font_cache();
 }
 
 static void remove_face_from_cache( struct gdi_font_face *face )
 {
-    HKEY hkey_family, hkey;
+    DWORD size;
 
-    if (!(hkey_family = reg_open_key( wine_fonts_cache_key, face->family->family_name,
-                                      lstrlenW( face->family->family_name ) * sizeof(WCHAR) )))
-        return;
+    if (!font_cache_mutex) return;
 
-    if (!face->scalable)
+    lock_font_cache();
+    if (font_cache_data &&
+        (size = remove_cached_face( font_cache_data, font_cache_size, face )) != font_cache_size)
     {
-        WCHAR nameW[10];
-        char name[10];
-        sprintf( name, "%d", face->size.y_ppem );
-        if ((hkey = reg_open_key( hkey_family, nameW,
-                                  asciiz_to_unicode( nameW, name ) - sizeof(WCHAR) )))
-        {
-            NtDeleteKey( hkey );
-            NtClose( hkey );
-        }
+        font_cache_size = size;
+        font_cache_dirty = TRUE;
     }
-    else reg_delete_value( hkey_family, face->style_name );
-
-    NtClose( hkey_family );
+    unlock_font_cache();
 }
 
 /* font links */
@@ -2172,6 +2315,33 @@ static struct gdi_font_face *find_best_matching_face( const struct gdi_font_fami
     return best->scalable ? best : best_bitmap;
 }
 
+/* find a face whose full name matches a LOGFONT face name, in font list order */
+static struct gdi_font_face *find_face_from_short_name( const WCHAR *name, FONTSIGNATURE fs,
+                                                        BOOL can_use_bitmap )
+{
+    struct gdi_font_family *family;
+    struct gdi_font_face *face, *found = NULL;
+
+    LIST_FOR_EACH_ENTRY( face, get_face_short_name_bucket( name ), struct gdi_font_face, short_name_entry )
+    {
+        if (facename_compare( face->full_name, name, LF_FACESIZE - 1 )) continue;
+        /* faces of a replaced family are hidden, and the order of several matching
+         * faces depends on the family tree, so let the full scan handle these */
+        if (found || face->family->replacement) goto full_scan;
+        found = face;
+    }
+    if (!found || !can_select_face( found, fs, can_use_bitmap )) return NULL;
+    return found;
+
+full_scan:
+    WINE_RB_FOR_EACH_ENTRY( family, &family_name_tree, struct gdi_font_family, name_entry )
+        LIST_FOR_EACH_ENTRY( face, get_family_face_list(family), struct gdi_font_face, entry )
+            if (!facename_compare( face->full_name, name, LF_FACESIZE - 1 ) &&
+                can_select_face( face, fs, can_use_bitmap ))
+                return face;
+    return NULL;
+}
+
 static struct gdi_font_face *find_matching_face_by_name( const WCHAR *name, const WCHAR *subst,
                                                          const LOGFONTW *lf, FONTSIGNATURE fs,
                                                          BOOL can_use_bitmap, const WCHAR **orig_name )
@@ -2188,11 +2358,7 @@ static struct gdi_font_face *find_matching_face_by_name( const WCHAR *name, cons
     }
 
     /* search by full face name */
-    WINE_RB_FOR_EACH_ENTRY( family, &family_name_tree, struct gdi_font_family, name_entry )
-        LIST_FOR_EACH_ENTRY( face, get_family_face_list(family), struct gdi_font_face, entry )
-            if (!facename_compare( face->full_name, name, LF_FACESIZE - 1 ) &&
-                can_select_face( face, fs, can_use_bitmap ))
-                return face;
+    if ((face = find_face_from_short_name( name, fs, can_use_bitmap ))) return face;
 
     if ((family = find_family_from_font_links( name, subst, fs )))
     {
@@ -2883,7 +3049,9 @@ static void create_child_font_list( struct gdi_font *font )
 
 /* font cache */
 
-static struct list gdi_font_list = LIST_INIT( gdi_font_list );
+#define GDI_FONT_HASH_SIZE 256
+
+static struct list gdi_font_hash[GDI_FONT_HASH_SIZE];
 static struct list unused_gdi_font_list = LIST_INIT( unused_gdi_font_list );
 static unsigned int unused_font_count;
 #define UNUSED_CACHE_SIZE 10
@@ -2923,13 +3091,21 @@ static DWORD hash_font( const LOGFONTW *lf, const FMAT2 *matrix, BOOL can_use_bi
     return hash;
 }
 
+static struct list *get_gdi_font_bucket( DWORD hash )
+{
+    struct list *bucket = &gdi_font_hash[(hash ^ (hash >> 8) ^ (hash >> 16) ^ (hash >> 24)) % GDI_FONT_HASH_SIZE];
+
+    if (!bucket->next) list_init( bucket );
+    return bucket;
+}
+
 static void cache_gdi_font( struct gdi_font *font )
 {
     static DWORD cache_num = 1;
 
     font->cache_num = cache_num++;
     font->hash = hash_font( &font->lf, &font->matrix, font->can_use_bitmap );
-    list_add_head( &gdi_font_list, &font->entry );
+    list_add_head( get_gdi_font_bucket( font->hash ), &font->entry );
     TRACE( "font %p\n", font );
 }
 
@@ -2937,13 +3113,14 @@ static struct gdi_font *find_cached_gdi_font( const LOGFONTW *lf, const FMAT2 *m
 {
     struct gdi_font *font;
     DWORD hash = hash_font( lf, matrix, can_use_bitmap );
+    struct list *bucket = get_gdi_font_bucket( hash );
 
     /* try the in-use list */
-    LIST_FOR_EACH_ENTRY( font, &gdi_font_list, struct gdi_font, entry )
+    LIST_FOR_EACH_ENTRY( font, bucket, struct gdi_font, entry )
     {
         if (fontcmp( font, hash, lf, matrix, can_use_bitmap )) continue;
         list_remove( &font->entry );
-        list_add_head( &gdi_font_list, &font->entry );
+        list_add_head( bucket, &font->entry );
         if (!font->refcount++)
         {
             list_remove( &font->unused_entry );
@@ -6776,7 +6953,6 @@ UINT font_init(void)
 {
     OBJECT_ATTRIBUTES attr = { sizeof(attr) };
     UNICODE_STRING name;
-    HANDLE mutex;
     DWORD disposition;
     UINT dpi = 0;
 
@@ -6805,23 +6981,27 @@ UINT font_init(void)
     name.Buffer = wine_font_mutexW;
     name.Length = name.MaximumLength = sizeof(wine_font_mutexW);
 
-    if (NtCreateMutant( &mutex, MUTEX_ALL_ACCESS, &attr, FALSE ) < 0) return dpi;
-    NtWaitForSingleObject( mutex, FALSE, NULL );
+    if (NtCreateMutant( &font_cache_mutex, MUTEX_ALL_ACCESS, &attr, FALSE ) < 0) return dpi;
+    NtWaitForSingleObject( font_cache_mutex, FALSE, NULL );
 
     wine_fonts_cache_key = reg_create_key( wine_fonts_key, cacheW, sizeof(cacheW),
                                            REG_OPTION_VOLATILE, &disposition );
 
     if (disposition == REG_CREATED_NEW_KEY)
     {
+        lock_font_cache();
         load_registry_fonts();
         update_external_font_keys();
+        unlock_font_cache();
     }
 
-    NtReleaseMutant( mutex, NULL );
+    NtReleaseMutant( font_cache_mutex, NULL );
 
     if (disposition != REG_CREATED_NEW_KEY)
     {
+        lock_font_cache();
         load_registry_fonts();
+        unlock_font_cache();
         load_font_list_from_cache();
     }
 
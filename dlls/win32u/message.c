@@ -57,6 +57,17 @@ struct received_message_info
     struct received_message_info *prev;
 };
 
+#define MAX_PREFETCHED_MESSAGES_AGE 1000  /* ms, well below the server hung queue timeout */
+
+/* posted messages already removed from the server queue, in queue order */
+struct prefetched_messages
+{
+    const volatile queue_shm_t *shm;  /* queue state, NULL if it couldn't be mapped */
+    DWORD            time;  /* tick count of the get_message request that returned them */
+    UINT             count;
+    posted_message_t msgs[MAX_PREFETCHED_MESSAGES];
+};
+
 struct packed_hook_extra_info
 {
     user_handle_t handle;
@@ -2679,6 +2690,134 @@ static BOOL process_hardware_message( MSG *msg, UINT hw_id, const struct hardwar
     return ret;
 }
 
+/***********************************************************************
+ *           match_prefetched_window
+ *
+ * Check if a prefetched message window matches a window filter, the same way the server does.
+ */
+static BOOL match_prefetched_window( HWND filter, HWND hwnd )
+{
+    HWND parent;
+
+    if (!filter) return TRUE;
+    if (filter == HWND_TOPMOST || filter == HWND_BOTTOM) return !hwnd;
+    if (!hwnd) return FALSE;
+    if (hwnd == filter) return TRUE;
+    for (parent = NtUserGetAncestor( hwnd, GA_PARENT ); parent; parent = NtUserGetAncestor( parent, GA_PARENT ))
+        if (parent == filter) return TRUE;
+    return FALSE;
+}
+
+/***********************************************************************
+ *           alloc_prefetched_messages
+ *
+ * Allocate the prefetch buffer and map the queue state that tells if it can be used.
+ */
+static struct prefetched_messages *alloc_prefetched_messages(void)
+{
+    struct prefetched_messages *prefetched;
+    HANDLE section = 0;
+    SIZE_T size = 0;
+    void *ptr = NULL;
+
+    SERVER_START_REQ( get_queue_shm )
+    {
+        if (!wine_server_call( req )) section = wine_server_ptr_handle( reply->handle );
+    }
+    SERVER_END_REQ;
+    if (section)
+    {
+        if (NtMapViewOfSection( section, GetCurrentProcess(), &ptr, 0, 0, NULL,
+                                &size, ViewShare, 0, PAGE_READONLY ))
+            ptr = NULL;
+        NtClose( section );
+    }
+    if (!ptr) WARN( "failed to map the queue state, not prefetching messages\n" );
+
+    /* failures are remembered as well, messages are then always retrieved from the server */
+    if (!(prefetched = calloc( 1, sizeof(*prefetched) )))
+    {
+        if (ptr) NtUnmapViewOfSection( GetCurrentProcess(), ptr );
+        return NULL;
+    }
+    prefetched->shm = ptr;
+    return prefetched;
+}
+
+/***********************************************************************
+ *           free_prefetched_messages
+ */
+void free_prefetched_messages(void)
+{
+    struct user_thread_info *thread_info = get_user_thread_info();
+    struct prefetched_messages *prefetched = thread_info->prefetched;
+
+    if (!prefetched) return;
+    if (prefetched->shm) NtUnmapViewOfSection( GetCurrentProcess(), (void *)prefetched->shm );
+    free( prefetched );
+    thread_info->prefetched = NULL;
+}
+
+/***********************************************************************
+ *           get_prefetched_message
+ *
+ * Retrieve a posted message from the ones prefetched by a previous get_message request.
+ * These are the oldest posted messages of the queue, so they have to be checked first,
+ * but only once all the pending sent messages have been processed by the server.
+ */
+static BOOL get_prefetched_message( struct received_message_info *info, HWND hwnd,
+                                    UINT first, UINT last, UINT flags )
+{
+    struct prefetched_messages *prefetched = get_user_thread_info()->prefetched;
+    const posted_message_t *data;
+    UINT i = 0;
+
+    if (!prefetched || !prefetched->count) return FALSE;
+    if (prefetched->shm->wake_bits & QS_SENDMESSAGE) return FALSE;
+    /* the server only sees the queue being checked on get_message requests, go
+     * back to it regularly so that it doesn't consider the thread hung */
+    if (NtGetTickCount() - prefetched->time > MAX_PREFETCHED_MESSAGES_AGE) return FALSE;
+    if (HIWORD(flags) && !(HIWORD(flags) & QS_POSTMESSAGE)) return FALSE;
+    if (hwnd && hwnd != HWND_TOPMOST && hwnd != HWND_BOTTOM)
+    {
+        /* let the server report invalid window filters */
+        if (!is_window( hwnd )) return FALSE;
+        hwnd = get_full_window_handle( hwnd );
+    }
+
+    while (i < prefetched->count)
+    {
+        HWND win;
+
+        data = &prefetched->msgs[i];
+        win = wine_server_ptr_handle( data->win );
+        if (win && !is_window( win ))
+        {
+            /* the window has been destroyed since, drop the message like the server would have */
+            memmove( &prefetched->msgs[i], &prefetched->msgs[i + 1],
+                     (--prefetched->count - i) * sizeof(*data) );
+            continue;
+        }
+        if (data->msg >= first && data->msg <= last && match_prefetched_window( hwnd, win )) break;
+        i++;
+    }
+    if (i == prefetched->count) return FALSE;
+
+    info->type        = MSG_POSTED;
+    info->msg.hwnd    = wine_server_ptr_handle( data->win );
+    info->msg.message = data->msg;
+    info->msg.wParam  = data->wparam;
+    info->msg.lParam  = data->lparam;
+    info->msg.time    = data->time;
+    info->msg.pt.x    = data->x;
+    info->msg.pt.y    = data->y;
+
+    if (flags & PM_REMOVE)
+        memmove( &prefetched->msgs[i], &prefetched->msgs[i + 1],
+                 (--prefetched->count - i) * sizeof(*data) );
+    return TRUE;
+}
+
 /***********************************************************************
  *           peek_message
  *
@@ -2709,33 +2848,61 @@ static int peek_message( MSG *msg, HWND hwnd, UINT first, UINT last, UINT flags,
 
         thread_info->client_info.msg_source = prev_source;
 
-        SERVER_START_REQ( get_message )
+        if (get_prefetched_message( &info, hwnd, first, last, flags )) res = STATUS_SUCCESS;
+        else
         {
-            req->flags     = flags;
-            req->get_win   = wine_server_user_handle( hwnd );
-            req->get_first = first;
-            req->get_last  = last;
-            req->hw_id     = hw_id;
-            req->wake_mask = changed_mask & (QS_SENDMESSAGE | QS_SMRESULT);
-            req->changed_mask = changed_mask;
-            wine_server_set_reply( req, buffer, buffer_size );
-            if (!(res = wine_server_call( req )))
+            struct prefetched_messages *prefetched = thread_info->prefetched;
+            UINT prefetch = 0;
+
+            if ((flags & PM_REMOVE) && (!HIWORD(flags) || (HIWORD(flags) & QS_POSTMESSAGE)))
+            {
+                if (!prefetched) prefetched = thread_info->prefetched = alloc_prefetched_messages();
+                if (prefetched && prefetched->shm) prefetch = ARRAY_SIZE(prefetched->msgs);
+            }
+
+            SERVER_START_REQ( get_message )
             {
-                size = wine_server_reply_size( reply );
-                info.type        = reply->type;
-                info.msg.hwnd    = wine_server_ptr_handle( reply->win );
-                info.msg.message = reply->msg;
-                info.msg.wParam  = reply->wparam;
-                info.msg.lParam  = reply->lparam;
-                info.msg.time    = reply->time;
-                info.msg.pt.x    = reply->x;
-                info.msg.pt.y    = reply->y;
-                hw_id            = 0;
-                thread_info->active_hooks = reply->active_hooks;
+                req->flags     = flags;
+                req->get_win   = wine_server_user_handle( hwnd );
+                req->get_first = first;
+                req->get_last  = last;
+                req->hw_id     = hw_id;
+                req->wake_mask = changed_mask & (QS_SENDMESSAGE | QS_SMRESULT);
+                req->changed_mask = changed_mask;
+                req->prefetch  = prefetch;
+                /* give back the prefetched messages that can't be used for this call, the
+                 * server puts them in front of its queue again and applies the filters */
+                if (prefetched && prefetched->count)
+                {
+                    wine_server_add_data( req, prefetched->msgs, prefetched->count * sizeof(*prefetched->msgs) );
+                    prefetched->count = 0;
+                }
+                wine_server_set_reply( req, buffer, buffer_size );
+                if (!(res = wine_server_call( req )))
+                {
+                    size = wine_server_reply_size( reply );
+                    info.type        = reply->type;
+                    info.msg.hwnd    = wine_server_ptr_handle( reply->win );
+                    info.msg.message = reply->msg;
+                    info.msg.wParam  = reply->wparam;
+                    info.msg.lParam  = reply->lparam;
+                    info.msg.time    = reply->time;
+                    info.msg.pt.x    = reply->x;
+                    info.msg.pt.y    = reply->y;
+                    hw_id            = 0;
+                    thread_info->active_hooks = reply->active_hooks;
+                    if (reply->prefetched && size == reply->prefetched * sizeof(posted_message_t))
+                    {
+                        memcpy( prefetched->msgs, buffer, size );
+                        prefetched->count = reply->prefetched;
+                        prefetched->time  = NtGetTickCount();
+                        size = 0;
+                    }
+                }
+                else buffer_size = reply->total;
             }
-            else buffer_size = reply->total;
+            SERVER_END_REQ;
         }
-        SERVER_END_REQ;
 
         if (res)
         {
@@ -3326,16 +3493,52 @@ done:
     return !res;
 }
 
+/***********************************************************************
+ *           get_message_reply
+ *
+ * Get a message reply from the server. Returns STATUS_PENDING if the reply isn't
+ * ready yet, in which case the message is cancelled if requested.
+ */
+static unsigned int get_message_reply( const struct send_message_info *info, void *reply_data,
+                                       size_t reply_size, BOOL cancel, LRESULT *result )
+{
+    unsigned int status;
+
+    SERVER_START_REQ( get_message_reply )
+    {
+        req->cancel = cancel;
+        if (reply_size) wine_server_set_reply( req, reply_data, reply_size );
+        if (!(status = wine_server_call( req ))) *result = reply->result;
+        reply_size = wine_server_reply_size( reply );
+    }
+    SERVER_END_REQ;
+    if (!status && reply_size)
+        unpack_reply( info->hwnd, info->msg, info->wparam, info->lparam, reply_data, reply_size );
+    return status;
+}
+
 /***********************************************************************
  *           wait_message_reply
  *
- * Wait until a sent message gets replied to.
+ * Wait until a sent message gets replied to, and retrieve the reply.
  */
-static void wait_message_reply( UINT flags )
+static LRESULT wait_message_reply( const struct send_message_info *info, size_t reply_size,
+                                   LRESULT *result )
 {
     struct user_thread_info *thread_info = get_user_thread_info();
     HANDLE server_queue = get_server_queue_handle();
-    unsigned int wake_mask = QS_SMRESULT | ((flags & SMTO_BLOCK) ? 0 : QS_SENDMESSAGE);
+    unsigned int wake_mask = QS_SMRESULT | ((info->flags & SMTO_BLOCK) ? 0 : QS_SENDMESSAGE);
+    unsigned int status = STATUS_PENDING;
+    void *reply_data = NULL;
+
+    if (reply_size)
+    {
+        if (!(reply_data = malloc( reply_size )))
+        {
+            WARN( "no memory for reply, will be truncated\n" );
+            reply_size = 0;
+        }
+    }
 
     for (;;)
     {
@@ -3352,7 +3555,7 @@ static void wait_message_reply( UINT flags )
 
         thread_info->wake_mask = thread_info->changed_mask = 0;
 
-        if (wake_bits & QS_SMRESULT) return;  /* got a result */
+        if (wake_bits & QS_SMRESULT) break;  /* got a result */
         if (wake_bits & QS_SENDMESSAGE)
         {
             /* Process the sent message immediately */
@@ -3361,38 +3564,15 @@ static void wait_message_reply( UINT flags )
         }
 
         wait_message( 1, &server_queue, INFINITE, wake_mask, 0 );
-    }
-}
-
-/***********************************************************************
- *           retrieve_reply
- *
- * Retrieve a message reply from the server.
- */
-static LRESULT retrieve_reply( const struct send_message_info *info,
-                               size_t reply_size, LRESULT *result )
-{
-    unsigned int status;
-    void *reply_data = NULL;
 
-    if (reply_size)
-    {
-        if (!(reply_data = malloc( reply_size )))
-        {
-            WARN( "no memory for reply, will be truncated\n" );
-            reply_size = 0;
-        }
-    }
-    SERVER_START_REQ( get_message_reply )
-    {
-        req->cancel = 1;
-        if (reply_size) wine_server_set_reply( req, reply_data, reply_size );
-        if (!(status = wine_server_call( req ))) *result = reply->result;
-        reply_size = wine_server_reply_size( reply );
+        /* we are usually woken up by the reply itself, so try to fetch it right
+         * away instead of querying the queue bits first */
+        status = get_message_reply( info, reply_data, reply_size, FALSE, result );
+        if (status != STATUS_PENDING) break;
     }
-    SERVER_END_REQ;
-    if (!status && reply_size)
-        unpack_reply( info->hwnd, info->msg, info->wparam, info->lparam, reply_data, reply_size );
+
+    if (status == STATUS_PENDING)
+        status = get_message_reply( info, reply_data, reply_size, TRUE, result );
 
     free( reply_data );
 
@@ -3423,8 +3603,7 @@ static LRESULT send_inter_thread_message( const struct send_message_info *info,
     /* there's no reply to wait for on notify/callback messages */
     if (info->type == MSG_NOTIFY || info->type == MSG_CALLBACK) return 1;
 
-    wait_message_reply( info->flags );
-    return retrieve_reply( info, reply_size, res_ptr );
+    return wait_message_reply( info, reply_size, res_ptr );
 }
 
 static LRESULT send_inter_thread_callback( HWND hwnd, UINT msg, WPARAM wp, LPARAM lp,
@@ -3587,8 +3766,7 @@ NTSTATUS send_hardware_message( HWND hwnd, const INPUT *input, const RAWINPUT *r
     if (wait)
     {
         LRESULT ignored;
-        wait_message_reply( 0 );
-        retrieve_reply( &info, 0, &ignored );
+        wait_message_reply( &info, 0, &ignored );
     }
     return ret;
 }
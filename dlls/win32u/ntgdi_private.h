@@ -197,9 +197,9 @@ extern BITMAPINFO *copy_packed_dib( const BITMAPINFO *src_info, UINT usage );
 extern DWORD convert_bitmapinfo( const BITMAPINFO *src_info, void *src_bits, struct bitblt_coords *src,
                                  const BITMAPINFO *dst_info, void *dst_bits );
 
-extern DWORD stretch_bitmapinfo( const BITMAPINFO *src_info, void *src_bits, struct bitblt_coords *src,
-                                 const BITMAPINFO *dst_info, void *dst_bits, struct bitblt_coords *dst,
-                                 INT mode );
+extern DWORD stretch_bitmapinfo( const BITMAPINFO *src_info, const struct gdi_image_bits *src_bits,
+                                 struct bitblt_coords *src, const BITMAPINFO *dst_info,
+                                 const struct gdi_image_bits *dst_bits, struct bitblt_coords *dst, INT mode );
 extern DWORD blend_bitmapinfo( const BITMAPINFO *src_info, void *src_bits, struct bitblt_coords *src,
                                const BITMAPINFO *dst_info, void *dst_bits, struct bitblt_coords *dst,
                                BLENDFUNCTION blend );
@@ -118,7 +118,9 @@ struct user_thread_info
     HHOOK                         hook;                   /* Current hook */
     UINT                          active_hooks;           /* Bitmap of active hooks */
     struct received_message_info *receive_info;           /* Message being currently received */
+    struct prefetched_messages   *prefetched;             /* Posted messages prefetched from the server */
     struct user_key_state_info   *key_state;              /* Cache of global key state */
+    const volatile desktop_window_shm_t *window_shm;      /* Window information shared by the server */
     struct imm_thread_data       *imm_thread_data;        /* IMM thread data */
     MSG                           key_repeat_msg;         /* Last WM_KEYDOWN message to repeat */
     HKL                           kbd_layout;             /* Current keyboard layout */
@@ -999,7 +999,7 @@ BOOL WINAPI NtGdiRectInRegion( HRGN hrgn, const RECT *rect )
     WINEREGION *obj;
     BOOL ret = FALSE;
     RECT rc;
-    int i;
+    int i, y;
 
     /* swap the coordinates to make right >= left and bottom >= top */
     /* (region building rectangles are normalized the same way) */
@@ -1010,22 +1010,30 @@ BOOL WINAPI NtGdiRectInRegion( HRGN hrgn, const RECT *rect )
     {
 	if ((obj->numRects > 0) && overlapping(&obj->extents, &rc))
 	{
-	    for (i = region_find_pt( obj, rc.left, rc.top, &ret ); !ret && i < obj->numRects; i++ )
+	    /* look up the first rectangle at or after rc.left in each band, so that
+	     * the cost depends on the number of bands, not of rectangles */
+	    y = rc.top;
+	    do
 	    {
-	        if (obj->rects[i].bottom <= rc.top)
-		    continue;             /* not far enough down yet */
+	        i = region_find_pt( obj, rc.left, y, &ret );
+	        /* an empty rectangle only hits on its top-left corner */
+	        if (ret && (y == rc.top || obj->rects[i].left < rc.right)) break;
+	        ret = FALSE;
+	        if (i == obj->numRects) break;
 
 		if (obj->rects[i].top >= rc.bottom)
 		    break;                /* too far down */
 
-		if (obj->rects[i].right <= rc.left)
-		    continue;              /* not far enough over yet */
-
-		if (obj->rects[i].left >= rc.right)
-		    continue;
-
-		ret = TRUE;
-	    }
+		if (obj->rects[i].top > y)
+		    y = obj->rects[i].top;    /* start of the next band */
+		else if (obj->rects[i].left >= rc.right)
+		    y = obj->rects[i].bottom; /* nothing left in this band */
+		else
+		{
+		    ret = TRUE;
+		    break;
+		}
+	    } while (y < rc.bottom);
 	}
 	GDI_ReleaseObj(hrgn);
     }
@@ -1588,6 +1596,8 @@ static BOOL REGION_RegionOp(
     RECT *r2BandEnd;                  /* End of current band in r2 */
     INT top;                          /* Top of non-overlapping band */
     INT bot;                          /* Bottom of non-overlapping band */
+    INT size;                         /* Initial size of the new region */
+    BOOL reuse;                       /* Whether the destination array is reused */
 
     /*
      * Initialization:
@@ -1607,8 +1617,22 @@ static BOOL REGION_RegionOp(
      * reallocate and copy the array, which is time consuming, yet we don't
      * have to worry about using too much memory. I hope to be able to
      * nuke the Xrealloc() at the end of this function eventually.
+     * If the destination isn't one of the sources and its array is large
+     * enough, steal it instead of allocating a new one.
      */
-    if (!init_region( &newReg, max(reg1->numRects,reg2->numRects) * 2 )) return FALSE;
+    size = max( reg1->numRects, reg2->numRects ) * 2;
+    reuse = destReg != reg1 && destReg != reg2 && destReg->rects != destReg->rects_buf &&
+            destReg->size >= size;
+    if (reuse)
+    {
+        newReg.rects = destReg->rects;
+        newReg.size = destReg->size;
+        empty_region( &newReg );
+        destReg->rects = destReg->rects_buf;
+        destReg->size = RGN_DEFAULT_RECTS;
+        empty_region( destReg );
+    }
+    else if (!init_region( &newReg, size )) return FALSE;
 
     /*
      * Initialize ybot and ytop.
@@ -1781,7 +1805,17 @@ static BOOL REGION_RegionOp(
 	REGION_Coalesce (&newReg, prevBand, curBand);
     }
 
-    REGION_compact( &newReg );
+    if (!reuse) REGION_compact( &newReg );
+    else if (newReg.size / 8 > max( newReg.numRects, RGN_DEFAULT_RECTS ))
+    {
+        /* don't keep a reused array that is much larger than needed */
+        RECT *new_rects = realloc( newReg.rects, max( newReg.numRects, RGN_DEFAULT_RECTS ) * sizeof(RECT) );
+        if (new_rects)
+        {
+            newReg.rects = new_rects;
+            newReg.size = max( newReg.numRects, RGN_DEFAULT_RECTS );
+        }
+    }
     move_rects( destReg, &newReg );
     return TRUE;
 }
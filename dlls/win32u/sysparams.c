@@ -6276,6 +6276,7 @@ static void thread_detach(void)
     free( thread_info->key_state );
     thread_info->key_state = 0;
     free( thread_info->rawinput );
+    free_prefetched_messages();
 
     destroy_thread_windows();
     cleanup_imm_thread();
@@ -129,6 +129,7 @@ extern void track_keyboard_menu_bar( HWND hwnd, UINT wparam, WCHAR ch );
 extern void track_mouse_menu_bar( HWND hwnd, INT ht, int x, int y );
 
 /* message.c */
+extern void free_prefetched_messages(void);
 extern BOOL kill_system_timer( HWND hwnd, UINT_PTR id );
 extern BOOL reply_message_result( LRESULT result );
 extern NTSTATUS send_hardware_message( HWND hwnd, const INPUT *input, const RAWINPUT *rawinput,
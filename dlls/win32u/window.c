@@ -162,6 +162,109 @@ void *free_user_handle( HANDLE handle, unsigned int type )
     return ptr;
 }
 
+/* views of the window information that the server shares with the clients of each desktop */
+struct window_shm_view
+{
+    struct list                          entry;
+    HWND                                 desktop;  /* desktop window identifying the desktop */
+    const volatile desktop_window_shm_t *shm;      /* NULL if it couldn't be mapped */
+};
+
+static struct list window_shm_views = LIST_INIT( window_shm_views );  /* protected by user_lock */
+
+/***********************************************************************
+ *           get_desktop_window_shm
+ *
+ * Map the window information of the thread desktop. Windows of other desktops
+ * are never found there, the server handles them.
+ */
+static const volatile desktop_window_shm_t *get_desktop_window_shm(void)
+{
+    struct user_thread_info *thread_info = get_user_thread_info();
+    struct window_shm_view *view;
+    HANDLE section = 0;
+    SIZE_T size = 0;
+    void *ptr = NULL;
+    HWND desktop;
+
+    if (thread_info->window_shm) return thread_info->window_shm;
+    if (!(desktop = get_desktop_window())) return NULL;
+
+    user_lock();
+    LIST_FOR_EACH_ENTRY( view, &window_shm_views, struct window_shm_view, entry )
+        if (view->desktop == desktop) goto done;
+
+    SERVER_START_REQ( get_desktop_window_shm )
+    {
+        if (!wine_server_call( req )) section = wine_server_ptr_handle( reply->handle );
+    }
+    SERVER_END_REQ;
+    if (section)
+    {
+        if (NtMapViewOfSection( section, GetCurrentProcess(), &ptr, 0, 0, NULL,
+                                &size, ViewShare, 0, PAGE_READONLY ))
+            ptr = NULL;
+        NtClose( section );
+    }
+    if (!ptr) WARN( "failed to map the window information of desktop %p\n", desktop );
+
+    /* failures are remembered as well, the server answers the queries then */
+    if (!(view = malloc( sizeof(*view) )))
+    {
+        if (ptr) NtUnmapViewOfSection( GetCurrentProcess(), ptr );
+        user_unlock();
+        return NULL;
+    }
+    view->desktop = desktop;
+    view->shm = ptr;
+    list_add_tail( &window_shm_views, &view->entry );
+
+done:
+    user_unlock();
+    return thread_info->window_shm = view->shm;
+}
+
+/***********************************************************************
+ *           read_window_shm
+ *
+ * Get a consistent copy of the shared information of a window.
+ */
+static BOOL read_window_shm( const volatile desktop_window_shm_t *desktop_shm, HWND hwnd, window_shm_t *info )
+{
+    const volatile window_shm_t *shm;
+    UINT handle = HandleToUlong( hwnd ), index = USER_HANDLE_TO_INDEX( hwnd ), seq, tries = 0;
+
+    if (index >= NB_USER_HANDLES) return FALSE;
+    shm = &desktop_shm->windows[index];
+
+    do
+    {
+        /* give up if the server keeps updating it, it will answer the request instead */
+        if (tries++ == 100) return FALSE;
+        seq = shm->seq;
+        __atomic_thread_fence( __ATOMIC_ACQUIRE );
+        *info = *shm;
+        __atomic_thread_fence( __ATOMIC_ACQUIRE );
+    } while ((seq & 1) || shm->seq != seq);
+
+    if (!info->handle) return FALSE;
+    if (info->handle != handle && HIWORD(handle) && HIWORD(handle) != 0xffff) return FALSE;
+    return TRUE;
+}
+
+/***********************************************************************
+ *           get_window_shm_info
+ *
+ * Get a consistent copy of the shared information of a window of the thread desktop.
+ */
+static BOOL get_window_shm_info( HWND hwnd, window_shm_t *info )
+{
+    const volatile desktop_window_shm_t *shm;
+
+    if (!(shm = get_desktop_window_shm())) return FALSE;
+    return read_window_shm( shm, hwnd, info );
+}
+
 /*******************************************************************
  *           get_hwnd_message_parent
  *
@@ -204,6 +307,10 @@ HWND get_full_window_handle( HWND hwnd )
     }
     else  /* may belong to another process */
     {
+        window_shm_t info;
+
+        if (get_window_shm_info( hwnd, &info )) return wine_server_ptr_handle( info.handle );
+
         SERVER_START_REQ( get_window_info )
         {
             req->handle = wine_server_user_handle( hwnd );
@@ -289,6 +396,7 @@ HWND is_current_process_window( HWND hwnd )
 /* see IsWindow */
 BOOL is_window( HWND hwnd )
 {
+    window_shm_t info;
     WND *win;
     BOOL ret;
 
@@ -302,6 +410,8 @@ BOOL is_window( HWND hwnd )
     }
 
     /* check other processes */
+    if (get_window_shm_info( hwnd, &info )) return TRUE;
+
     SERVER_START_REQ( get_window_info )
     {
         req->handle = wine_server_user_handle( hwnd );
@@ -314,6 +424,7 @@ BOOL is_window( HWND hwnd )
 /* see GetWindowThreadProcessId */
 DWORD get_window_thread( HWND hwnd, DWORD *process )
 {
+    window_shm_t info;
     WND *ptr;
     DWORD tid = 0;
 
@@ -333,6 +444,12 @@ DWORD get_window_thread( HWND hwnd, DWORD *process )
     }
 
     /* check other processes */
+    if (get_window_shm_info( hwnd, &info ))
+    {
+        if (process) *process = info.pid;
+        return info.tid;
+    }
+
     SERVER_START_REQ( get_window_info )
     {
         req->handle = wine_server_user_handle( hwnd );
@@ -360,7 +477,17 @@ HWND get_parent( HWND hwnd )
     if (win == WND_DESKTOP) return 0;
     if (win == WND_OTHER_PROCESS)
     {
-        LONG style = get_window_long( hwnd, GWL_STYLE );
+        window_shm_t info;
+        LONG style;
+
+        if (get_window_shm_info( hwnd, &info ))
+        {
+            if (info.style & WS_POPUP) retval = wine_server_ptr_handle( info.owner );
+            else if (info.style & WS_CHILD) retval = wine_server_ptr_handle( info.parent );
+            return retval;
+        }
+
+        style = get_window_long( hwnd, GWL_STYLE );
         if (style & (WS_POPUP | WS_CHILD))
         {
             SERVER_START_REQ( get_window_tree )
@@ -1012,11 +1139,24 @@ static LONG_PTR get_window_long_size( HWND hwnd, INT offset, UINT size, BOOL ans
 
     if (win == WND_OTHER_PROCESS)
     {
+        window_shm_t info;
+
         if (offset == GWLP_WNDPROC)
         {
             RtlSetLastWin32Error( ERROR_ACCESS_DENIED );
             return 0;
         }
+        if (offset < 0 && get_window_shm_info( hwnd, &info ))
+        {
+            switch (offset)
+            {
+            case GWL_STYLE:      return info.style;
+            case GWL_EXSTYLE:    return info.ex_style;
+            case GWLP_ID:        return info.id;
+            case GWLP_HINSTANCE: return (ULONG_PTR)wine_server_get_ptr( info.instance );
+            case GWLP_USERDATA:  return info.user_data;
+            }
+        }
         SERVER_START_REQ( set_window_info )
         {
             req->handle = wine_server_user_handle( hwnd );
@@ -1550,6 +1690,98 @@ static void mirror_rect( const RECT *window_rect, RECT *rect )
     rect->right = width - tmp;
 }
 
+/***********************************************************************
+ *           read_window_shm_rects
+ *
+ * Compute the window rectangles from the server shared memory. The caller
+ * makes sure that the windows didn't change while reading them.
+ */
+static BOOL read_window_shm_rects( const volatile desktop_window_shm_t *shm, HWND hwnd,
+                                   enum coords_relative relative, RECT *window, RECT *client, UINT dpi )
+{
+    window_shm_t info, parent;
+    UINT depth = 0;
+    RECT rect;
+
+    if (!read_window_shm( shm, hwnd, &info ) || info.dpi != dpi) return FALSE;
+
+    SetRect( window, info.window.left, info.window.top, info.window.right, info.window.bottom );
+    SetRect( client, info.client.left, info.client.top, info.client.right, info.client.bottom );
+
+    switch (relative)
+    {
+    case COORDS_CLIENT:
+        rect = *client;
+        OffsetRect( window, -rect.left, -rect.top );
+        OffsetRect( client, -rect.left, -rect.top );
+        if (info.ex_style & WS_EX_LAYOUTRTL) mirror_rect( &rect, window );
+        break;
+    case COORDS_WINDOW:
+        rect = *window;
+        OffsetRect( window, -rect.left, -rect.top );
+        OffsetRect( client, -rect.left, -rect.top );
+        if (info.ex_style & WS_EX_LAYOUTRTL) mirror_rect( &rect, client );
+        break;
+    case COORDS_PARENT:
+        if (!info.parent) break;
+        if (!read_window_shm( shm, wine_server_ptr_handle( info.parent ), &parent )) return FALSE;
+        if (parent.ex_style & WS_EX_LAYOUTRTL)
+        {
+            SetRect( &rect, parent.client.left, parent.client.top, parent.client.right, parent.client.bottom );
+            mirror_rect( &rect, window );
+            mirror_rect( &rect, client );
+        }
+        break;
+    case COORDS_SCREEN:
+        /* the desktop window is the only one without a parent; a torn read may
+         * see a loop in the parents, it gets discarded by the caller anyway */
+        for (parent.parent = info.parent; parent.parent; )
+        {
+            if (depth++ == 256) return FALSE;
+            if (!read_window_shm( shm, wine_server_ptr_handle( parent.parent ), &parent )) return FALSE;
+            if (!parent.parent) break;
+            OffsetRect( window, parent.client.left, parent.client.top );
+            OffsetRect( client, parent.client.left, parent.client.top );
+        }
+        break;
+    default:
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/***********************************************************************
+ *           get_window_shm_rects
+ *
+ * Get the window rectangles from the server shared memory. This only handles
+ * the cases where no DPI scaling is needed, the server does the rest.
+ */
+static BOOL get_window_shm_rects( HWND hwnd, enum coords_relative relative, RECT *window_rect,
+                                  RECT *client_rect, UINT dpi )
+{
+    const volatile desktop_window_shm_t *shm;
+    RECT window, client;
+    UINT seq, tries = 0;
+    BOOL ret;
+
+    if (!(shm = get_desktop_window_shm())) return FALSE;
+
+    /* the rectangles may depend on several windows, retry if any window of the desktop changed */
+    do
+    {
+        if (tries++ == 100) return FALSE;
+        seq = shm->seq;
+        __atomic_thread_fence( __ATOMIC_ACQUIRE );
+        ret = !(seq & 1) && read_window_shm_rects( shm, hwnd, relative, &window, &client, dpi );
+        __atomic_thread_fence( __ATOMIC_ACQUIRE );
+    } while ((seq & 1) || shm->seq != seq);
+
+    if (!ret) return FALSE;
+    if (window_rect) *window_rect = window;
+    if (client_rect) *client_rect = client;
+    return TRUE;
+}
+
 /***********************************************************************
  *           get_window_rects
  *
@@ -1660,6 +1892,8 @@ BOOL get_window_rects( HWND hwnd, enum coords_relative relative, RECT *window_re
     }
 
 other_process:
+    if (get_window_shm_rects( hwnd, relative, window_rect, client_rect, dpi )) return TRUE;
+
     SERVER_START_REQ( get_window_rectangles )
     {
         req->handle = wine_server_user_handle( hwnd );
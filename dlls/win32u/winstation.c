@@ -263,6 +263,7 @@ BOOL WINAPI NtUserSetThreadDesktop( HDESK handle )
         struct user_key_state_info *key_state_info = thread_info->key_state;
         thread_info->client_info.top_window = 0;
         thread_info->client_info.msg_window = 0;
+        thread_info->window_shm = NULL;
         if (key_state_info) key_state_info->time = 0;
         if (was_virtual_desktop != is_virtual_desktop()) update_display_cache( TRUE );
     }
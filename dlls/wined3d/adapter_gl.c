@@ -90,6 +90,7 @@ static const struct wined3d_extension_map gl_extension_map[] =
     {"GL_ARB_framebuffer_object",           ARB_FRAMEBUFFER_OBJECT        },
     {"GL_ARB_framebuffer_sRGB",             ARB_FRAMEBUFFER_SRGB          },
     {"GL_ARB_geometry_shader4",             ARB_GEOMETRY_SHADER4          },
+    {"GL_ARB_get_program_binary",           ARB_GET_PROGRAM_BINARY        },
     {"GL_ARB_gpu_shader5",                  ARB_GPU_SHADER5               },
     {"GL_ARB_half_float_pixel",             ARB_HALF_FLOAT_PIXEL          },
     {"GL_ARB_half_float_vertex",            ARB_HALF_FLOAT_VERTEX         },
@@ -2194,6 +2195,10 @@ static void load_gl_funcs(struct wined3d_gl_info *gl_info)
     USE_GL_FUNC(glFramebufferTextureFaceARB)
     USE_GL_FUNC(glFramebufferTextureLayerARB)
     USE_GL_FUNC(glProgramParameteriARB)
+    /* GL_ARB_get_program_binary */
+    USE_GL_FUNC(glGetProgramBinary)
+    USE_GL_FUNC(glProgramBinary)
+    USE_GL_FUNC(glProgramParameteri)
     /* GL_ARB_instanced_arrays */
     USE_GL_FUNC(glVertexAttribDivisorARB)
     /* GL_ARB_internalformat_query */
@@ -3353,6 +3358,7 @@ static BOOL wined3d_adapter_init_gl_caps(struct wined3d_adapter_gl *adapter_gl,
         {ARB_TRANSFORM_FEEDBACK3,          MAKEDWORD_VERSION(4, 0)},
 
         {ARB_ES2_COMPATIBILITY,            MAKEDWORD_VERSION(4, 1)},
+        {ARB_GET_PROGRAM_BINARY,           MAKEDWORD_VERSION(4, 1)},
         {ARB_VIEWPORT_ARRAY,               MAKEDWORD_VERSION(4, 1)},
 
         {ARB_BASE_INSTANCE,                MAKEDWORD_VERSION(4, 2)},
@@ -4618,7 +4624,7 @@ static void adapter_gl_flush_bo_address(struct wined3d_context *context,
 }
 
 static bool adapter_gl_alloc_bo(struct wined3d_device *device, struct wined3d_resource *resource,
-        unsigned int sub_resource_idx, struct wined3d_bo_address *addr)
+        unsigned int sub_resource_idx, bool stream, struct wined3d_bo_address *addr)
 {
     const struct wined3d_gl_info *gl_info = &wined3d_adapter_gl(device->adapter)->gl_info;
     struct wined3d_device_gl *device_gl = wined3d_device_gl(device);
@@ -4627,6 +4633,7 @@ static bool adapter_gl_alloc_bo(struct wined3d_device *device, struct wined3d_re
     bool coherent = true;
     GLbitfield flags;
     GLsizeiptr size;
+    bool ret;
 
     wined3d_not_from_cs(device->cs);
     assert(device->context_count);
@@ -4656,7 +4663,12 @@ static bool adapter_gl_alloc_bo(struct wined3d_device *device, struct wined3d_re
     if (!(bo_gl = heap_alloc(sizeof(*bo_gl))))
         return false;
 
-    if (!(wined3d_device_gl_create_bo(device_gl, NULL, size, binding, usage, coherent, flags, bo_gl)))
+    if (stream)
+        ret = wined3d_device_gl_create_stream_bo(device_gl, size, binding, usage, coherent, flags, bo_gl);
+    else
+        ret = wined3d_device_gl_create_bo(device_gl, NULL, size, binding, usage, coherent, flags, bo_gl);
+
+    if (!ret)
     {
         heap_free(bo_gl);
         return false;
@@ -329,10 +329,16 @@ static void wined3d_allocator_vk_destroy_chunk(struct wined3d_allocator_chunk *c
     heap_free(chunk_vk);
 }
 
+static void *wined3d_allocator_vk_map_chunk(struct wined3d_allocator_chunk *chunk, struct wined3d_context *context)
+{
+    return wined3d_allocator_chunk_vk_map(wined3d_allocator_chunk_vk(chunk), wined3d_context_vk(context));
+}
+
 static const struct wined3d_allocator_ops wined3d_allocator_vk_ops =
 {
     .allocator_create_chunk = wined3d_allocator_vk_create_chunk,
     .allocator_destroy_chunk = wined3d_allocator_vk_destroy_chunk,
+    .allocator_map_chunk = wined3d_allocator_vk_map_chunk,
 };
 
 static void get_physical_device_info(const struct wined3d_adapter_vk *adapter_vk, struct wined3d_physical_device_info *info)
@@ -1191,7 +1197,7 @@ static void adapter_vk_flush_bo_address(struct wined3d_context *context,
 }
 
 static bool adapter_vk_alloc_bo(struct wined3d_device *device, struct wined3d_resource *resource,
-        unsigned int sub_resource_idx, struct wined3d_bo_address *addr)
+        unsigned int sub_resource_idx, bool stream, struct wined3d_bo_address *addr)
 {
     struct wined3d_device_vk *device_vk = wined3d_device_vk(device);
     struct wined3d_context_vk *context_vk = &device_vk->context_vk;
@@ -1199,6 +1205,7 @@ static bool adapter_vk_alloc_bo(struct wined3d_device *device, struct wined3d_re
     VkBufferUsageFlags buffer_usage;
     struct wined3d_bo_vk *bo_vk;
     VkDeviceSize size;
+    BOOL ret;
 
     wined3d_not_from_cs(device->cs);
     assert(device->context_count);
@@ -1221,7 +1228,12 @@ static bool adapter_vk_alloc_bo(struct wined3d_device *device, struct wined3d_re
     if (!(bo_vk = heap_alloc(sizeof(*bo_vk))))
         return false;
 
-    if (!(wined3d_context_vk_create_bo(context_vk, size, buffer_usage, memory_type, bo_vk)))
+    if (stream)
+        ret = wined3d_context_vk_create_stream_bo(context_vk, size, buffer_usage, memory_type, bo_vk);
+    else
+        ret = wined3d_context_vk_create_bo(context_vk, size, buffer_usage, memory_type, bo_vk);
+
+    if (!ret)
     {
         WARN("Failed to create Vulkan buffer.\n");
         heap_free(bo_vk);
@@ -1235,9 +1235,9 @@ void wined3d_buffer_update_sub_resource(struct wined3d_buffer *buffer, struct wi
     uint32_t flags = upload_bo->flags;
 
     /* Try to take this buffer for COW. Don't take it if we've saturated the
-     * refcount. */
-    if (!offset && size == buffer->resource.size
-            && bo && bo->refcount < UINT8_MAX && !(upload_bo->flags & UPLOAD_BO_RENAME_ON_UNMAP))
+     * refcount, or if it's a streamed upload BO, which must be freed soon. */
+    if (!offset && size == buffer->resource.size && bo && bo->refcount < UINT8_MAX
+            && !(upload_bo->flags & (UPLOAD_BO_RENAME_ON_UNMAP | UPLOAD_BO_FREE_ON_UNMAP)))
     {
         flags |= UPLOAD_BO_RENAME_ON_UNMAP;
         ++bo->refcount;
@@ -1277,6 +1277,10 @@ void wined3d_buffer_update_sub_resource(struct wined3d_buffer *buffer, struct wi
     }
     else
     {
+        /* Writes through a non-coherent mapping need to be flushed before the
+         * copy reads them. */
+        if (bo && bo->map_ptr)
+            context->device->adapter->adapter_ops->adapter_flush_bo_address(context, &upload_bo->addr, size);
         wined3d_buffer_copy_bo_address(buffer, context, offset, &upload_bo->addr, size);
     }
 }
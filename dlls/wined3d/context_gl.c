@@ -2784,7 +2784,7 @@ GLuint wined3d_context_gl_allocate_vram_chunk_buffer(struct wined3d_context_gl *
     return id;
 }
 
-static void *wined3d_allocator_chunk_gl_map(struct wined3d_allocator_chunk_gl *chunk_gl,
+void *wined3d_allocator_chunk_gl_map(struct wined3d_allocator_chunk_gl *chunk_gl,
         struct wined3d_context_gl *context_gl)
 {
     const struct wined3d_gl_info *gl_info = context_gl->gl_info;
@@ -3156,7 +3156,7 @@ void wined3d_context_gl_destroy_bo(struct wined3d_context_gl *context_gl, struct
 
     if (bo->memory)
     {
-        unsigned int order = bo->memory->order;
+        size_t size = bo->memory->size;
 
         if (bo->b.map_ptr)
             wined3d_allocator_chunk_gl_unmap(wined3d_allocator_chunk_gl(bo->memory->chunk), context_gl);
@@ -3164,7 +3164,7 @@ void wined3d_context_gl_destroy_bo(struct wined3d_context_gl *context_gl, struct
 
         if (bo->command_fence_id == device_gl->current_fence_id)
         {
-            device_gl->retired_bo_size += WINED3D_ALLOCATOR_CHUNK_SIZE >> order;
+            device_gl->retired_bo_size += size;
             if (device_gl->retired_bo_size > WINED3D_RETIRED_BO_SIZE_THRESHOLD)
                 wined3d_context_gl_submit_command_fence(context_gl);
         }
@@ -26,6 +26,7 @@
 #include "wined3d_vk.h"
 
 WINE_DEFAULT_DEBUG_CHANNEL(d3d);
+WINE_DECLARE_DEBUG_CHANNEL(d3d_perf);
 
 VkCompareOp vk_compare_op_from_wined3d(enum wined3d_cmp_func op)
 {
@@ -352,7 +353,7 @@ VkDeviceMemory wined3d_context_vk_allocate_vram_chunk_memory(struct wined3d_cont
 }
 
 static struct wined3d_allocator_block *wined3d_context_vk_allocate_memory(struct wined3d_context_vk *context_vk,
-        unsigned int memory_type, VkDeviceSize size, VkDeviceMemory *vk_memory)
+        unsigned int memory_type, VkDeviceSize size, bool stream, VkDeviceMemory *vk_memory)
 {
     struct wined3d_device_vk *device_vk = wined3d_device_vk(context_vk->c.device);
     struct wined3d_allocator *allocator = &device_vk->allocator;
@@ -367,7 +368,12 @@ static struct wined3d_allocator_block *wined3d_context_vk_allocate_memory(struct
         return NULL;
     }
 
-    if (!(block = wined3d_allocator_allocate(allocator, &context_vk->c, memory_type, size)))
+    if (stream)
+        block = wined3d_allocator_allocate_stream(allocator, &context_vk->c, memory_type, size);
+    else
+        block = wined3d_allocator_allocate(allocator, &context_vk->c, memory_type, size);
+
+    if (!block)
     {
         wined3d_device_vk_allocator_unlock(device_vk);
         *vk_memory = VK_NULL_HANDLE;
@@ -495,8 +501,8 @@ static bool wined3d_context_vk_create_slab_bo(struct wined3d_context_vk *context
     return true;
 }
 
-BOOL wined3d_context_vk_create_bo(struct wined3d_context_vk *context_vk, VkDeviceSize size,
-        VkBufferUsageFlags usage, VkMemoryPropertyFlags memory_type, struct wined3d_bo_vk *bo)
+static BOOL wined3d_context_vk_create_buffer_bo(struct wined3d_context_vk *context_vk, VkDeviceSize size,
+        VkBufferUsageFlags usage, VkMemoryPropertyFlags memory_type, bool stream, struct wined3d_bo_vk *bo)
 {
     struct wined3d_device_vk *device_vk = wined3d_device_vk(context_vk->c.device);
     const struct wined3d_vk_info *vk_info = context_vk->vk_info;
@@ -537,7 +543,7 @@ BOOL wined3d_context_vk_create_bo(struct wined3d_context_vk *context_vk, VkDevic
         return FALSE;
     }
     bo->memory = wined3d_context_vk_allocate_memory(context_vk,
-            memory_type_idx, memory_requirements.size, &bo->vk_memory);
+            memory_type_idx, memory_requirements.size, stream, &bo->vk_memory);
     if (!bo->vk_memory)
     {
         ERR("Failed to allocate buffer memory.\n");
@@ -577,6 +583,20 @@ BOOL wined3d_context_vk_create_bo(struct wined3d_context_vk *context_vk, VkDevic
     return TRUE;
 }
 
+BOOL wined3d_context_vk_create_bo(struct wined3d_context_vk *context_vk, VkDeviceSize size,
+        VkBufferUsageFlags usage, VkMemoryPropertyFlags memory_type, struct wined3d_bo_vk *bo)
+{
+    return wined3d_context_vk_create_buffer_bo(context_vk, size, usage, memory_type, false, bo);
+}
+
+/* Upload buffers for DISCARD maps on the immediate context are short-lived,
+ * and are sub-allocated from the allocator's streaming chunks. */
+BOOL wined3d_context_vk_create_stream_bo(struct wined3d_context_vk *context_vk, VkDeviceSize size,
+        VkBufferUsageFlags usage, VkMemoryPropertyFlags memory_type, struct wined3d_bo_vk *bo)
+{
+    return wined3d_context_vk_create_buffer_bo(context_vk, size, usage, memory_type, true, bo);
+}
+
 BOOL wined3d_context_vk_create_image(struct wined3d_context_vk *context_vk, VkImageType vk_image_type,
         VkImageUsageFlags usage, VkFormat vk_format, unsigned int width, unsigned int height, unsigned int depth,
         unsigned int sample_count, unsigned int mip_levels, unsigned int layer_count, unsigned int flags,
@@ -632,7 +652,7 @@ BOOL wined3d_context_vk_create_image(struct wined3d_context_vk *context_vk, VkIm
     }
 
     image->memory = wined3d_context_vk_allocate_memory(context_vk, memory_type_idx,
-            memory_requirements.size, &image->vk_memory);
+            memory_requirements.size, false, &image->vk_memory);
     if (!image->vk_memory)
     {
         ERR("Failed to allocate image memory.\n");
@@ -3326,6 +3346,7 @@ static VkPipeline wined3d_context_vk_get_graphics_pipeline(struct wined3d_contex
     const struct wined3d_vk_info *vk_info = context_vk->vk_info;
     struct wined3d_graphics_pipeline_vk *pipeline_vk;
     struct wined3d_graphics_pipeline_key_vk *key;
+    LARGE_INTEGER start, end, freq;
     struct wine_rb_entry *entry;
     VkResult vr;
 
@@ -3337,6 +3358,9 @@ static VkPipeline wined3d_context_vk_get_graphics_pipeline(struct wined3d_contex
         return VK_NULL_HANDLE;
     pipeline_vk->key = *key;
 
+    if (TRACE_ON(d3d_perf))
+        QueryPerformanceCounter(&start);
+
     if ((vr = VK_CALL(vkCreateGraphicsPipelines(device_vk->vk_device,
             VK_NULL_HANDLE, 1, &key->pipeline_desc, NULL, &pipeline_vk->vk_pipeline))) < 0)
     {
@@ -3345,6 +3369,15 @@ static VkPipeline wined3d_context_vk_get_graphics_pipeline(struct wined3d_contex
         return VK_NULL_HANDLE;
     }
 
+    if (TRACE_ON(d3d_perf))
+    {
+        QueryPerformanceCounter(&end);
+        QueryPerformanceFrequency(&freq);
+        TRACE_(d3d_perf)("Draw stalled for %.3f ms creating graphics pipeline 0x%s.\n",
+                (end.QuadPart - start.QuadPart) * 1000.0 / freq.QuadPart,
+                wine_dbgstr_longlong(pipeline_vk->vk_pipeline));
+    }
+
     if (wine_rb_put(&context_vk->graphics_pipelines, &pipeline_vk->key, &pipeline_vk->entry) == -1)
         ERR("Failed to insert pipeline.\n");
 
@@ -29,6 +29,9 @@ static NTSTATUS (WINAPI *pNtAlertThreadByThreadId)(HANDLE tid);
 static NTSTATUS (WINAPI *pNtWaitForAlertByThreadId)(void *addr, const LARGE_INTEGER *timeout);
 
 #define WINED3D_INITIAL_CS_SIZE 4096
+#define WINED3D_CS_CHUNK_SIZE (64 * 1024)
+#define WINED3D_CS_MAX_POOLED_CHUNKS 256
+#define WINED3D_CS_PROFILE_MAX_EVENTS (1024 * 1024)
 
 struct wined3d_deferred_upload
 {
@@ -46,14 +49,27 @@ struct wined3d_deferred_query_issue
     unsigned int flags;
 };
 
+/* Packets recorded by deferred contexts are stored in a list of chunks. A
+ * packet never straddles two chunks. Chunks of WINED3D_CS_CHUNK_SIZE bytes are
+ * recycled through a lock-free pool in struct wined3d_cs, so that recording on
+ * several threads doesn't contend on the heap. Larger chunks are only used for
+ * packets that don't fit in a regular chunk, and are never pooled. */
+struct wined3d_cs_chunk
+{
+    SLIST_ENTRY entry;
+    struct wined3d_cs_chunk *next;
+    SIZE_T size, capacity;
+    BYTE data[1];
+};
+
 struct wined3d_command_list
 {
     LONG refcount;
 
     struct wined3d_device *device;
 
-    SIZE_T data_size;
-    void *data;
+    /* Executed in place; the packets are never copied. */
+    struct wined3d_cs_chunk *chunks;
 
     SIZE_T resource_count;
     struct wined3d_resource **resources;
@@ -638,6 +654,169 @@ static struct wined3d_cs_packet *wined3d_next_cs_packet(const uint8_t *data, SIZ
     return packet;
 }
 
+static struct wined3d_cs_chunk *wined3d_cs_chunk_create(struct wined3d_cs *cs, SIZE_T size)
+{
+    struct wined3d_cs_chunk *chunk;
+    SLIST_ENTRY *entry;
+
+    if (size <= WINED3D_CS_CHUNK_SIZE && (entry = InterlockedPopEntrySList(&cs->chunk_pool)))
+    {
+        chunk = CONTAINING_RECORD(entry, struct wined3d_cs_chunk, entry);
+    }
+    else
+    {
+        size = max(size, WINED3D_CS_CHUNK_SIZE);
+        if (!(chunk = heap_alloc(offsetof(struct wined3d_cs_chunk, data[size]))))
+            return NULL;
+        chunk->capacity = size;
+    }
+
+    chunk->next = NULL;
+    chunk->size = 0;
+
+    return chunk;
+}
+
+enum wined3d_cs_profile_wait
+{
+    WINED3D_CS_PROFILE_WAIT_FINISH,
+    WINED3D_CS_PROFILE_WAIT_SPACE,
+    WINED3D_CS_PROFILE_WAIT_MAP,
+    WINED3D_CS_PROFILE_WAIT_UNMAP,
+    WINED3D_CS_PROFILE_WAIT_COUNT,
+};
+
+static const char * const wined3d_cs_profile_wait_names[] =
+{
+    "finish",
+    "require_space",
+    "map",
+    "unmap",
+};
+C_ASSERT(ARRAY_SIZE(wined3d_cs_profile_wait_names) == WINED3D_CS_PROFILE_WAIT_COUNT);
+
+struct wined3d_cs_profile_counter
+{
+    uint64_t count;
+    LONGLONG ticks, max_ticks;
+};
+
+struct wined3d_cs_profile_event
+{
+    const char *name;
+    DWORD tid;
+    LONGLONG start, duration;
+};
+
+/* Op counters are only updated by the thread executing packets. Wait counters
+ * are updated by the application thread submitting to the immediate context,
+ * which is serialised by the wined3d mutex. Op counters record self time; the
+ * ops executed by WINED3D_CS_OP_EXECUTE_COMMAND_LIST are not included in its
+ * time. */
+struct wined3d_cs_profile
+{
+    LARGE_INTEGER frequency, start;
+    /* Time spent in ops nested inside the currently executing op. */
+    LONGLONG nested_ticks;
+
+    struct wined3d_cs_profile_counter ops[WINED3D_CS_OP_STOP];
+    struct wined3d_cs_profile_counter waits[WINED3D_CS_PROFILE_WAIT_COUNT];
+
+    uint64_t submit_count;
+    uint64_t queue_depth_total;
+    ULONG queue_depth_max;
+
+    /* Only allocated when writing a trace file. */
+    LONG event_count;
+    struct wined3d_cs_profile_event *events;
+};
+
+static LONGLONG wined3d_cs_profile_begin(const struct wined3d_cs *cs)
+{
+    LARGE_INTEGER counter;
+
+    if (!cs->profile)
+        return 0;
+    QueryPerformanceCounter(&counter);
+    return counter.QuadPart;
+}
+
+/* Returns the total time since "start". The counter is only charged for the
+ * part of it not spent in "nested_ticks"; trace events cover the total. */
+static LONGLONG wined3d_cs_profile_end(struct wined3d_cs_profile *profile,
+        struct wined3d_cs_profile_counter *counter, const char *name, LONGLONG start, LONGLONG nested_ticks)
+{
+    struct wined3d_cs_profile_event *event;
+    LONGLONG ticks, self_ticks;
+    LARGE_INTEGER end;
+    LONG idx;
+
+    QueryPerformanceCounter(&end);
+    ticks = end.QuadPart - start;
+    self_ticks = ticks - nested_ticks;
+
+    ++counter->count;
+    counter->ticks += self_ticks;
+    if (self_ticks > counter->max_ticks)
+        counter->max_ticks = self_ticks;
+
+    if (!profile->events || profile->event_count >= WINED3D_CS_PROFILE_MAX_EVENTS)
+        return ticks;
+    if ((idx = InterlockedIncrement(&profile->event_count) - 1) >= WINED3D_CS_PROFILE_MAX_EVENTS)
+        return ticks;
+    event = &profile->events[idx];
+    event->name = name;
+    event->tid = GetCurrentThreadId();
+    event->start = start;
+    event->duration = ticks;
+
+    return ticks;
+}
+
+static void wined3d_cs_profile_wait(struct wined3d_cs *cs, enum wined3d_cs_profile_wait wait, LONGLONG start)
+{
+    wined3d_cs_profile_end(cs->profile, &cs->profile->waits[wait], wined3d_cs_profile_wait_names[wait], start, 0);
+}
+
+static void wined3d_cs_chunks_destroy(struct wined3d_cs *cs, struct wined3d_cs_chunk *chunk)
+{
+    struct wined3d_cs_chunk *next;
+
+    for (; chunk; chunk = next)
+    {
+        next = chunk->next;
+        if (chunk->capacity == WINED3D_CS_CHUNK_SIZE
+                && QueryDepthSList(&cs->chunk_pool) < WINED3D_CS_MAX_POOLED_CHUNKS)
+            InterlockedPushEntrySList(&cs->chunk_pool, &chunk->entry);
+        else
+            heap_free(chunk);
+    }
+}
+
+/* Replace a mostly empty last chunk with one that fits its packets, so that
+ * small command lists don't each hold on to a whole chunk. The original
+ * chunk goes back to the pool. */
+static void wined3d_cs_chunks_trim(struct wined3d_cs *cs, struct wined3d_cs_chunk **chunks)
+{
+    struct wined3d_cs_chunk **tail, *chunk;
+
+    if (!*chunks)
+        return;
+    for (tail = chunks; (*tail)->next; tail = &(*tail)->next)
+        ;
+    if ((*tail)->size > (*tail)->capacity / 2)
+        return;
+
+    if (!(chunk = heap_alloc(offsetof(struct wined3d_cs_chunk, data[max((*tail)->size, 1)]))))
+        return;
+    chunk->next = NULL;
+    chunk->size = chunk->capacity = (*tail)->size;
+    memcpy(chunk->data, (*tail)->data, chunk->size);
+
+    wined3d_cs_chunks_destroy(cs, *tail);
+    *tail = chunk;
+}
+
 static void wined3d_cs_exec_nop(struct wined3d_cs *cs, const void *data)
 {
 }
@@ -2489,6 +2668,7 @@ HRESULT wined3d_device_context_emit_map(struct wined3d_device_context *context,
         struct wined3d_map_desc *map_desc, const struct wined3d_box *box, unsigned int flags)
 {
     struct wined3d_cs_map *op;
+    LONGLONG start;
     HRESULT hr;
 
     /* Mapping resources from the worker thread isn't an issue by itself, but
@@ -2505,6 +2685,8 @@ HRESULT wined3d_device_context_emit_map(struct wined3d_device_context *context,
 
     TRACE_(d3d_perf)("Mapping resource %p (type %u), flags %#x through the CS.\n", resource, resource->type, flags);
 
+    start = wined3d_cs_profile_begin(context->device->cs);
+
     wined3d_resource_wait_idle(resource);
 
     /* We might end up invalidating the resource on the CS thread. */
@@ -2523,6 +2705,9 @@ HRESULT wined3d_device_context_emit_map(struct wined3d_device_context *context,
     wined3d_device_context_submit(context, WINED3D_CS_QUEUE_MAP);
     wined3d_device_context_finish(context, WINED3D_CS_QUEUE_MAP);
 
+    if (start)
+        wined3d_cs_profile_wait(context->device->cs, WINED3D_CS_PROFILE_WAIT_MAP, start);
+
     if (SUCCEEDED(hr))
         wined3d_resource_get_sub_resource_map_pitch(resource, sub_resource_idx,
                 &map_desc->row_pitch, &map_desc->slice_pitch);
@@ -2543,6 +2728,7 @@ HRESULT wined3d_device_context_emit_unmap(struct wined3d_device_context *context
     struct wined3d_cs_unmap *op;
     struct wined3d_box box;
     struct upload_bo bo;
+    LONGLONG start;
     HRESULT hr;
 
     if (context->ops->unmap_upload_bo(context, resource, sub_resource_idx, &box, &bo))
@@ -2559,6 +2745,8 @@ HRESULT wined3d_device_context_emit_unmap(struct wined3d_device_context *context
 
     TRACE_(d3d_perf)("Unmapping resource %p (type %u) through the CS.\n", resource, resource->type);
 
+    start = wined3d_cs_profile_begin(context->device->cs);
+
     if (!(op = wined3d_device_context_require_space(context, sizeof(*op), WINED3D_CS_QUEUE_MAP)))
         return E_OUTOFMEMORY;
     op->opcode = WINED3D_CS_OP_UNMAP;
@@ -2569,6 +2757,9 @@ HRESULT wined3d_device_context_emit_unmap(struct wined3d_device_context *context
     wined3d_device_context_submit(context, WINED3D_CS_QUEUE_MAP);
     wined3d_device_context_finish(context, WINED3D_CS_QUEUE_MAP);
 
+    if (start)
+        wined3d_cs_profile_wait(context->device->cs, WINED3D_CS_PROFILE_WAIT_UNMAP, start);
+
     return hr;
 }
 
@@ -2751,15 +2942,25 @@ static void wined3d_cs_exec_update_sub_resource(struct wined3d_cs *cs, const voi
         wined3d_texture_update_sub_resource(texture_from_resource(resource),
                 op->sub_resource_idx, context, &op->bo, box, op->row_pitch, op->slice_pitch);
 
-    context_release(context);
-
     if (op->bo.flags & UPLOAD_BO_FREE_ON_UNMAP)
     {
-        if (op->bo.addr.buffer_object)
-            FIXME("Free BO address %s.\n", debug_const_bo_address(&op->bo.addr));
+        struct wined3d_bo *bo;
+
+        if ((bo = op->bo.addr.buffer_object))
+        {
+            if (!--bo->refcount)
+            {
+                wined3d_context_destroy_bo(context, bo);
+                heap_free(bo);
+            }
+        }
         else
+        {
             heap_free((void *)op->bo.addr.addr);
+        }
     }
+
+    context_release(context);
 }
 
 void wined3d_device_context_emit_update_sub_resource(struct wined3d_device_context *context,
@@ -2990,6 +3191,27 @@ static void (* const wined3d_cs_op_handlers[])(struct wined3d_cs *cs, const void
     /* WINED3D_CS_OP_EXECUTE_COMMAND_LIST        */ wined3d_cs_exec_execute_command_list,
 };
 
+static void wined3d_cs_execute_op(struct wined3d_cs *cs, enum wined3d_cs_op opcode, const void *data)
+{
+    struct wined3d_cs_profile *profile = cs->profile;
+    LONGLONG start, parent_nested_ticks;
+
+    if (!profile)
+    {
+        wined3d_cs_op_handlers[opcode](cs, data);
+        return;
+    }
+
+    /* Ops executed from a command list are nested inside the
+     * WINED3D_CS_OP_EXECUTE_COMMAND_LIST op. */
+    parent_nested_ticks = profile->nested_ticks;
+    profile->nested_ticks = 0;
+    start = wined3d_cs_profile_begin(cs);
+    wined3d_cs_op_handlers[opcode](cs, data);
+    profile->nested_ticks = parent_nested_ticks + wined3d_cs_profile_end(profile,
+            &profile->ops[opcode], debug_cs_op(opcode), start, profile->nested_ticks);
+}
+
 void wined3d_device_context_emit_execute_command_list(struct wined3d_device_context *context,
         struct wined3d_command_list *list, bool restore_state)
 {
@@ -3052,7 +3274,7 @@ static void wined3d_cs_st_submit(struct wined3d_device_context *context, enum wi
     if (opcode >= WINED3D_CS_OP_STOP)
         ERR("Invalid opcode %#x.\n", opcode);
     else
-        wined3d_cs_op_handlers[opcode](cs, &data[start]);
+        wined3d_cs_execute_op(cs, opcode, &data[start]);
 
     if (cs->data == data)
         cs->start = cs->end = start;
@@ -3098,13 +3320,18 @@ static bool wined3d_cs_map_upload_bo(struct wined3d_device_context *context, str
 
         if (flags & WINED3D_MAP_DISCARD)
         {
-            if (!device->adapter->adapter_ops->adapter_alloc_bo(device, resource, sub_resource_idx, &addr))
+            /* Only buffers are streamed. Texture uploads, like deferred
+             * context uploads, may live long enough to stall the ring. */
+            if (!device->adapter->adapter_ops->adapter_alloc_bo(device, resource,
+                    sub_resource_idx, resource->type == WINED3D_RTYPE_BUFFER, &addr))
                 return false;
 
-            /* Limit NOOVERWRITE maps to buffers for now; there are too many
-             * ways that a texture can be invalidated to even count. */
+            /* Buffer uploads are copied into the buffer and freed on unmap,
+             * rather than renamed into it; a buffer may hold on to its BO for
+             * arbitrarily long, which would pin the stream ring. Subsequent
+             * NOOVERWRITE maps get their own upload BO in the same way. */
             if (resource->type == WINED3D_RTYPE_BUFFER)
-                client->addr = addr;
+                discard_client_address(resource);
         }
         else
         {
@@ -3142,6 +3369,9 @@ static bool wined3d_cs_map_upload_bo(struct wined3d_device_context *context, str
 
         client->mapped_upload.addr = *wined3d_const_bo_address(&addr);
         client->mapped_upload.flags = 0;
+        /* Copies start at the mapped data. */
+        if (resource->type == WINED3D_RTYPE_BUFFER && (flags & WINED3D_MAP_DISCARD))
+            client->mapped_upload.addr.addr += box->left;
         if (bo)
         {
             map_ptr += bo->memory_offset;
@@ -3153,7 +3383,9 @@ static bool wined3d_cs_map_upload_bo(struct wined3d_device_context *context, str
         }
         map_desc->data = resource_offset_map_pointer(resource, sub_resource_idx, map_ptr, box);
 
-        if (flags & WINED3D_MAP_DISCARD)
+        if (resource->type == WINED3D_RTYPE_BUFFER && (flags & WINED3D_MAP_DISCARD))
+            client->mapped_upload.flags |= UPLOAD_BO_UPLOAD_ON_UNMAP | UPLOAD_BO_FREE_ON_UNMAP;
+        else if (flags & WINED3D_MAP_DISCARD)
             client->mapped_upload.flags |= UPLOAD_BO_UPLOAD_ON_UNMAP | UPLOAD_BO_RENAME_ON_UNMAP;
 
         client->mapped_box = *box;
@@ -3240,6 +3472,16 @@ static void wined3d_cs_queue_submit(struct wined3d_cs_queue *queue, struct wined
     packet_size = FIELD_OFFSET(struct wined3d_cs_packet, data[packet->size]);
     InterlockedExchange((LONG *)&queue->head, queue->head + packet_size);
 
+    if (cs->profile)
+    {
+        ULONG depth = queue->head - *(volatile ULONG *)&queue->tail;
+
+        ++cs->profile->submit_count;
+        cs->profile->queue_depth_total += depth;
+        if (depth > cs->profile->queue_depth_max)
+            cs->profile->queue_depth_max = depth;
+    }
+
     if (InterlockedCompareExchange(&cs->waiting_for_event, FALSE, TRUE))
     {
         if (pNtAlertThreadByThreadId)
@@ -3265,6 +3507,8 @@ static void *wined3d_cs_queue_require_space(struct wined3d_cs_queue *queue, size
     size_t header_size, packet_size, remaining;
     struct wined3d_cs_packet *packet;
     ULONG head = queue->head & WINED3D_CS_QUEUE_MASK;
+    bool waited = false;
+    LONGLONG start;
 
     header_size = FIELD_OFFSET(struct wined3d_cs_packet, data[0]);
     packet_size = FIELD_OFFSET(struct wined3d_cs_packet, data[size]);
@@ -3293,6 +3537,7 @@ static void *wined3d_cs_queue_require_space(struct wined3d_cs_queue *queue, size
         assert(!head);
     }
 
+    start = wined3d_cs_profile_begin(cs);
     for (;;)
     {
         ULONG tail = (*(volatile ULONG *)&queue->tail) & WINED3D_CS_QUEUE_MASK;
@@ -3313,8 +3558,12 @@ static void *wined3d_cs_queue_require_space(struct wined3d_cs_queue *queue, size
 
         TRACE_(d3d_perf)("Waiting for free space. Head %lu, tail %lu, packet size %Iu.\n",
                 head, tail, packet_size);
+        waited = true;
     }
 
+    if (start && waited)
+        wined3d_cs_profile_wait(cs, WINED3D_CS_PROFILE_WAIT_SPACE, start);
+
     packet = (struct wined3d_cs_packet *)&queue->data[head];
     packet->size = size;
     return packet->data;
@@ -3335,14 +3584,19 @@ static void wined3d_cs_mt_finish(struct wined3d_device_context *context, enum wi
 {
     struct wined3d_cs *cs = wined3d_cs_from_context(context);
     unsigned int spin_count = 0;
+    LONGLONG start;
 
     if (cs->thread_id == GetCurrentThreadId())
         return wined3d_cs_st_finish(context, queue_id);
 
+    start = wined3d_cs_profile_begin(cs);
     TRACE_(d3d_perf)("Waiting for queue %u to be empty.\n", queue_id);
     while (cs->queue[queue_id].head != *(volatile ULONG *)&cs->queue[queue_id].tail)
         wined3d_pause(&spin_count);
     TRACE_(d3d_perf)("Queue is now empty.\n");
+
+    if (start)
+        wined3d_cs_profile_wait(cs, WINED3D_CS_PROFILE_WAIT_FINISH, start);
 }
 
 static const struct wined3d_device_context_ops wined3d_cs_mt_ops =
@@ -3435,7 +3689,7 @@ static inline bool wined3d_cs_execute_next(struct wined3d_cs *cs, struct wined3d
         }
 
         wined3d_cs_command_lock(cs);
-        wined3d_cs_op_handlers[opcode](cs, packet->data);
+        wined3d_cs_execute_op(cs, opcode, packet->data);
         wined3d_cs_command_unlock(cs);
         TRACE("%s at %p executed.\n", debug_cs_op(opcode), packet);
     }
@@ -3447,29 +3701,33 @@ static inline bool wined3d_cs_execute_next(struct wined3d_cs *cs, struct wined3d
 static void wined3d_cs_exec_execute_command_list(struct wined3d_cs *cs, const void *data)
 {
     const struct wined3d_cs_execute_command_list *op = data;
-    SIZE_T start = 0, end = op->list->data_size;
-    const BYTE *cs_data = op->list->data;
+    const struct wined3d_cs_chunk *chunk;
     struct wined3d_cs_queue *queue;
+    SIZE_T start;
 
     TRACE("Executing command list %p.\n", op->list);
 
     queue = &cs->queue[WINED3D_CS_QUEUE_MAP];
-    while (start < end)
+    for (chunk = op->list->chunks; chunk; chunk = chunk->next)
     {
-        const struct wined3d_cs_packet *packet;
-        enum wined3d_cs_op opcode;
+        start = 0;
+        while (start < chunk->size)
+        {
+            const struct wined3d_cs_packet *packet;
+            enum wined3d_cs_op opcode;
 
-        while (!wined3d_cs_queue_is_empty(cs, queue))
-            wined3d_cs_execute_next(cs, queue);
+            while (!wined3d_cs_queue_is_empty(cs, queue))
+                wined3d_cs_execute_next(cs, queue);
 
-        packet = wined3d_next_cs_packet(cs_data, &start, WINED3D_CS_QUEUE_MASK);
-        opcode = *(const enum wined3d_cs_op *)packet->data;
+            packet = wined3d_next_cs_packet(chunk->data, &start, ~(SIZE_T)0);
+            opcode = *(const enum wined3d_cs_op *)packet->data;
 
-        if (opcode >= WINED3D_CS_OP_STOP)
-            ERR("Invalid opcode %#x.\n", opcode);
-        else
-            wined3d_cs_op_handlers[opcode](cs, packet->data);
-        TRACE("%s executed.\n", debug_cs_op(opcode));
+            if (opcode >= WINED3D_CS_OP_STOP)
+                ERR("Invalid opcode %#x.\n", opcode);
+            else
+                wined3d_cs_execute_op(cs, opcode, packet->data);
+            TRACE("%s executed.\n", debug_cs_op(opcode));
+        }
     }
 }
 
@@ -3545,8 +3803,14 @@ void CDECL wined3d_device_context_flush_mapped_buffer(struct wined3d_device_cont
         return;
 
     if (client->mapped_upload.flags & UPLOAD_BO_UPLOAD_ON_UNMAP)
+    {
+        struct upload_bo upload = client->mapped_upload;
+
+        /* The upload BO is still mapped; it's freed when it's unmapped. */
+        upload.flags &= ~UPLOAD_BO_FREE_ON_UNMAP;
         wined3d_device_context_upload_bo(context, &buffer->resource, 0,
-                &client->mapped_box, &client->mapped_upload, buffer->resource.size, buffer->resource.size);
+                &client->mapped_box, &upload, buffer->resource.size, buffer->resource.size);
+    }
 
     if (client->mapped_upload.flags & UPLOAD_BO_RENAME_ON_UNMAP)
     {
@@ -3557,6 +3821,106 @@ void CDECL wined3d_device_context_flush_mapped_buffer(struct wined3d_device_cont
     }
 }
 
+static void wined3d_cs_profile_create(struct wined3d_cs *cs)
+{
+    struct wined3d_cs_profile *profile;
+
+    if (!TRACE_ON(d3d_perf) && !wined3d_settings.cs_profile_path)
+        return;
+
+    if (!(profile = heap_alloc_zero(sizeof(*profile))))
+        return;
+    if (wined3d_settings.cs_profile_path
+            && !(profile->events = heap_alloc(WINED3D_CS_PROFILE_MAX_EVENTS * sizeof(*profile->events))))
+        WARN_(d3d_perf)("Failed to allocate CS profile event memory.\n");
+    QueryPerformanceFrequency(&profile->frequency);
+    QueryPerformanceCounter(&profile->start);
+
+    cs->profile = profile;
+}
+
+static void wined3d_cs_profile_write_trace(const struct wined3d_cs_profile *profile, const char *path)
+{
+    double scale = 1000000.0 / profile->frequency.QuadPart;
+    const struct wined3d_cs_profile_event *event;
+    DWORD pid = GetCurrentProcessId(), written;
+    unsigned int i, count, size = 0;
+    char *buffer;
+    HANDLE file;
+
+    if (!(buffer = heap_alloc(65536)))
+        return;
+
+    if ((file = CreateFileA(path, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, 0, NULL)) == INVALID_HANDLE_VALUE)
+    {
+        WARN_(d3d_perf)("Failed to create CS profile trace %s, error %lu.\n", debugstr_a(path), GetLastError());
+        heap_free(buffer);
+        return;
+    }
+
+    size = sprintf(buffer, "{\"traceEvents\":[\n");
+    count = min(profile->event_count, WINED3D_CS_PROFILE_MAX_EVENTS);
+    for (i = 0; i < count; ++i)
+    {
+        event = &profile->events[i];
+        size += sprintf(&buffer[size], "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":%lu,\"tid\":%lu,"
+                "\"ts\":%.3f,\"dur\":%.3f}\n", i ? "," : "", event->name, pid, event->tid,
+                (event->start - profile->start.QuadPart) * scale, event->duration * scale);
+        if (size > 65536 - 256)
+        {
+            WriteFile(file, buffer, size, &written, NULL);
+            size = 0;
+        }
+    }
+    size += sprintf(&buffer[size], "]}\n");
+    WriteFile(file, buffer, size, &written, NULL);
+
+    CloseHandle(file);
+    heap_free(buffer);
+
+    TRACE_(d3d_perf)("Wrote %u CS profile events to %s.\n", count, debugstr_a(path));
+}
+
+static void wined3d_cs_profile_dump_counter(const struct wined3d_cs_profile *profile,
+        const char *name, const struct wined3d_cs_profile_counter *counter)
+{
+    double scale = 1000000.0 / profile->frequency.QuadPart;
+
+    if (!counter->count)
+        return;
+
+    TRACE_(d3d_perf)("  %s: %s calls, %.3f ms total, %.3f us average, %.3f us max.\n",
+            name, wine_dbgstr_longlong(counter->count), counter->ticks * scale / 1000.0,
+            counter->ticks * scale / counter->count, counter->max_ticks * scale);
+}
+
+static void wined3d_cs_profile_destroy(struct wined3d_cs *cs)
+{
+    struct wined3d_cs_profile *profile;
+    unsigned int i;
+
+    if (!(profile = cs->profile))
+        return;
+
+    TRACE_(d3d_perf)("Command stream %p profile, executed ops:\n", cs);
+    for (i = 0; i < ARRAY_SIZE(profile->ops); ++i)
+        wined3d_cs_profile_dump_counter(profile, debug_cs_op(i), &profile->ops[i]);
+    TRACE_(d3d_perf)("Application thread waits:\n");
+    for (i = 0; i < ARRAY_SIZE(profile->waits); ++i)
+        wined3d_cs_profile_dump_counter(profile, wined3d_cs_profile_wait_names[i], &profile->waits[i]);
+    if (profile->submit_count)
+        TRACE_(d3d_perf)("Queue depth: %.1f KiB average, %.1f KiB max over %s submissions.\n",
+                profile->queue_depth_total / 1024.0 / profile->submit_count, profile->queue_depth_max / 1024.0,
+                wine_dbgstr_longlong(profile->submit_count));
+
+    if (profile->events)
+        wined3d_cs_profile_write_trace(profile, wined3d_settings.cs_profile_path);
+
+    heap_free(profile->events);
+    heap_free(profile);
+    cs->profile = NULL;
+}
+
 struct wined3d_cs *wined3d_cs_create(struct wined3d_device *device,
         const enum wined3d_feature_level *levels, unsigned int level_count)
 {
@@ -3580,6 +3944,8 @@ struct wined3d_cs *wined3d_cs_create(struct wined3d_device *device,
         ERR_(d3d_sync)("Forcing serialization of all command streams.\n");
 
     state_init(&cs->state, d3d_info, WINED3D_STATE_NO_REF | WINED3D_STATE_INIT_DEFAULT, cs->c.state->feature_level);
+    InitializeSListHead(&cs->chunk_pool);
+    wined3d_cs_profile_create(cs);
 
     cs->data_size = WINED3D_INITIAL_CS_SIZE;
     if (!(cs->data = heap_alloc(cs->data_size)))
@@ -3647,6 +4013,7 @@ struct wined3d_cs *wined3d_cs_create(struct wined3d_device *device,
     return cs;
 
 fail:
+    wined3d_cs_profile_destroy(cs);
     wined3d_state_destroy(cs->c.state);
     state_cleanup(&cs->state);
     heap_free(cs);
@@ -3655,6 +4022,8 @@ fail:
 
 void wined3d_cs_destroy(struct wined3d_cs *cs)
 {
+    SLIST_ENTRY *entry, *next;
+
     if (cs->thread)
     {
         wined3d_cs_emit_stop(cs);
@@ -3665,6 +4034,14 @@ void wined3d_cs_destroy(struct wined3d_cs *cs)
             ERR("Closing event failed.\n");
     }
 
+    for (entry = InterlockedFlushSList(&cs->chunk_pool); entry; entry = next)
+    {
+        next = entry->Next;
+        heap_free(CONTAINING_RECORD(entry, struct wined3d_cs_chunk, entry));
+    }
+
+    wined3d_cs_profile_destroy(cs);
+
     wined3d_state_destroy(cs->c.state);
     state_cleanup(&cs->state);
     heap_free(cs->data);
@@ -3912,6 +4289,18 @@ static void wined3d_cs_packet_decref_objects(const struct wined3d_cs_packet *pac
     }
 }
 
+static void wined3d_cs_chunks_decref_objects(const struct wined3d_cs_chunk *chunk)
+{
+    SIZE_T offset;
+
+    for (; chunk; chunk = chunk->next)
+    {
+        offset = 0;
+        while (offset < chunk->size)
+            wined3d_cs_packet_decref_objects(wined3d_next_cs_packet(chunk->data, &offset, ~(SIZE_T)0));
+    }
+}
+
 static void wined3d_cs_packet_incref_objects(struct wined3d_cs_packet *packet)
 {
     enum wined3d_cs_op opcode = *(const enum wined3d_cs_op *)packet->data;
@@ -4157,8 +4546,9 @@ struct wined3d_deferred_context
 {
     struct wined3d_device_context c;
 
-    SIZE_T data_size, data_capacity;
-    void *data;
+    /* Packets are appended to "tail"; "chunks" is handed over to the command
+     * list as a whole when recording finishes. */
+    struct wined3d_cs_chunk *chunks, *tail;
 
     SIZE_T resource_count, resources_capacity;
     struct wined3d_resource **resources;
@@ -4188,6 +4578,7 @@ static void *wined3d_deferred_context_require_space(struct wined3d_device_contex
         size_t size, enum wined3d_cs_queue_id queue_id)
 {
     struct wined3d_deferred_context *deferred = wined3d_deferred_context_from_context(context);
+    struct wined3d_cs_chunk *chunk = deferred->tail;
     struct wined3d_cs_packet *packet;
     size_t header_size, packet_size;
 
@@ -4198,11 +4589,19 @@ static void *wined3d_deferred_context_require_space(struct wined3d_device_contex
     packet_size = offsetof(struct wined3d_cs_packet, data[size]);
     packet_size = (packet_size + header_size - 1) & ~(header_size - 1);
 
-    if (!wined3d_array_reserve(&deferred->data, &deferred->data_capacity, deferred->data_size + packet_size, 1))
-        return NULL;
+    if (!chunk || chunk->capacity - chunk->size < packet_size)
+    {
+        if (!(chunk = wined3d_cs_chunk_create(context->device->cs, packet_size)))
+            return NULL;
+        if (deferred->tail)
+            deferred->tail->next = chunk;
+        else
+            deferred->chunks = chunk;
+        deferred->tail = chunk;
+    }
 
-    packet = (struct wined3d_cs_packet *)((BYTE *)deferred->data + deferred->data_size);
-    TRACE("size was %Iu, adding %Iu\n", (size_t)deferred->data_size, packet_size);
+    packet = (struct wined3d_cs_packet *)&chunk->data[chunk->size];
+    TRACE("size was %Iu, adding %Iu\n", (size_t)chunk->size, packet_size);
     packet->size = packet_size - header_size;
     return &packet->data;
 }
@@ -4213,7 +4612,7 @@ static void wined3d_deferred_context_submit(struct wined3d_device_context *conte
     struct wined3d_cs_packet *packet;
 
     assert(queue_id == WINED3D_CS_QUEUE_DEFAULT);
-    packet = wined3d_next_cs_packet(deferred->data, &deferred->data_size, ~(SIZE_T)0);
+    packet = wined3d_next_cs_packet(deferred->tail->data, &deferred->tail->size, ~(SIZE_T)0);
     wined3d_cs_packet_incref_objects(packet);
 }
 
@@ -4287,7 +4686,7 @@ static bool wined3d_deferred_context_map_upload_bo(struct wined3d_device_context
     upload = &deferred->uploads[deferred->upload_count++];
 
     if ((flags & WINED3D_MAP_DISCARD)
-            && device->adapter->adapter_ops->adapter_alloc_bo(device, resource, sub_resource_idx, &addr))
+            && device->adapter->adapter_ops->adapter_alloc_bo(device, resource, sub_resource_idx, false, &addr))
     {
         upload->bo = addr.buffer_object;
         upload->sysmem = NULL;
@@ -4460,8 +4859,7 @@ HRESULT CDECL wined3d_deferred_context_create(struct wined3d_device *device, str
 void CDECL wined3d_deferred_context_destroy(struct wined3d_device_context *context)
 {
     struct wined3d_deferred_context *deferred = wined3d_deferred_context_from_context(context);
-    const struct wined3d_cs_packet *packet;
-    SIZE_T i, offset = 0;
+    SIZE_T i;
 
     TRACE("context %p.\n", context);
 
@@ -4494,14 +4892,10 @@ void CDECL wined3d_deferred_context_destroy(struct wined3d_device_context *conte
         wined3d_query_decref(deferred->queries[i].query);
     heap_free(deferred->queries);
 
-    while (offset < deferred->data_size)
-    {
-        packet = wined3d_next_cs_packet(deferred->data, &offset, ~(SIZE_T)0);
-        wined3d_cs_packet_decref_objects(packet);
-    }
+    wined3d_cs_chunks_decref_objects(deferred->chunks);
+    wined3d_cs_chunks_destroy(context->device->cs, deferred->chunks);
 
     wined3d_state_destroy(deferred->c.state);
-    heap_free(deferred->data);
     heap_free(deferred);
 }
 
@@ -4518,8 +4912,7 @@ HRESULT CDECL wined3d_deferred_context_record_command_list(struct wined3d_device
     memory = heap_alloc(sizeof(*object) + deferred->resource_count * sizeof(*object->resources)
             + deferred->upload_count * sizeof(*object->uploads)
             + deferred->command_list_count * sizeof(*object->command_lists)
-            + deferred->query_count * sizeof(*object->queries)
-            + deferred->data_size);
+            + deferred->query_count * sizeof(*object->queries));
 
     if (!memory)
     {
@@ -4558,11 +4951,11 @@ HRESULT CDECL wined3d_deferred_context_record_command_list(struct wined3d_device
     memcpy(object->queries, deferred->queries, deferred->query_count * sizeof(*object->queries));
     /* Transfer our references to the queries to the command list. */
 
-    object->data = memory;
-    object->data_size = deferred->data_size;
-    memcpy(object->data, deferred->data, deferred->data_size);
+    wined3d_cs_chunks_trim(context->device->cs, &deferred->chunks);
+    object->chunks = deferred->chunks;
+    /* Transfer the recorded packets to the command list. */
 
-    deferred->data_size = 0;
+    deferred->chunks = deferred->tail = NULL;
     deferred->resource_count = 0;
     deferred->upload_count = 0;
     deferred->command_list_count = 0;
@@ -4624,6 +5017,7 @@ static void wined3d_command_list_destroy_object(void *object)
         }
     }
 
+    wined3d_cs_chunks_destroy(list->device->cs, list->chunks);
     heap_free(list);
 }
 
@@ -4640,8 +5034,7 @@ ULONG CDECL wined3d_command_list_decref(struct wined3d_command_list *list)
 {
     unsigned int refcount = InterlockedDecrement(&list->refcount);
     struct wined3d_device *device = list->device;
-    const struct wined3d_cs_packet *packet;
-    SIZE_T i, offset;
+    SIZE_T i;
 
     TRACE("%p decreasing refcount to %u.\n", list, refcount);
 
@@ -4656,12 +5049,7 @@ ULONG CDECL wined3d_command_list_decref(struct wined3d_command_list *list)
         for (i = 0; i < list->query_count; ++i)
             wined3d_query_decref(list->queries[i].query);
 
-        offset = 0;
-        while (offset < list->data_size)
-        {
-            packet = wined3d_next_cs_packet(list->data, &offset, ~(SIZE_T)0);
-            wined3d_cs_packet_decref_objects(packet);
-        }
+        wined3d_cs_chunks_decref_objects(list->chunks);
 
         wined3d_mutex_lock();
         wined3d_cs_destroy_object(device->cs, wined3d_command_list_destroy_object, list);
@@ -1253,10 +1253,16 @@ static void wined3d_allocator_gl_destroy_chunk(struct wined3d_allocator_chunk *c
     context_release(&context_gl->c);
 }
 
+static void *wined3d_allocator_gl_map_chunk(struct wined3d_allocator_chunk *chunk, struct wined3d_context *context)
+{
+    return wined3d_allocator_chunk_gl_map(wined3d_allocator_chunk_gl(chunk), wined3d_context_gl(context));
+}
+
 static const struct wined3d_allocator_ops wined3d_allocator_gl_ops =
 {
     .allocator_create_chunk = wined3d_allocator_gl_create_chunk,
     .allocator_destroy_chunk = wined3d_allocator_gl_destroy_chunk,
+    .allocator_map_chunk = wined3d_allocator_gl_map_chunk,
 };
 
 static const struct
@@ -1296,7 +1302,7 @@ GLbitfield wined3d_device_gl_get_memory_type_flags(unsigned int memory_type_idx)
 }
 
 static struct wined3d_allocator_block *wined3d_device_gl_allocate_memory(struct wined3d_device_gl *device_gl,
-        struct wined3d_context_gl *context_gl, unsigned int memory_type, GLsizeiptr size, GLuint *id)
+        struct wined3d_context_gl *context_gl, unsigned int memory_type, GLsizeiptr size, bool stream, GLuint *id)
 {
     struct wined3d_allocator *allocator = &device_gl->allocator;
     struct wined3d_allocator_block *block;
@@ -1311,7 +1317,12 @@ static struct wined3d_allocator_block *wined3d_device_gl_allocate_memory(struct
         return NULL;
     }
 
-    if (!(block = wined3d_allocator_allocate(allocator, context_gl ? &context_gl->c : NULL, memory_type, size)))
+    if (stream)
+        block = wined3d_allocator_allocate_stream(allocator, context_gl ? &context_gl->c : NULL, memory_type, size);
+    else
+        block = wined3d_allocator_allocate(allocator, context_gl ? &context_gl->c : NULL, memory_type, size);
+
+    if (!block)
     {
         wined3d_device_gl_allocator_unlock(device_gl);
         *id = 0;
@@ -1351,8 +1362,9 @@ static bool use_buffer_chunk_suballocation(struct wined3d_device_gl *device_gl,
     }
 }
 
-bool wined3d_device_gl_create_bo(struct wined3d_device_gl *device_gl, struct wined3d_context_gl *context_gl,
-        GLsizeiptr size, GLenum binding, GLenum usage, bool coherent, GLbitfield flags, struct wined3d_bo_gl *bo)
+static bool wined3d_device_gl_create_buffer_bo(struct wined3d_device_gl *device_gl,
+        struct wined3d_context_gl *context_gl, GLsizeiptr size, GLenum binding, GLenum usage,
+        bool coherent, GLbitfield flags, bool stream, struct wined3d_bo_gl *bo)
 {
     const struct wined3d_gl_info *gl_info = &wined3d_adapter_gl(device_gl->d.adapter)->gl_info;
     unsigned int memory_type_idx = wined3d_device_gl_find_memory_type(flags);
@@ -1360,8 +1372,8 @@ bool wined3d_device_gl_create_bo(struct wined3d_device_gl *device_gl, struct win
     GLsizeiptr buffer_offset = 0;
     GLuint id = 0;
 
-    TRACE("device_gl %p, context_gl %p, size %Iu, binding %#x, usage %#x, coherent %#x, flags %#x, bo %p.\n",
-            device_gl, context_gl, size, binding, usage, coherent, flags, bo);
+    TRACE("device_gl %p, context_gl %p, size %Iu, binding %#x, usage %#x, coherent %#x, flags %#x, stream %#x, bo %p.\n",
+            device_gl, context_gl, size, binding, usage, coherent, flags, stream, bo);
 
     if (gl_info->supported[ARB_BUFFER_STORAGE])
     {
@@ -1380,7 +1392,8 @@ bool wined3d_device_gl_create_bo(struct wined3d_device_gl *device_gl, struct win
         {
             if (use_buffer_chunk_suballocation(device_gl, gl_info, binding))
             {
-                if ((memory = wined3d_device_gl_allocate_memory(device_gl, context_gl, memory_type_idx, size, &id)))
+                if ((memory = wined3d_device_gl_allocate_memory(device_gl,
+                        context_gl, memory_type_idx, size, stream, &id)))
                     buffer_offset = memory->offset;
                 else if (!context_gl)
                     WARN_(d3d_perf)("Failed to suballocate buffer from the client thread.\n");
@@ -1447,6 +1460,20 @@ bool wined3d_device_gl_create_bo(struct wined3d_device_gl *device_gl, struct win
     return true;
 }
 
+bool wined3d_device_gl_create_bo(struct wined3d_device_gl *device_gl, struct wined3d_context_gl *context_gl,
+        GLsizeiptr size, GLenum binding, GLenum usage, bool coherent, GLbitfield flags, struct wined3d_bo_gl *bo)
+{
+    return wined3d_device_gl_create_buffer_bo(device_gl, context_gl, size, binding, usage, coherent, flags, false, bo);
+}
+
+/* Upload buffers for DISCARD maps on the immediate context are short-lived,
+ * and are sub-allocated from the allocator's streaming chunks. */
+bool wined3d_device_gl_create_stream_bo(struct wined3d_device_gl *device_gl, GLsizeiptr size,
+        GLenum binding, GLenum usage, bool coherent, GLbitfield flags, struct wined3d_bo_gl *bo)
+{
+    return wined3d_device_gl_create_buffer_bo(device_gl, NULL, size, binding, usage, coherent, flags, true, bo);
+}
+
 void wined3d_device_gl_delete_opengl_contexts_cs(void *object)
 {
     struct wined3d_device_gl *device_gl = object;
@@ -3012,7 +3012,7 @@ static void adapter_no3d_flush_bo_address(struct wined3d_context *context,
 }
 
 static bool adapter_no3d_alloc_bo(struct wined3d_device *device, struct wined3d_resource *resource,
-        unsigned int sub_resource_idx, struct wined3d_bo_address *addr)
+        unsigned int sub_resource_idx, bool stream, struct wined3d_bo_address *addr)
 {
     return false;
 }
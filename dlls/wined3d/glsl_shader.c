@@ -37,6 +37,7 @@
 
 WINE_DEFAULT_DEBUG_CHANNEL(d3d_shader);
 WINE_DECLARE_DEBUG_CHANNEL(d3d);
+WINE_DECLARE_DEBUG_CHANNEL(d3d_perf);
 WINE_DECLARE_DEBUG_CHANNEL(winediag);
 
 #define WINED3D_GLSL_SAMPLE_PROJECTED   0x01
@@ -138,6 +139,10 @@ struct shader_glsl_priv
     struct wine_rb_tree ffp_vertex_shaders;
     struct wine_rb_tree ffp_fragment_shaders;
     BOOL legacy_lighting;
+
+    /* Programs created so far, and the time draws spent waiting for them. */
+    unsigned int program_count;
+    LONGLONG program_stall_ticks;
 };
 
 struct glsl_vs_program
@@ -634,6 +639,138 @@ void shader_glsl_validate_link(const struct wined3d_gl_info *gl_info, GLuint pro
     print_glsl_info_log(gl_info, program, TRUE);
 }
 
+struct shader_glsl_program_source
+{
+    char *text;
+    GLint length;
+};
+
+static int __cdecl shader_glsl_compare_program_source(const void *a, const void *b)
+{
+    const struct shader_glsl_program_source *s1 = a, *s2 = b;
+
+    if (s1->length != s2->length)
+        return s1->length < s2->length ? -1 : 1;
+    return memcmp(s1->text, s2->text, s1->length);
+}
+
+/* Context activation is done by the caller. Returns the heap allocated
+ * program cache key. The key covers the GL implementation, the attached
+ * shader sources, and any pre-link state passed in "flags" that isn't part
+ * of the sources. */
+static void *shader_glsl_get_program_cache_key(const struct wined3d_gl_info *gl_info,
+        GLuint program_id, uint32_t flags, SIZE_T *key_size)
+{
+    struct shader_glsl_program_source sources[WINED3D_SHADER_TYPE_COUNT + 1];
+    GLuint shaders[ARRAY_SIZE(sources)];
+    const char *renderer, *version;
+    GLint i, count, length;
+    uint8_t *key = NULL;
+    SIZE_T size, len;
+
+    if (!(renderer = (const char *)gl_info->gl_ops.gl.p_glGetString(GL_RENDERER)))
+        renderer = "";
+    if (!(version = (const char *)gl_info->gl_ops.gl.p_glGetString(GL_VERSION)))
+        version = "";
+    size = sizeof(flags) + strlen(renderer) + 1 + strlen(version) + 1;
+
+    GL_EXTCALL(glGetAttachedShaders(program_id, ARRAY_SIZE(shaders), &count, shaders));
+    for (i = 0; i < count; ++i)
+    {
+        GL_EXTCALL(glGetShaderiv(shaders[i], GL_SHADER_SOURCE_LENGTH, &length));
+        if (length <= 0 || !(sources[i].text = heap_alloc(length)))
+            goto done;
+        GL_EXTCALL(glGetShaderSource(shaders[i], length, &sources[i].length, sources[i].text));
+        size += sizeof(sources[i].length) + sources[i].length;
+    }
+    checkGLcall("get shader sources");
+
+    /* The order of glGetAttachedShaders() results isn't specified. */
+    qsort(sources, count, sizeof(*sources), shader_glsl_compare_program_source);
+
+    if (!(key = heap_alloc(size)))
+        goto done;
+    *key_size = size;
+    memcpy(key, &flags, sizeof(flags));
+    size = sizeof(flags);
+    len = strlen(renderer) + 1;
+    memcpy(key + size, renderer, len);
+    size += len;
+    len = strlen(version) + 1;
+    memcpy(key + size, version, len);
+    size += len;
+    for (i = 0; i < count; ++i)
+    {
+        memcpy(key + size, &sources[i].length, sizeof(sources[i].length));
+        size += sizeof(sources[i].length);
+        memcpy(key + size, sources[i].text, sources[i].length);
+        size += sources[i].length;
+    }
+
+done:
+    while (i--)
+        heap_free(sources[i].text);
+    return key;
+}
+
+/* Context activation is done by the caller. Links the program, using a
+ * program binary from the on-disk shader cache when one is available. */
+static void shader_glsl_link_program(const struct wined3d_gl_info *gl_info,
+        GLuint program_id, BOOL cacheable, uint32_t flags)
+{
+    SIZE_T size, key_size;
+    GLint status, length;
+    void *key = NULL;
+    GLenum *data;
+
+    if (cacheable && gl_info->supported[ARB_GET_PROGRAM_BINARY] && wined3d_shader_cache_enabled())
+        key = shader_glsl_get_program_cache_key(gl_info, program_id, flags, &key_size);
+
+    if (key && (data = wined3d_shader_cache_load(key, key_size, &size)))
+    {
+        if (size > sizeof(*data))
+        {
+            GL_EXTCALL(glProgramBinary(program_id, *data, data + 1, size - sizeof(*data)));
+            GL_EXTCALL(glGetProgramiv(program_id, GL_LINK_STATUS, &status));
+            checkGLcall("glProgramBinary");
+        }
+        else
+        {
+            status = GL_FALSE;
+        }
+        heap_free(data);
+
+        if (status)
+        {
+            TRACE("Loaded GLSL shader program %u from the shader cache.\n", program_id);
+            heap_free(key);
+            return;
+        }
+        WARN("Failed to load cached binary for program %u.\n", program_id);
+    }
+
+    TRACE("Linking GLSL shader program %u.\n", program_id);
+    if (key)
+        GL_EXTCALL(glProgramParameteri(program_id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+    GL_EXTCALL(glLinkProgram(program_id));
+    shader_glsl_validate_link(gl_info, program_id);
+
+    if (!key)
+        return;
+
+    GL_EXTCALL(glGetProgramiv(program_id, GL_LINK_STATUS, &status));
+    GL_EXTCALL(glGetProgramiv(program_id, GL_PROGRAM_BINARY_LENGTH, &length));
+    if (status && length > 0 && (data = heap_alloc(sizeof(*data) + length)))
+    {
+        GL_EXTCALL(glGetProgramBinary(program_id, length, &length, data, data + 1));
+        checkGLcall("glGetProgramBinary");
+        if (length > 0)
+            wined3d_shader_cache_store(key, key_size, data, sizeof(*data) + length);
+        heap_free(data);
+    }
+    heap_free(key);
+}
+
 static BOOL shader_glsl_use_layout_qualifier(const struct wined3d_gl_info *gl_info)
 {
     /* Layout qualifiers were introduced in GLSL 1.40. The Nvidia Legacy GPU
@@ -6872,6 +7009,7 @@ static void add_glsl_program_entry(struct shader_glsl_priv *priv, struct glsl_sh
     key.ps_id = entry->ps.id;
     key.cs_id = entry->cs.id;
 
+    ++priv->program_count;
     if (wine_rb_put(&priv->program_lookup, &key, &entry->program_lookup_entry) == -1)
     {
         ERR("Failed to insert program entry.\n");
@@ -10196,9 +10334,7 @@ static HRESULT shader_glsl_compile_compute_shader(struct shader_glsl_priv *priv,
 
     list_add_head(&shader->linked_programs, &entry->cs.shader_entry);
 
-    TRACE("Linking GLSL shader program %u.\n", program_id);
-    GL_EXTCALL(glLinkProgram(program_id));
-    shader_glsl_validate_link(gl_info, program_id);
+    shader_glsl_link_program(gl_info, program_id, TRUE, 0);
 
     GL_EXTCALL(glUseProgram(program_id));
     checkGLcall("glUseProgram");
@@ -10526,10 +10662,10 @@ static void set_glsl_shader_program(const struct wined3d_context_gl *context_gl,
         list_add_head(ps_list, &entry->ps.shader_entry);
     }
 
-    /* Link the program */
-    TRACE("Linking GLSL shader program %u.\n", program_id);
-    GL_EXTCALL(glLinkProgram(program_id));
-    shader_glsl_validate_link(gl_info, program_id);
+    /* Link the program. Transform feedback varyings aren't part of the
+     * shader sources, don't cache those programs. */
+    shader_glsl_link_program(gl_info, program_id, !gshader || !gshader->u.gs.so_desc,
+            state->blend_state && state->blend_state->dual_source);
 
     shader_glsl_init_vs_uniform_locations(gl_info, priv, program_id, &entry->vs,
             vshader ? vshader->limits->constant_float : 0);
@@ -10700,17 +10836,33 @@ static void shader_glsl_update_graphics_program(struct shader_glsl_priv *priv,
 {
     struct glsl_context_data *ctx_data = context_gl->c.shader_backend_data;
     const struct wined3d_gl_info *gl_info = context_gl->gl_info;
+    unsigned int program_count = priv->program_count;
     struct glsl_shader_prog_link *glsl_program;
     GLenum current_vertex_color_clamp;
+    LARGE_INTEGER start, end, freq;
     GLuint program_id, prev_id;
 
     priv->vertex_pipe->vp_apply_draw_state(&context_gl->c, state);
     priv->fragment_pipe->fp_apply_draw_state(&context_gl->c, state);
 
+    if (TRACE_ON(d3d_perf))
+        QueryPerformanceCounter(&start);
+
     prev_id = ctx_data->glsl_program ? ctx_data->glsl_program->id : 0;
     set_glsl_shader_program(context_gl, state, priv, ctx_data);
     glsl_program = ctx_data->glsl_program;
 
+    if (TRACE_ON(d3d_perf) && priv->program_count != program_count)
+    {
+        QueryPerformanceCounter(&end);
+        QueryPerformanceFrequency(&freq);
+        priv->program_stall_ticks += end.QuadPart - start.QuadPart;
+        TRACE_(d3d_perf)("Draw stalled for %.3f ms creating GLSL program %u; "
+                "%u programs created, %.3f ms total.\n",
+                (end.QuadPart - start.QuadPart) * 1000.0 / freq.QuadPart, glsl_program ? glsl_program->id : 0,
+                priv->program_count, priv->program_stall_ticks * 1000.0 / freq.QuadPart);
+    }
+
     if (glsl_program)
     {
         program_id = glsl_program->id;
@@ -11150,6 +11302,14 @@ fail:
 static void shader_glsl_free(struct wined3d_device *device, struct wined3d_context *context)
 {
     struct shader_glsl_priv *priv = device->shader_priv;
+    LARGE_INTEGER freq;
+
+    if (TRACE_ON(d3d_perf))
+    {
+        QueryPerformanceFrequency(&freq);
+        TRACE_(d3d_perf)("Created %u GLSL programs, draws stalled for %.3f ms.\n",
+                priv->program_count, priv->program_stall_ticks * 1000.0 / freq.QuadPart);
+    }
 
     wine_rb_destroy(&priv->program_lookup, NULL, NULL);
     constant_heap_free(&priv->pconst_heap);
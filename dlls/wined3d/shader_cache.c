@@ -0,0 +1,370 @@
+/*
+ * Copyright 2026 The Wine Project
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#include "wined3d_private.h"
+
+WINE_DEFAULT_DEBUG_CHANNEL(d3d_shader);
+WINE_DECLARE_DEBUG_CHANNEL(d3d_perf);
+
+/* Increment this when the layout of the cached data changes. */
+#define WINED3D_SHADER_CACHE_VERSION 2
+#define WINED3D_SHADER_CACHE_MAGIC MAKEFOURCC('W','3','S','C')
+#define WINED3D_SHADER_CACHE_HASH_INIT 0xcbf29ce484222325ull
+
+/* An entry is the header, followed by the full key, followed by the data.
+ * The hash of the key only selects the file name; the key itself is compared
+ * on load. */
+struct wined3d_shader_cache_header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key_hash;
+    uint64_t checksum;
+    uint32_t key_size;
+    uint32_t size;
+};
+
+struct wined3d_shader_cache_file
+{
+    FILETIME time;
+    uint64_t size;
+    WCHAR name[MAX_PATH];
+};
+
+static struct
+{
+    BOOL initialised;
+    BOOL enabled;
+    WCHAR path[MAX_PATH];
+    uint64_t max_size;
+    uint64_t total_size;
+    unsigned int hits;
+    unsigned int misses;
+    unsigned int stores;
+    unsigned int evictions;
+} shader_cache;
+
+static CRITICAL_SECTION shader_cache_cs;
+static CRITICAL_SECTION_DEBUG shader_cache_cs_debug =
+{
+    0, 0, &shader_cache_cs,
+    {&shader_cache_cs_debug.ProcessLocksList,
+    &shader_cache_cs_debug.ProcessLocksList},
+    0, 0, {(DWORD_PTR)(__FILE__ ": shader_cache_cs")}
+};
+static CRITICAL_SECTION shader_cache_cs = {&shader_cache_cs_debug, -1, 0, 0, 0, 0};
+
+/* 64-bit FNV-1a. */
+static uint64_t shader_cache_hash(uint64_t hash, const void *data, SIZE_T size)
+{
+    const uint8_t *ptr = data;
+    SIZE_T i;
+
+    for (i = 0; i < size; ++i)
+    {
+        hash ^= ptr[i];
+        hash *= 0x100000001b3ull;
+    }
+
+    return hash;
+}
+
+static uint64_t shader_cache_scan(void)
+{
+    WIN32_FIND_DATAW data;
+    WCHAR pattern[MAX_PATH];
+    uint64_t size = 0;
+    HANDLE find;
+
+    swprintf(pattern, ARRAY_SIZE(pattern), L"%s\\*.bin", shader_cache.path);
+    if ((find = FindFirstFileW(pattern, &data)) == INVALID_HANDLE_VALUE)
+        return 0;
+    do
+    {
+        size += ((uint64_t)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+    } while (FindNextFileW(find, &data));
+    FindClose(find);
+
+    return size;
+}
+
+/* Called with the cache lock held. */
+static BOOL shader_cache_init(void)
+{
+    DWORD len;
+
+    if (shader_cache.initialised)
+        return shader_cache.enabled;
+    shader_cache.initialised = TRUE;
+
+    if (!wined3d_settings.shader_cache_size)
+    {
+        TRACE("Shader cache disabled.\n");
+        return FALSE;
+    }
+
+    if (wined3d_settings.shader_cache_path)
+    {
+        if (!MultiByteToWideChar(CP_ACP, 0, wined3d_settings.shader_cache_path, -1,
+                shader_cache.path, ARRAY_SIZE(shader_cache.path)))
+            return FALSE;
+    }
+    else
+    {
+        if (!(len = GetEnvironmentVariableW(L"LOCALAPPDATA", shader_cache.path, ARRAY_SIZE(shader_cache.path)))
+                || len >= ARRAY_SIZE(shader_cache.path) - 32)
+        {
+            WARN("Failed to get the local application data directory.\n");
+            return FALSE;
+        }
+        wcscat(shader_cache.path, L"\\wined3d_shader_cache");
+    }
+
+    if (!CreateDirectoryW(shader_cache.path, NULL) && GetLastError() != ERROR_ALREADY_EXISTS)
+    {
+        WARN("Failed to create shader cache directory %s, error %lu.\n",
+                debugstr_w(shader_cache.path), GetLastError());
+        return FALSE;
+    }
+
+    shader_cache.max_size = (uint64_t)wined3d_settings.shader_cache_size * 1024 * 1024;
+    shader_cache.total_size = shader_cache_scan();
+    shader_cache.enabled = TRUE;
+
+    TRACE("Using shader cache %s, size %s, limit %s.\n", debugstr_w(shader_cache.path),
+            wine_dbgstr_longlong(shader_cache.total_size), wine_dbgstr_longlong(shader_cache.max_size));
+
+    return TRUE;
+}
+
+static void shader_cache_get_file_name(WCHAR *name, SIZE_T size, uint64_t key_hash)
+{
+    swprintf(name, size, L"%s\\%08x%08x.bin", shader_cache.path,
+            (unsigned int)(key_hash >> 32), (unsigned int)key_hash);
+}
+
+/* Temporary files are private to the writing thread, so that concurrent
+ * writers of the same entry, possibly in different processes, never share
+ * one. */
+static void shader_cache_get_temp_file_name(WCHAR *name, SIZE_T size, uint64_t key_hash)
+{
+    swprintf(name, size, L"%s\\%08x%08x.%lx-%lx.tmp", shader_cache.path,
+            (unsigned int)(key_hash >> 32), (unsigned int)key_hash,
+            GetCurrentProcessId(), GetCurrentThreadId());
+}
+
+static int __cdecl shader_cache_file_compare(const void *a, const void *b)
+{
+    const struct wined3d_shader_cache_file *f1 = a, *f2 = b;
+
+    return CompareFileTime(&f1->time, &f2->time);
+}
+
+/* Remove the least recently used entries until the cache is no larger than
+ * "target". Called with the cache lock held. */
+static void shader_cache_evict(uint64_t target)
+{
+    struct wined3d_shader_cache_file *files = NULL;
+    SIZE_T count = 0, size = 0, i;
+    WIN32_FIND_DATAW data;
+    WCHAR pattern[MAX_PATH];
+    uint64_t total = 0;
+    HANDLE find;
+
+    swprintf(pattern, ARRAY_SIZE(pattern), L"%s\\*.bin", shader_cache.path);
+    if ((find = FindFirstFileW(pattern, &data)) == INVALID_HANDLE_VALUE)
+    {
+        shader_cache.total_size = 0;
+        return;
+    }
+    do
+    {
+        if (!wined3d_array_reserve((void **)&files, &size, count + 1, sizeof(*files)))
+            break;
+        files[count].time = data.ftLastWriteTime;
+        files[count].size = ((uint64_t)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+        swprintf(files[count].name, ARRAY_SIZE(files[count].name), L"%s\\%s", shader_cache.path, data.cFileName);
+        total += files[count++].size;
+    } while (FindNextFileW(find, &data));
+    FindClose(find);
+
+    qsort(files, count, sizeof(*files), shader_cache_file_compare);
+    for (i = 0; i < count && total > target; ++i)
+    {
+        if (!DeleteFileW(files[i].name))
+            continue;
+        total -= files[i].size;
+        ++shader_cache.evictions;
+    }
+    shader_cache.total_size = total;
+
+    heap_free(files);
+}
+
+BOOL wined3d_shader_cache_enabled(void)
+{
+    BOOL ret;
+
+    if (!wined3d_settings.shader_cache_size)
+        return FALSE;
+
+    EnterCriticalSection(&shader_cache_cs);
+    ret = shader_cache_init();
+    LeaveCriticalSection(&shader_cache_cs);
+
+    return ret;
+}
+
+/* Returns a heap allocated copy of the data stored for "key", or NULL. */
+void *wined3d_shader_cache_load(const void *key, SIZE_T key_size, SIZE_T *size)
+{
+    struct wined3d_shader_cache_header header;
+    WCHAR name[MAX_PATH];
+    uint8_t *entry = NULL;
+    uint64_t key_hash;
+    FILETIME now;
+    void *data;
+    HANDLE file;
+    DWORD count;
+
+    EnterCriticalSection(&shader_cache_cs);
+
+    if (!shader_cache_init())
+    {
+        LeaveCriticalSection(&shader_cache_cs);
+        return NULL;
+    }
+
+    key_hash = shader_cache_hash(WINED3D_SHADER_CACHE_HASH_INIT, key, key_size);
+    shader_cache_get_file_name(name, ARRAY_SIZE(name), key_hash);
+    if ((file = CreateFileW(name, GENERIC_READ | FILE_WRITE_ATTRIBUTES, FILE_SHARE_READ | FILE_SHARE_DELETE,
+            NULL, OPEN_EXISTING, 0, NULL)) == INVALID_HANDLE_VALUE)
+    {
+        ++shader_cache.misses;
+        LeaveCriticalSection(&shader_cache_cs);
+        return NULL;
+    }
+
+    if (!ReadFile(file, &header, sizeof(header), &count, NULL) || count != sizeof(header)
+            || header.magic != WINED3D_SHADER_CACHE_MAGIC || header.version != WINED3D_SHADER_CACHE_VERSION
+            || header.key_hash != key_hash || (uint64_t)header.key_size + header.size > UINT_MAX
+            || !(entry = heap_alloc(header.key_size + header.size))
+            || !ReadFile(file, entry, header.key_size + header.size, &count, NULL)
+            || count != header.key_size + header.size
+            || shader_cache_hash(WINED3D_SHADER_CACHE_HASH_INIT, entry, count) != header.checksum)
+    {
+        WARN("Discarding invalid shader cache entry %s.\n", debugstr_w(name));
+        CloseHandle(file);
+        DeleteFileW(name);
+        heap_free(entry);
+        ++shader_cache.misses;
+        LeaveCriticalSection(&shader_cache_cs);
+        return NULL;
+    }
+
+    /* A different key with the same hash. Leave the entry alone; storing the
+     * new key will replace it. */
+    if (header.key_size != key_size || memcmp(entry, key, key_size))
+    {
+        TRACE("Shader cache key collision for %s.\n", debugstr_w(name));
+        CloseHandle(file);
+        heap_free(entry);
+        ++shader_cache.misses;
+        LeaveCriticalSection(&shader_cache_cs);
+        return NULL;
+    }
+
+    /* The last write time is used to find the least recently used entries. */
+    GetSystemTimeAsFileTime(&now);
+    SetFileTime(file, NULL, NULL, &now);
+    CloseHandle(file);
+
+    ++shader_cache.hits;
+    LeaveCriticalSection(&shader_cache_cs);
+
+    memmove(entry, entry + key_size, header.size);
+    if (!(data = heap_realloc(entry, header.size)))
+        data = entry;
+    *size = header.size;
+    return data;
+}
+
+void wined3d_shader_cache_store(const void *key, SIZE_T key_size, const void *data, SIZE_T size)
+{
+    WCHAR name[MAX_PATH], tmp_name[MAX_PATH];
+    struct wined3d_shader_cache_header header;
+    uint64_t file_size;
+    DWORD count;
+    HANDLE file;
+    BOOL ret;
+
+    EnterCriticalSection(&shader_cache_cs);
+
+    file_size = sizeof(header) + key_size + size;
+    if (!shader_cache_init() || key_size + size > UINT_MAX || file_size > shader_cache.max_size / 4)
+    {
+        LeaveCriticalSection(&shader_cache_cs);
+        return;
+    }
+
+    if (shader_cache.total_size + file_size > shader_cache.max_size)
+        shader_cache_evict(shader_cache.max_size / 4 * 3 - file_size);
+
+    header.magic = WINED3D_SHADER_CACHE_MAGIC;
+    header.version = WINED3D_SHADER_CACHE_VERSION;
+    header.key_hash = shader_cache_hash(WINED3D_SHADER_CACHE_HASH_INIT, key, key_size);
+    header.checksum = shader_cache_hash(shader_cache_hash(WINED3D_SHADER_CACHE_HASH_INIT, key, key_size), data, size);
+    header.key_size = key_size;
+    header.size = size;
+
+    /* Write to a temporary file first, so that other processes never see a
+     * partially written entry. */
+    shader_cache_get_temp_file_name(tmp_name, ARRAY_SIZE(tmp_name), header.key_hash);
+    shader_cache_get_file_name(name, ARRAY_SIZE(name), header.key_hash);
+    if ((file = CreateFileW(tmp_name, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, 0, NULL)) == INVALID_HANDLE_VALUE)
+    {
+        LeaveCriticalSection(&shader_cache_cs);
+        return;
+    }
+    ret = WriteFile(file, &header, sizeof(header), &count, NULL) && count == sizeof(header)
+            && WriteFile(file, key, key_size, &count, NULL) && count == key_size
+            && WriteFile(file, data, size, &count, NULL) && count == size;
+    CloseHandle(file);
+
+    if (ret && MoveFileExW(tmp_name, name, MOVEFILE_REPLACE_EXISTING))
+    {
+        shader_cache.total_size += file_size;
+        ++shader_cache.stores;
+    }
+    else
+    {
+        WARN("Failed to write shader cache entry %s.\n", debugstr_w(name));
+        DeleteFileW(tmp_name);
+    }
+
+    LeaveCriticalSection(&shader_cache_cs);
+}
+
+void wined3d_shader_cache_cleanup(void)
+{
+    if (shader_cache.enabled)
+        TRACE_(d3d_perf)("Shader cache: %u hits, %u misses, %u stores, %u evictions, size %s.\n",
+                shader_cache.hits, shader_cache.misses, shader_cache.stores, shader_cache.evictions,
+                wine_dbgstr_longlong(shader_cache.total_size));
+    DeleteCriticalSection(&shader_cache_cs);
+}
@@ -7327,11 +7327,38 @@ static struct wined3d_allocator_block *wined3d_allocator_acquire_block(struct wi
     return block;
 }
 
+static void wined3d_allocator_stream_block_free(struct wined3d_allocator_block *block)
+{
+    struct wined3d_allocator_chunk *chunk = block->chunk;
+
+    /* Blocks are normally freed in the order they were allocated, but that's
+     * not guaranteed. Space is only reclaimed once all older blocks are free
+     * as well. */
+    block->free = true;
+    while (!list_empty(&chunk->stream_blocks))
+    {
+        block = LIST_ENTRY(list_head(&chunk->stream_blocks), struct wined3d_allocator_block, entry);
+        if (!block->free)
+            break;
+        list_remove(&block->entry);
+        wined3d_allocator_release_block(chunk->allocator, block);
+    }
+
+    if (list_empty(&chunk->stream_blocks))
+        chunk->stream_head = 0;
+}
+
 void wined3d_allocator_block_free(struct wined3d_allocator_block *block)
 {
     struct wined3d_allocator *allocator = block->chunk->allocator;
     struct wined3d_allocator_block *parent;
 
+    if (block->chunk->stream)
+    {
+        wined3d_allocator_stream_block_free(block);
+        return;
+    }
+
     while ((parent = block->parent) && block->sibling->free)
     {
         list_remove(&block->sibling->entry);
@@ -7354,6 +7381,7 @@ static void wined3d_allocator_block_init(struct wined3d_allocator_block *block,
     block->sibling = sibling;
     block->order = order;
     block->offset = offset;
+    block->size = WINED3D_ALLOCATOR_CHUNK_SIZE >> order;
     block->free = free;
 }
 
@@ -7362,7 +7390,7 @@ void wined3d_allocator_chunk_cleanup(struct wined3d_allocator_chunk *chunk)
     struct wined3d_allocator_block *block;
     size_t i;
 
-    if (list_empty(&chunk->available[0]))
+    if (list_empty(&chunk->available[0]) || !list_empty(&chunk->stream_blocks))
     {
         ERR("Chunk %p is not empty.\n", chunk);
         return;
@@ -7399,6 +7427,9 @@ bool wined3d_allocator_chunk_init(struct wined3d_allocator_chunk *chunk, struct
     chunk->allocator = allocator;
     chunk->map_count = 0;
     chunk->map_ptr = NULL;
+    chunk->stream = false;
+    chunk->stream_head = 0;
+    list_init(&chunk->stream_blocks);
 
     return true;
 }
@@ -7416,6 +7447,8 @@ void wined3d_allocator_cleanup(struct wined3d_allocator *allocator)
             list_remove(&chunk->entry);
             allocator->ops->allocator_destroy_chunk(chunk);
         }
+        if (allocator->pools[i].stream_chunk)
+            allocator->ops->allocator_destroy_chunk(allocator->pools[i].stream_chunk);
     }
     heap_free(allocator->pools);
 
@@ -7474,13 +7507,89 @@ static struct wined3d_allocator_block *wined3d_allocator_chunk_allocate(struct w
     return block;
 }
 
+static struct wined3d_allocator_chunk *wined3d_allocator_create_stream_chunk(struct wined3d_allocator *allocator,
+        struct wined3d_context *context, unsigned int memory_type)
+{
+    struct wined3d_allocator_pool *pool = &allocator->pools[memory_type];
+    struct wined3d_allocator_chunk *chunk;
+
+    if (!(chunk = allocator->ops->allocator_create_chunk(allocator,
+            context, memory_type, WINED3D_ALLOCATOR_CHUNK_SIZE)))
+    {
+        pool->stream_requested = false;
+        return NULL;
+    }
+
+    /* allocator_create_chunk() adds the chunk to the pool; take it out again,
+     * so that it isn't used for regular allocations. */
+    list_remove(&chunk->entry);
+    list_init(&chunk->entry);
+    chunk->stream = true;
+    pool->stream_chunk = chunk;
+
+    /* Stream allocations are mostly made from the client thread, which can't
+     * map GL chunks. Map the chunk here, and keep it mapped until it's
+     * destroyed. */
+    if (!allocator->ops->allocator_map_chunk(chunk, context))
+        WARN("Failed to map stream chunk %p.\n", chunk);
+
+    TRACE("Created stream chunk %p for memory type %u.\n", chunk, memory_type);
+
+    return chunk;
+}
+
+static struct wined3d_allocator_block *wined3d_allocator_chunk_allocate_stream(
+        struct wined3d_allocator_chunk *chunk, size_t size)
+{
+    struct wined3d_allocator_block *block, *first, *last;
+    size_t offset = chunk->stream_head;
+
+    /* Keep the same alignment guarantees as the buddy allocator. */
+    size = align(size, WINED3D_ALLOCATOR_MIN_BLOCK_SIZE);
+
+    if (!list_empty(&chunk->stream_blocks))
+    {
+        first = LIST_ENTRY(list_head(&chunk->stream_blocks), struct wined3d_allocator_block, entry);
+        last = LIST_ENTRY(list_tail(&chunk->stream_blocks), struct wined3d_allocator_block, entry);
+
+        if (last->offset < first->offset)
+        {
+            /* Wrapped around; the free space is between the head and the
+             * oldest block. */
+            if (first->offset - offset < size)
+                return NULL;
+        }
+        else if (WINED3D_ALLOCATOR_CHUNK_SIZE - offset < size)
+        {
+            if (first->offset < size)
+                return NULL;
+            offset = 0;
+        }
+    }
+
+    if (!(block = wined3d_allocator_acquire_block(chunk->allocator)))
+        return NULL;
+    wined3d_allocator_block_init(block, chunk, NULL, NULL, 0, offset, false);
+    block->size = size;
+    list_add_tail(&chunk->stream_blocks, &block->entry);
+    chunk->stream_head = offset + size;
+
+    return block;
+}
+
 struct wined3d_allocator_block *wined3d_allocator_allocate(struct wined3d_allocator *allocator,
         struct wined3d_context *context, unsigned int memory_type, size_t size)
 {
+    struct wined3d_allocator_pool *pool = &allocator->pools[memory_type];
     struct wined3d_allocator_chunk *chunk;
     struct wined3d_allocator_block *block;
     unsigned int order;
 
+    /* Streaming chunks may have been requested from a thread that couldn't
+     * create them. */
+    if (context && pool->stream_requested && !pool->stream_chunk)
+        wined3d_allocator_create_stream_chunk(allocator, context, memory_type);
+
     if (size > WINED3D_ALLOCATOR_CHUNK_SIZE / 2)
         return NULL;
 
@@ -7505,6 +7614,34 @@ struct wined3d_allocator_block *wined3d_allocator_allocate(struct wined3d_alloca
     return block;
 }
 
+/* Streaming allocations are short-lived uploads, such as the buffers backing
+ * DISCARD maps. They are freed roughly in allocation order, once the GPU is
+ * done with them, so a ring is a better fit than the buddy allocator. */
+struct wined3d_allocator_block *wined3d_allocator_allocate_stream(struct wined3d_allocator *allocator,
+        struct wined3d_context *context, unsigned int memory_type, size_t size)
+{
+    struct wined3d_allocator_pool *pool = &allocator->pools[memory_type];
+    struct wined3d_allocator_block *block;
+
+    if (size <= WINED3D_ALLOCATOR_STREAM_MAX_SIZE)
+    {
+        if (!pool->stream_chunk)
+        {
+            pool->stream_requested = true;
+            if (context)
+                wined3d_allocator_create_stream_chunk(allocator, context, memory_type);
+        }
+
+        if (pool->stream_chunk && (block = wined3d_allocator_chunk_allocate_stream(pool->stream_chunk, size)))
+        {
+            TRACE("Allocated offset %#Ix from stream chunk %p.\n", block->offset, block->chunk);
+            return block;
+        }
+    }
+
+    return wined3d_allocator_allocate(allocator, context, memory_type, size);
+}
+
 bool wined3d_allocator_init(struct wined3d_allocator *allocator,
         size_t pool_count, const struct wined3d_allocator_ops *allocator_ops)
 {
@@ -7517,6 +7654,8 @@ bool wined3d_allocator_init(struct wined3d_allocator *allocator,
     for (i = 0; i < pool_count; ++i)
     {
         list_init(&allocator->pools[i].chunks);
+        allocator->pools[i].stream_chunk = NULL;
+        allocator->pools[i].stream_requested = false;
     }
 
     allocator->free = NULL;
@@ -84,6 +84,7 @@ enum wined3d_gl_extension
     ARB_FRAMEBUFFER_OBJECT,
     ARB_FRAMEBUFFER_SRGB,
     ARB_GEOMETRY_SHADER4,
+    ARB_GET_PROGRAM_BINARY,
     ARB_GPU_SHADER5,
     ARB_HALF_FLOAT_PIXEL,
     ARB_HALF_FLOAT_VERTEX,
@@ -846,6 +847,9 @@ static inline struct wined3d_allocator_chunk_gl *wined3d_allocator_chunk_gl(stru
     return CONTAINING_RECORD(chunk, struct wined3d_allocator_chunk_gl, c);
 }
 
+void *wined3d_allocator_chunk_gl_map(struct wined3d_allocator_chunk_gl *chunk_gl,
+        struct wined3d_context_gl *context_gl);
+
 struct wined3d_dummy_textures
 {
     GLuint tex_1d;
@@ -919,6 +923,8 @@ static inline void wined3d_allocator_chunk_gl_unlock(struct wined3d_allocator_ch
 bool wined3d_device_gl_create_bo(struct wined3d_device_gl *device_gl,
         struct wined3d_context_gl *context_gl, GLsizeiptr size, GLenum binding,
         GLenum usage, bool coherent, GLbitfield flags, struct wined3d_bo_gl *bo);
+bool wined3d_device_gl_create_stream_bo(struct wined3d_device_gl *device_gl, GLsizeiptr size,
+        GLenum binding, GLenum usage, bool coherent, GLbitfield flags, struct wined3d_bo_gl *bo);
 void wined3d_device_gl_create_primary_opengl_context_cs(void *object);
 void wined3d_device_gl_delete_opengl_contexts_cs(void *object);
 HDC wined3d_device_gl_get_backup_dc(struct wined3d_device_gl *device_gl);
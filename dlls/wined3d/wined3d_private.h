@@ -487,10 +487,18 @@ struct wined3d_settings
     enum wined3d_renderer renderer;
     enum wined3d_shader_backend shader_backend;
     BOOL cb_access_map_w;
+    unsigned int shader_cache_size;
+    char *shader_cache_path;
+    char *cs_profile_path;
 };
 
 extern struct wined3d_settings wined3d_settings;
 
+BOOL wined3d_shader_cache_enabled(void);
+void *wined3d_shader_cache_load(const void *key, SIZE_T key_size, SIZE_T *size);
+void wined3d_shader_cache_store(const void *key, SIZE_T key_size, const void *data, SIZE_T size);
+void wined3d_shader_cache_cleanup(void);
+
 enum wined3d_shader_resource_type
 {
     WINED3D_SHADER_RESOURCE_NONE,
@@ -2553,7 +2561,7 @@ struct wined3d_adapter_ops
     void (*adapter_flush_bo_address)(struct wined3d_context *context,
             const struct wined3d_const_bo_address *data, size_t size);
     bool (*adapter_alloc_bo)(struct wined3d_device *device, struct wined3d_resource *resource,
-            unsigned int sub_resource_idx, struct wined3d_bo_address *addr);
+            unsigned int sub_resource_idx, bool stream, struct wined3d_bo_address *addr);
     void (*adapter_destroy_bo)(struct wined3d_context *context, struct wined3d_bo *bo);
     HRESULT (*adapter_create_swapchain)(struct wined3d_device *device,
             const struct wined3d_swapchain_desc *desc,
@@ -3062,6 +3070,7 @@ static inline struct wined3d_device_no3d *wined3d_device_no3d(struct wined3d_dev
 #define WINED3D_ALLOCATOR_CHUNK_SIZE        (64 * 1024 * 1024)
 #define WINED3D_ALLOCATOR_CHUNK_ORDER_COUNT 15
 #define WINED3D_ALLOCATOR_MIN_BLOCK_SIZE    (WINED3D_ALLOCATOR_CHUNK_SIZE >> (WINED3D_ALLOCATOR_CHUNK_ORDER_COUNT - 1))
+#define WINED3D_ALLOCATOR_STREAM_MAX_SIZE   (WINED3D_ALLOCATOR_CHUNK_SIZE / 8)
 #define WINED3D_SLAB_BO_MIN_OBJECT_ALIGN    16
 #define WINED3D_RETIRED_BO_SIZE_THRESHOLD   (64 * 1024 * 1024)
 
@@ -3072,6 +3081,12 @@ struct wined3d_allocator_chunk
     struct wined3d_allocator *allocator;
     unsigned int map_count;
     void *map_ptr;
+
+    /* Streaming chunks are allocated from linearly, and only hold blocks in
+     * "stream_blocks", in allocation order. */
+    bool stream;
+    size_t stream_head;
+    struct list stream_blocks;
 };
 
 void wined3d_allocator_chunk_cleanup(struct wined3d_allocator_chunk *chunk);
@@ -3085,6 +3100,9 @@ struct wined3d_allocator_block
     struct wined3d_allocator_block *parent, *sibling;
     unsigned int order;
     size_t offset;
+    /* For stream blocks, the aligned allocation size rather than the size
+     * implied by "order". */
+    size_t size;
     bool free;
 };
 
@@ -3093,6 +3111,8 @@ void wined3d_allocator_block_free(struct wined3d_allocator_block *block);
 struct wined3d_allocator_pool
 {
     struct list chunks;
+    struct wined3d_allocator_chunk *stream_chunk;
+    bool stream_requested;
 };
 
 struct wined3d_allocator_ops
@@ -3100,6 +3120,7 @@ struct wined3d_allocator_ops
     struct wined3d_allocator_chunk *(*allocator_create_chunk)(struct wined3d_allocator *allocator,
             struct wined3d_context *context, unsigned int memory_type, size_t chunk_size);
     void (*allocator_destroy_chunk)(struct wined3d_allocator_chunk *chunk);
+    void *(*allocator_map_chunk)(struct wined3d_allocator_chunk *chunk, struct wined3d_context *context);
 };
 
 struct wined3d_allocator
@@ -3112,6 +3133,8 @@ struct wined3d_allocator
 
 struct wined3d_allocator_block *wined3d_allocator_allocate(struct wined3d_allocator *allocator,
         struct wined3d_context *context, unsigned int memory_type, size_t size);
+struct wined3d_allocator_block *wined3d_allocator_allocate_stream(struct wined3d_allocator *allocator,
+        struct wined3d_context *context, unsigned int memory_type, size_t size);
 void wined3d_allocator_cleanup(struct wined3d_allocator *allocator);
 bool wined3d_allocator_init(struct wined3d_allocator *allocator,
         size_t pool_count, const struct wined3d_allocator_ops *allocator_ops);
@@ -3622,6 +3645,11 @@ struct wined3d_cs
     struct list query_poll_list;
     BOOL queries_flushed;
 
+    /* Recycled packet storage for deferred contexts and command lists. */
+    SLIST_HEADER chunk_pool;
+    /* Only allocated when profiling is enabled. */
+    struct wined3d_cs_profile *profile;
+
     HANDLE event, present_event;
     LONG waiting_for_event;
     LONG waiting_for_present;
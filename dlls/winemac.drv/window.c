@@ -1980,7 +1980,7 @@ BOOL macdrv_UpdateLayeredWindow(HWND hwnd, const UPDATELAYEREDWINDOWINFO *info,
         {
             surface->funcs->lock(surface);
             memcpy(dst_bits, src_bits, bmi->bmiHeader.biSizeImage);
-            add_bounds_rect(surface->funcs->get_bounds(surface), &rect);
+            window_surface_add_bounds(surface, &rect);
             surface->funcs->unlock(surface);
             surface->funcs->flush(surface);
         }
@@ -1578,6 +1578,7 @@ struct x11drv_window_surface
     GC                    gc;
     XImage               *image;
     RECT                  bounds;
+    struct window_surface_damage damage;
     BOOL                  byteswap;
     BOOL                  is_argb;
     DWORD                 alpha_bits;
@@ -1869,6 +1870,16 @@ static RECT *x11drv_surface_get_bounds( struct window_surface *window_surface )
     return &surface->bounds;
 }
 
+/***********************************************************************
+ *           x11drv_surface_get_damage
+ */
+static struct window_surface_damage *x11drv_surface_get_damage( struct window_surface *window_surface )
+{
+    struct x11drv_window_surface *surface = get_x11_surface( window_surface );
+
+    return &surface->damage;
+}
+
 /***********************************************************************
  *           x11drv_surface_set_region
  */
@@ -1908,62 +1919,67 @@ static void x11drv_surface_flush( struct window_surface *window_surface )
     struct x11drv_window_surface *surface = get_x11_surface( window_surface );
     unsigned char *src = surface->bits;
     unsigned char *dst = (unsigned char *)surface->image->data;
-    struct bitblt_coords coords;
+    int width_bytes = surface->image->bytes_per_line;
+    const RECT *rects;
+    RECT rect, visrect;
+    UINT i, count, flushed = 0;
 
     window_surface->funcs->lock( window_surface );
-    coords.x = 0;
-    coords.y = 0;
-    coords.width  = surface->header.rect.right - surface->header.rect.left;
-    coords.height = surface->header.rect.bottom - surface->header.rect.top;
-    SetRect( &coords.visrect, 0, 0, coords.width, coords.height );
-    if (intersect_rect( &coords.visrect, &coords.visrect, &surface->bounds ))
+    SetRect( &visrect, 0, 0, surface->header.rect.right - surface->header.rect.left,
+             surface->header.rect.bottom - surface->header.rect.top );
+    count = window_surface_get_damage_rects( &surface->damage, &surface->bounds, &rects );
+    if (count && intersect_rect( &rect, &visrect, &surface->bounds ))
     {
-        TRACE( "flushing %p %dx%d bounds %s bits %p\n",
-               surface, coords.width, coords.height,
-               wine_dbgstr_rect( &surface->bounds ), surface->bits );
+        TRACE( "flushing %p %dx%d bounds %s %u rects bits %p\n",
+               surface, (int)visrect.right, (int)visrect.bottom,
+               wine_dbgstr_rect( &surface->bounds ), count, surface->bits );
 
         if (surface->is_argb || surface->color_key != CLR_INVALID) update_surface_region( surface );
 
-        if (src != dst)
-        {
-            int map[256], *mapping = get_window_surface_mapping( surface->image->bits_per_pixel, map );
-            int width_bytes = surface->image->bytes_per_line;
-
-            src += coords.visrect.top * width_bytes;
-            dst += coords.visrect.top * width_bytes;
-            copy_image_byteswap( &surface->info, src, dst, width_bytes, width_bytes,
-                                 coords.visrect.bottom - coords.visrect.top,
-                                 surface->byteswap, mapping, ~0u, surface->alpha_bits );
-        }
-        else if (surface->alpha_bits)
+        for (i = 0; i < count; i++)
         {
-            int x, y, stride = surface->image->bytes_per_line / sizeof(ULONG);
-            ULONG *ptr = (ULONG *)dst + coords.visrect.top * stride;
+            if (!intersect_rect( &rect, &visrect, &rects[i] )) continue;
 
-            for (y = coords.visrect.top; y < coords.visrect.bottom; y++, ptr += stride)
-                for (x = coords.visrect.left; x < coords.visrect.right; x++)
-                    ptr[x] |= surface->alpha_bits;
-        }
+            if (src != dst)
+            {
+                int map[256], *mapping = get_window_surface_mapping( surface->image->bits_per_pixel, map );
+
+                copy_image_byteswap( &surface->info, src + rect.top * width_bytes, dst + rect.top * width_bytes,
+                                     width_bytes, width_bytes, rect.bottom - rect.top,
+                                     surface->byteswap, mapping, ~0u, surface->alpha_bits );
+            }
+            else if (surface->alpha_bits)
+            {
+                int x, y, stride = width_bytes / sizeof(ULONG);
+                ULONG *ptr = (ULONG *)dst + rect.top * stride;
+
+                for (y = rect.top; y < rect.bottom; y++, ptr += stride)
+                    for (x = rect.left; x < rect.right; x++)
+                        ptr[x] |= surface->alpha_bits;
+            }
 
 #ifdef HAVE_LIBXXSHM
-        if (surface->shminfo.shmid != -1)
-            XShmPutImage( gdi_display, surface->window, surface->gc, surface->image,
-                          coords.visrect.left, coords.visrect.top,
-                          surface->header.rect.left + coords.visrect.left,
-                          surface->header.rect.top + coords.visrect.top,
-                          coords.visrect.right - coords.visrect.left,
-                          coords.visrect.bottom - coords.visrect.top, False );
-        else
+            if (surface->shminfo.shmid != -1)
+                XShmPutImage( gdi_display, surface->window, surface->gc, surface->image,
+                              rect.left, rect.top,
+                              surface->header.rect.left + rect.left, surface->header.rect.top + rect.top,
+                              rect.right - rect.left, rect.bottom - rect.top, False );
+            else
 #endif
-        XPutImage( gdi_display, surface->window, surface->gc, surface->image,
-                   coords.visrect.left, coords.visrect.top,
-                   surface->header.rect.left + coords.visrect.left,
-                   surface->header.rect.top + coords.visrect.top,
-                   coords.visrect.right - coords.visrect.left,
-                   coords.visrect.bottom - coords.visrect.top );
+            XPutImage( gdi_display, surface->window, surface->gc, surface->image,
+                       rect.left, rect.top,
+                       surface->header.rect.left + rect.left, surface->header.rect.top + rect.top,
+                       rect.right - rect.left, rect.bottom - rect.top );
+            flushed += (rect.right - rect.left) * surface->image->bits_per_pixel / 8 * (rect.bottom - rect.top);
+        }
         XFlush( gdi_display );
+
+        intersect_rect( &rect, &visrect, &surface->bounds );
+        TRACE( "flushed %u bytes, %u for bounds\n", flushed,
+               (rect.right - rect.left) * surface->image->bits_per_pixel / 8 * (rect.bottom - rect.top) );
     }
     reset_bounds( &surface->bounds );
+    surface->damage.count = 0;
     window_surface->funcs->unlock( window_surface );
 }
 
@@ -2003,7 +2019,8 @@ static const struct window_surface_funcs x11drv_surface_funcs =
     x11drv_surface_get_bounds,
     x11drv_surface_set_region,
     x11drv_surface_flush,
-    x11drv_surface_destroy
+    x11drv_surface_destroy,
+    x11drv_surface_get_damage
 };
 
 /***********************************************************************
@@ -2106,6 +2123,7 @@ HRGN expose_surface( struct window_surface *window_surface, const RECT *rect )
     window_surface->funcs->lock( window_surface );
     OffsetRect( &rc, -window_surface->rect.left, -window_surface->rect.top );
     add_bounds_rect( &surface->bounds, &rc );
+    window_surface_add_damage( &surface->damage, &rc );
     if (surface->region)
     {
         region = NtGdiCreateRectRgn( rect->left, rect->top, rect->right, rect->bottom );
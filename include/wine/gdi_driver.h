@@ -177,7 +177,7 @@ struct gdi_dc_funcs
 };
 
 /* increment this when you change the DC function table */
-#define WINE_GDI_DRIVER_VERSION 83
+#define WINE_GDI_DRIVER_VERSION 84
 
 #define GDI_PRIORITY_NULL_DRV        0  /* null driver */
 #define GDI_PRIORITY_FONT_DRV      100  /* any font driver */
@@ -207,6 +207,15 @@ static inline void push_dc_driver( PHYSDEV *dev, PHYSDEV physdev, const struct g
 
 struct window_surface;
 
+#define WINDOW_SURFACE_MAX_DAMAGE 8
+
+/* damaged rectangles of a window surface, in surface coordinates */
+struct window_surface_damage
+{
+    UINT count;
+    RECT rects[WINDOW_SURFACE_MAX_DAMAGE];
+};
+
 struct window_surface_funcs
 {
     void  (*lock)( struct window_surface *surface );
@@ -216,6 +225,8 @@ struct window_surface_funcs
     void  (*set_region)( struct window_surface *surface, HRGN region );
     void  (*flush)( struct window_surface *surface );
     void  (*destroy)( struct window_surface *surface );
+    /* optional, list of damaged rectangles accumulated along with the bounds */
+    struct window_surface_damage* (*get_damage)( struct window_surface *surface );
 };
 
 struct window_surface
@@ -362,5 +373,9 @@ W32KAPI void __wine_set_user_driver( const struct user_driver_funcs *funcs, UINT
 
 W32KAPI BOOL win32u_set_window_pixel_format( HWND hwnd, int format, BOOL internal );
 W32KAPI int win32u_get_window_pixel_format( HWND hwnd );
+W32KAPI void window_surface_add_damage( struct window_surface_damage *damage, const RECT *rect );
+W32KAPI void window_surface_add_bounds( struct window_surface *surface, const RECT *rect );
+W32KAPI UINT window_surface_get_damage_rects( const struct window_surface_damage *damage,
+                                              const RECT *bounds, const RECT **rects );
 
 #endif /* __WINE_WINE_GDI_DRIVER_H */
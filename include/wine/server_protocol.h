@@ -344,6 +344,27 @@ typedef union
 } message_data_t;
 
 
+typedef struct
+{
+    user_handle_t   win;
+    unsigned int    msg;
+    lparam_t        wparam;
+    lparam_t        lparam;
+    int             x;
+    int             y;
+    unsigned int    time;
+    int             __pad;
+} posted_message_t;
+#define MAX_PREFETCHED_MESSAGES 16
+
+
+typedef struct
+{
+    unsigned int    wake_bits;
+    unsigned int    __pad;
+} queue_shm_t;
+
+
 struct filesystem_event
 {
     int         action;
@@ -864,6 +885,35 @@ typedef struct
 } cursor_pos_t;
 
 
+typedef struct
+{
+    unsigned int   seq;
+    user_handle_t  handle;
+    process_id_t   pid;
+    thread_id_t    tid;
+    user_handle_t  parent;
+    user_handle_t  owner;
+    unsigned int   style;
+    unsigned int   ex_style;
+    lparam_t       id;
+    mod_handle_t   instance;
+    lparam_t       user_data;
+    rectangle_t    window;
+    rectangle_t    client;
+    unsigned int   dpi;
+    int            __pad;
+} window_shm_t;
+#define WINDOW_SHM_COUNT ((LAST_USER_HANDLE - FIRST_USER_HANDLE + 1) >> 1)
+
+
+typedef struct
+{
+    unsigned int   seq;
+    unsigned int   __pad;
+    window_shm_t   windows[WINDOW_SHM_COUNT];
+} desktop_window_shm_t;
+
+
 
 
 
@@ -2877,6 +2927,9 @@ struct get_message_request
     unsigned int    hw_id;
     unsigned int    wake_mask;
     unsigned int    changed_mask;
+    unsigned int    prefetch;
+    /* VARARG(prefetched,posted_messages); */
+    char __pad_44[4];
 };
 struct get_message_reply
 {
@@ -2891,7 +2944,9 @@ struct get_message_reply
     unsigned int    time;
     unsigned int    active_hooks;
     data_size_t     total;
+    unsigned int    prefetched;
     /* VARARG(data,message_data); */
+    char __pad_60[4];
 };
 
 
@@ -3254,6 +3309,34 @@ struct get_desktop_window_reply
 
 
 
+struct get_queue_shm_request
+{
+    struct request_header __header;
+    char __pad_12[4];
+};
+struct get_queue_shm_reply
+{
+    struct reply_header __header;
+    obj_handle_t   handle;
+    char __pad_12[4];
+};
+
+
+
+struct get_desktop_window_shm_request
+{
+    struct request_header __header;
+    char __pad_12[4];
+};
+struct get_desktop_window_shm_reply
+{
+    struct reply_header __header;
+    obj_handle_t   handle;
+    char __pad_12[4];
+};
+
+
+
 struct set_window_owner_request
 {
     struct request_header __header;
@@ -5766,6 +5849,8 @@ enum request
     REQ_create_window,
     REQ_destroy_window,
     REQ_get_desktop_window,
+    REQ_get_queue_shm,
+    REQ_get_desktop_window_shm,
     REQ_set_window_owner,
     REQ_get_window_info,
     REQ_set_window_info,
@@ -6057,6 +6142,8 @@ union generic_request
     struct create_window_request create_window_request;
     struct destroy_window_request destroy_window_request;
     struct get_desktop_window_request get_desktop_window_request;
+    struct get_queue_shm_request get_queue_shm_request;
+    struct get_desktop_window_shm_request get_desktop_window_shm_request;
     struct set_window_owner_request set_window_owner_request;
     struct get_window_info_request get_window_info_request;
     struct set_window_info_request set_window_info_request;
@@ -6346,6 +6433,8 @@ union generic_reply
     struct create_window_reply create_window_reply;
     struct destroy_window_reply destroy_window_reply;
     struct get_desktop_window_reply get_desktop_window_reply;
+    struct get_queue_shm_reply get_queue_shm_reply;
+    struct get_desktop_window_shm_reply get_desktop_window_shm_reply;
     struct set_window_owner_reply set_window_owner_reply;
     struct get_window_info_reply get_window_info_reply;
     struct set_window_info_reply set_window_info_reply;
@@ -6492,7 +6581,7 @@ union generic_reply
 
 /* ### protocol_version begin ### */
 
-#define SERVER_PROTOCOL_VERSION 793
+#define SERVER_PROTOCOL_VERSION 797
 
 /* ### protocol_version end ### */
 
@@ -2352,6 +2352,8 @@ static ULONG STDMETHODCALLTYPE d3d12_command_list_Release(ID3D12GraphicsCommandL
         vkd3d_pipeline_bindings_cleanup(&list->pipeline_bindings[VKD3D_PIPELINE_BIND_POINT_COMPUTE]);
         vkd3d_pipeline_bindings_cleanup(&list->pipeline_bindings[VKD3D_PIPELINE_BIND_POINT_GRAPHICS]);
 
+        vkd3d_free(list->descriptor_writes);
+        vkd3d_free(list->descriptor_image_infos);
         vkd3d_free(list);
 
         d3d12_device_release(device);
@@ -2839,27 +2841,66 @@ static bool vk_write_descriptor_set_from_d3d12_desc(VkWriteDescriptorSet *vk_des
     return true;
 }
 
+/* Upper bound on the number of descriptor writes accumulated before they are
+ * flushed, so that large or unbounded tables don't grow the arrays without
+ * limit. */
+#define VKD3D_DESCRIPTOR_WRITE_BATCH_SIZE 256u
+
+static bool d3d12_command_list_reserve_descriptor_writes(struct d3d12_command_list *list, size_t count)
+{
+    count = min(count + list->descriptor_write_count, VKD3D_DESCRIPTOR_WRITE_BATCH_SIZE);
+
+    if (!vkd3d_array_reserve((void **)&list->descriptor_writes, &list->descriptor_writes_size,
+            count, sizeof(*list->descriptor_writes))
+            || !vkd3d_array_reserve((void **)&list->descriptor_image_infos, &list->descriptor_image_infos_size,
+            count, sizeof(*list->descriptor_image_infos)))
+    {
+        ERR("Failed to allocate descriptor writes.\n");
+        return false;
+    }
+
+    return true;
+}
+
+/* Writes for all dirty descriptor tables are accumulated and submitted in a
+ * single call, since each vkUpdateDescriptorSets() call has a significant
+ * fixed cost, particularly when it has to cross the PE/Unix boundary. */
+static void d3d12_command_list_flush_descriptor_writes(struct d3d12_command_list *list)
+{
+    const struct vkd3d_vk_device_procs *vk_procs = &list->device->vk_procs;
+    size_t i;
+
+    if (!list->descriptor_write_count)
+        return;
+
+    /* Image infos are stored at the same index as their write. The arrays may
+     * have been reallocated since the writes were recorded. */
+    for (i = 0; i < list->descriptor_write_count; ++i)
+    {
+        if (list->descriptor_writes[i].pImageInfo)
+            list->descriptor_writes[i].pImageInfo = &list->descriptor_image_infos[i];
+    }
+
+    VK_CALL(vkUpdateDescriptorSets(list->device->vk_device, list->descriptor_write_count,
+            list->descriptor_writes, 0, NULL));
+    list->descriptor_write_count = 0;
+}
+
 static void d3d12_command_list_update_descriptor_table(struct d3d12_command_list *list,
         enum vkd3d_pipeline_bind_point bind_point, unsigned int index, struct d3d12_desc *base_descriptor)
 {
     struct vkd3d_pipeline_bindings *bindings = &list->pipeline_bindings[bind_point];
-    struct VkWriteDescriptorSet descriptor_writes[24], *current_descriptor_write;
     const struct d3d12_root_signature *root_signature = bindings->root_signature;
-    const struct vkd3d_vk_device_procs *vk_procs = &list->device->vk_procs;
-    struct VkDescriptorImageInfo image_infos[24], *current_image_info;
     const struct d3d12_root_descriptor_table *descriptor_table;
     const struct d3d12_pipeline_state *state = list->state;
     const struct d3d12_root_descriptor_table_range *range;
-    VkDevice vk_device = list->device->vk_device;
     unsigned int i, j, k, descriptor_count;
     struct d3d12_desc *descriptor;
-    unsigned int write_count = 0;
     bool unbounded = false;
+    size_t write_idx;
 
     descriptor_table = root_signature_get_descriptor_table(root_signature, index);
 
-    current_descriptor_write = descriptor_writes;
-    current_image_info = image_infos;
     for (i = 0; i < descriptor_table->range_count; ++i)
     {
         range = &descriptor_table->ranges[i];
@@ -2883,6 +2924,9 @@ static void d3d12_command_list_update_descriptor_table(struct d3d12_command_list
             }
         }
 
+        if (!d3d12_command_list_reserve_descriptor_writes(list, descriptor_count))
+            return;
+
         for (j = 0; j < descriptor_count; ++j, ++descriptor)
         {
             unsigned int register_idx = range->base_register_idx + j;
@@ -2912,25 +2956,18 @@ static void d3d12_command_list_update_descriptor_table(struct d3d12_command_list
             if (!u.header)
                 continue;
 
-            if (!vk_write_descriptor_set_from_d3d12_desc(current_descriptor_write, current_image_info,
-                    descriptor, range, bindings->descriptor_sets, j, root_signature->use_descriptor_arrays))
-                continue;
+            if (list->descriptor_write_count == VKD3D_DESCRIPTOR_WRITE_BATCH_SIZE)
+                d3d12_command_list_flush_descriptor_writes(list);
 
-            ++write_count;
-            ++current_descriptor_write;
-            ++current_image_info;
+            write_idx = list->descriptor_write_count;
+            if (!vk_write_descriptor_set_from_d3d12_desc(&list->descriptor_writes[write_idx],
+                    &list->descriptor_image_infos[write_idx], descriptor, range, bindings->descriptor_sets,
+                    j, root_signature->use_descriptor_arrays))
+                continue;
 
-            if (write_count == ARRAY_SIZE(descriptor_writes))
-            {
-                VK_CALL(vkUpdateDescriptorSets(vk_device, write_count, descriptor_writes, 0, NULL));
-                write_count = 0;
-                current_descriptor_write = descriptor_writes;
-                current_image_info = image_infos;
-            }
+            ++list->descriptor_write_count;
         }
     }
-
-    VK_CALL(vkUpdateDescriptorSets(vk_device, write_count, descriptor_writes, 0, NULL));
 }
 
 static bool vk_write_descriptor_set_from_root_descriptor(VkWriteDescriptorSet *vk_descriptor_write,
@@ -3114,6 +3151,7 @@ static void d3d12_command_list_update_descriptors(struct d3d12_command_list *lis
                 WARN("Descriptor table %u is not set.\n", i);
         }
     }
+    d3d12_command_list_flush_descriptor_writes(list);
     bindings->descriptor_table_dirty_mask = 0;
 
     d3d12_command_list_update_push_descriptors(list, bind_point);
@@ -3260,8 +3298,8 @@ static void d3d12_command_list_bind_descriptor_heap(struct d3d12_command_list *l
         bindings->sampler_heap_id = heap->serial_id;
     }
 
-    vkd3d_mutex_lock(&heap->vk_sets_mutex);
-
+    /* The Vulkan sets are allocated when the heap is created and never
+     * change, so there is no need to take the heap lock here. */
     for (set = 0; set < ARRAY_SIZE(heap->vk_descriptor_sets); ++set)
     {
         VkDescriptorSet vk_descriptor_set = heap->vk_descriptor_sets[set].vk_set;
@@ -3272,8 +3310,6 @@ static void d3d12_command_list_bind_descriptor_heap(struct d3d12_command_list *l
         VK_CALL(vkCmdBindDescriptorSets(list->vk_command_buffer, bindings->vk_bind_point, rs->vk_pipeline_layout,
                 rs->vk_set_count + set, 1, &vk_descriptor_set, 0, NULL));
     }
-
-    vkd3d_mutex_unlock(&heap->vk_sets_mutex);
 }
 
 static void d3d12_command_list_update_heap_descriptors(struct d3d12_command_list *list,
@@ -6139,6 +6175,11 @@ static HRESULT d3d12_command_list_init(struct d3d12_command_list *list, struct d
     list->update_descriptors = device->use_vk_heaps ? d3d12_command_list_update_heap_descriptors
             : d3d12_command_list_update_descriptors;
     list->descriptor_heap_count = 0;
+    list->descriptor_writes = NULL;
+    list->descriptor_writes_size = 0;
+    list->descriptor_image_infos = NULL;
+    list->descriptor_image_infos_size = 0;
+    list->descriptor_write_count = 0;
 
     if (SUCCEEDED(hr = d3d12_command_allocator_allocate_command_buffer(allocator, list)))
     {
@@ -19,6 +19,14 @@
 #include "vkd3d_private.h"
 #include "vkd3d_version.h"
 
+#include <stdio.h>
+#ifndef _WIN32
+# include <dirent.h>
+# include <errno.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
 #define VKD3D_MAX_UAV_CLEAR_DESCRIPTORS_PER_TYPE 256u
 
 struct vkd3d_struct
@@ -2050,6 +2058,623 @@ static HRESULT vkd3d_create_vk_device(struct d3d12_device *device,
     return hr;
 }
 
+#define VKD3D_PIPELINE_CACHE_MAGIC VKD3D_MAKE_TAG('V', 'K', 'P', 'C')
+/* Increment this when the layout of the serialised data changes. */
+#define VKD3D_PIPELINE_CACHE_VERSION 2
+
+/* Header prepended to Vulkan pipeline cache data, both in the on-disk cache
+ * and in cached PSO blobs. The driver validates its own
+ * data as well, but checking here allows returning the errors d3d12
+ * applications expect when the adapter or driver changed. */
+struct vkd3d_pipeline_cache_header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t vendor_id;
+    uint32_t device_id;
+    uint32_t driver_version;
+    uint32_t padding;
+    uint8_t uuid[VK_UUID_SIZE];
+    uint64_t key;
+    uint64_t data_size;
+    uint64_t checksum;
+};
+
+static void vkd3d_pipeline_cache_header_init(struct vkd3d_pipeline_cache_header *header,
+        struct d3d12_device *device)
+{
+    const struct vkd3d_vk_instance_procs *vk_procs = &device->vkd3d_instance->vk_procs;
+    VkPhysicalDeviceProperties properties;
+
+    VK_CALL(vkGetPhysicalDeviceProperties(device->vk_physical_device, &properties));
+
+    memset(header, 0, sizeof(*header));
+    header->magic = VKD3D_PIPELINE_CACHE_MAGIC;
+    header->version = VKD3D_PIPELINE_CACHE_VERSION;
+    header->vendor_id = properties.vendorID;
+    header->device_id = properties.deviceID;
+    header->driver_version = properties.driverVersion;
+    memcpy(header->uuid, properties.pipelineCacheUUID, sizeof(header->uuid));
+}
+
+static HRESULT vkd3d_pipeline_cache_validate(struct d3d12_device *device, uint64_t key,
+        const void *data, size_t size, const void **cache_data, size_t *cache_size)
+{
+    const struct vkd3d_pipeline_cache_header *header = data;
+    struct vkd3d_pipeline_cache_header expected;
+
+    if (size < sizeof(*header) || header->magic != VKD3D_PIPELINE_CACHE_MAGIC
+            || header->data_size > size - sizeof(*header))
+    {
+        WARN("Invalid pipeline cache data.\n");
+        return E_INVALIDARG;
+    }
+
+    vkd3d_pipeline_cache_header_init(&expected, device);
+    if (header->vendor_id != expected.vendor_id || header->device_id != expected.device_id)
+    {
+        WARN("Pipeline cache was created for device %04x:%04x.\n", header->vendor_id, header->device_id);
+        return D3D12_ERROR_ADAPTER_NOT_FOUND;
+    }
+    if (header->version != expected.version || header->driver_version != expected.driver_version
+            || memcmp(header->uuid, expected.uuid, sizeof(expected.uuid)))
+    {
+        WARN("Pipeline cache was created by a different driver version.\n");
+        return D3D12_ERROR_DRIVER_VERSION_MISMATCH;
+    }
+
+    if (header->key != key)
+    {
+        WARN("Pipeline cache data doesn't match the pipeline state description.\n");
+        return E_INVALIDARG;
+    }
+
+    if (vkd3d_hash_fnv1a(VKD3D_HASH_FNV1A_INIT, header + 1, header->data_size) != header->checksum)
+    {
+        WARN("Pipeline cache checksum mismatch.\n");
+        return E_INVALIDARG;
+    }
+
+    *cache_data = header + 1;
+    *cache_size = header->data_size;
+    return S_OK;
+}
+
+HRESULT d3d12_device_validate_pipeline_cache_data(struct d3d12_device *device,
+        uint64_t key, const void *data, size_t size)
+{
+    const void *cache_data;
+    size_t cache_size;
+
+    return vkd3d_pipeline_cache_validate(device, key, data, size, &cache_data, &cache_size);
+}
+
+/* Serialise "vk_cache". If "data" is NULL, "size" receives the required size.
+ * Otherwise at most "size" bytes are written; the driver returns as much of
+ * the cache as fits. */
+HRESULT d3d12_device_get_pipeline_cache_data(struct d3d12_device *device,
+        VkPipelineCache vk_cache, uint64_t key, void *data, size_t *size)
+{
+    const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
+    struct vkd3d_pipeline_cache_header *header = data;
+    size_t cache_size = 0;
+    VkResult vr;
+
+    if (!data)
+    {
+        if ((vr = VK_CALL(vkGetPipelineCacheData(device->vk_device, vk_cache, &cache_size, NULL))) < 0)
+            return hresult_from_vk_result(vr);
+        *size = sizeof(*header) + cache_size;
+        return S_OK;
+    }
+
+    if (*size < sizeof(*header))
+        return E_INVALIDARG;
+
+    cache_size = *size - sizeof(*header);
+    if ((vr = VK_CALL(vkGetPipelineCacheData(device->vk_device, vk_cache, &cache_size, header + 1))) < 0)
+        return hresult_from_vk_result(vr);
+
+    vkd3d_pipeline_cache_header_init(header, device);
+    header->key = key;
+    header->data_size = cache_size;
+    header->checksum = vkd3d_hash_fnv1a(VKD3D_HASH_FNV1A_INIT, header + 1, cache_size);
+    *size = sizeof(*header) + cache_size;
+
+    return S_OK;
+}
+
+/* Create a pipeline cache, optionally initialised with data serialised by
+ * d3d12_device_get_pipeline_cache_data(). Each pipeline state object has its
+ * own cache, so that its data can be returned by GetCachedBlob(), and so that
+ * initial data never has to be merged into a cache other threads may be
+ * creating pipelines with. */
+HRESULT d3d12_device_create_pipeline_cache(struct d3d12_device *device,
+        uint64_t key, const void *data, size_t size, VkPipelineCache *vk_cache)
+{
+    const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
+    VkPipelineCacheCreateInfo cache_info;
+    const void *cache_data = NULL;
+    size_t cache_size = 0;
+    VkResult vr;
+    HRESULT hr;
+
+    if (size && FAILED(hr = vkd3d_pipeline_cache_validate(device, key, data, size, &cache_data, &cache_size)))
+        return hr;
+
+    cache_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    cache_info.pNext = NULL;
+    cache_info.flags = 0;
+    cache_info.initialDataSize = cache_size;
+    cache_info.pInitialData = cache_data;
+    if ((vr = VK_CALL(vkCreatePipelineCache(device->vk_device, &cache_info, NULL, vk_cache))) < 0)
+    {
+        WARN("Failed to create Vulkan pipeline cache, vr %d.\n", vr);
+        return hresult_from_vk_result(vr);
+    }
+
+    return S_OK;
+}
+
+static bool vkd3d_make_directory(const char *path)
+{
+#ifdef _WIN32
+    return CreateDirectoryA(path, NULL) || GetLastError() == ERROR_ALREADY_EXISTS;
+#else
+    return !mkdir(path, 0777) || errno == EEXIST;
+#endif
+}
+
+/* On-disk caches live in the directory named by "env_name" if set, or in
+ * "subdir" of a "vkd3d" directory in the user's cache directory otherwise.
+ * Setting the environment variable to an empty string disables the cache. */
+static bool vkd3d_get_cache_directory(char dir[PATH_MAX], const char *env_name, const char *subdir)
+{
+    const char *base;
+
+    if ((base = getenv(env_name)))
+    {
+        if (!*base)
+            return false;
+        snprintf(dir, PATH_MAX, "%s", base);
+    }
+    else
+    {
+#ifdef _WIN32
+        if (!(base = getenv("LOCALAPPDATA")))
+            return false;
+        snprintf(dir, PATH_MAX, "%s\\vkd3d", base);
+#else
+        if ((base = getenv("XDG_CACHE_HOME")) && *base)
+        {
+            snprintf(dir, PATH_MAX, "%s/vkd3d", base);
+        }
+        else if ((base = getenv("HOME")))
+        {
+            snprintf(dir, PATH_MAX, "%s/.cache", base);
+            vkd3d_make_directory(dir);
+            snprintf(dir, PATH_MAX, "%s/.cache/vkd3d", base);
+        }
+        else
+        {
+            return false;
+        }
+#endif
+        if (subdir)
+        {
+            vkd3d_make_directory(dir);
+#ifdef _WIN32
+            snprintf(dir + strlen(dir), PATH_MAX - strlen(dir), "\\%s", subdir);
+#else
+            snprintf(dir + strlen(dir), PATH_MAX - strlen(dir), "/%s", subdir);
+#endif
+        }
+    }
+
+    if (!vkd3d_make_directory(dir))
+    {
+        WARN("Failed to create cache directory %s.\n", debugstr_a(dir));
+        return false;
+    }
+
+    return true;
+}
+
+/* When a cache directory grows beyond its maximum size, the oldest entries
+ * are removed until it's back to three quarters of it. */
+#define VKD3D_PIPELINE_CACHE_MAX_SIZE (256 * 1024 * 1024)
+#define VKD3D_SHADER_CACHE_MAX_SIZE (256 * 1024 * 1024)
+
+struct vkd3d_cache_file
+{
+    uint64_t time;
+    uint64_t size;
+    char name[24];
+};
+
+static bool vkd3d_cache_add_file(struct vkd3d_cache_file **files, size_t *files_size,
+        size_t *count, const char *name, uint64_t size, uint64_t time)
+{
+    struct vkd3d_cache_file *file;
+
+    if (strlen(name) >= sizeof(file->name)
+            || !vkd3d_array_reserve((void **)files, files_size, *count + 1, sizeof(**files)))
+        return false;
+
+    file = &(*files)[(*count)++];
+    strcpy(file->name, name);
+    file->size = size;
+    file->time = time;
+    return true;
+}
+
+/* Returns the entries of a cache directory and their total size. */
+static struct vkd3d_cache_file *vkd3d_cache_dir_list_files(const struct vkd3d_cache_dir *cache,
+        size_t *count, uint64_t *total_size)
+{
+    struct vkd3d_cache_file *files = NULL;
+    size_t files_size = 0;
+#ifdef _WIN32
+    WIN32_FIND_DATAA data;
+    char pattern[PATH_MAX];
+    HANDLE handle;
+    uint64_t size;
+#else
+    size_t len, extension_len = strlen(cache->extension);
+    char path[PATH_MAX];
+    struct dirent *entry;
+    struct stat st;
+    DIR *d;
+#endif
+
+    *count = 0;
+    *total_size = 0;
+
+#ifdef _WIN32
+    snprintf(pattern, sizeof(pattern), "%s\\*%s", cache->path, cache->extension);
+    if ((handle = FindFirstFileA(pattern, &data)) == INVALID_HANDLE_VALUE)
+        return NULL;
+    do
+    {
+        size = ((uint64_t)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+        if (vkd3d_cache_add_file(&files, &files_size, count, data.cFileName, size,
+                ((uint64_t)data.ftLastWriteTime.dwHighDateTime << 32) | data.ftLastWriteTime.dwLowDateTime))
+            *total_size += size;
+    } while (FindNextFileA(handle, &data));
+    FindClose(handle);
+#else
+    if (!(d = opendir(cache->path)))
+        return NULL;
+    while ((entry = readdir(d)))
+    {
+        if ((len = strlen(entry->d_name)) < extension_len
+                || strcmp(entry->d_name + len - extension_len, cache->extension))
+            continue;
+        snprintf(path, sizeof(path), "%s/%s", cache->path, entry->d_name);
+        if (!stat(path, &st) && vkd3d_cache_add_file(&files, &files_size, count,
+                entry->d_name, st.st_size, st.st_mtime))
+            *total_size += st.st_size;
+    }
+    closedir(d);
+#endif
+
+    return files;
+}
+
+static int vkd3d_cache_file_compare(const void *a, const void *b)
+{
+    const struct vkd3d_cache_file *file_a = a, *file_b = b;
+
+    return (file_a->time > file_b->time) - (file_a->time < file_b->time);
+}
+
+/* Called without holding the cache mutex, by the one thread which set
+ * "evicting". */
+static void vkd3d_cache_dir_evict(struct vkd3d_cache_dir *cache)
+{
+    struct vkd3d_cache_file *files;
+    char path[PATH_MAX];
+    uint64_t total_size;
+    size_t count, i;
+
+    files = vkd3d_cache_dir_list_files(cache, &count, &total_size);
+    qsort(files, count, sizeof(*files), vkd3d_cache_file_compare);
+
+    for (i = 0; i < count && total_size > cache->max_size / 4 * 3; ++i)
+    {
+#ifdef _WIN32
+        snprintf(path, sizeof(path), "%s\\%s", cache->path, files[i].name);
+#else
+        snprintf(path, sizeof(path), "%s/%s", cache->path, files[i].name);
+#endif
+        if (!remove(path))
+            total_size -= files[i].size;
+    }
+    TRACE("Evicted %zu entries from %s, %"PRIu64" bytes left.\n", i, debugstr_a(cache->path), total_size);
+    vkd3d_free(files);
+
+    vkd3d_mutex_lock(&cache->mutex);
+    cache->size = total_size;
+    cache->evicting = false;
+    vkd3d_mutex_unlock(&cache->mutex);
+}
+
+/* Accounts for "size" bytes written to the cache, and evicts old entries if
+ * that takes it over its maximum size. Replaced entries are counted twice;
+ * eviction recomputes the real size from the directory. */
+static void vkd3d_cache_dir_add(struct vkd3d_cache_dir *cache, uint64_t size)
+{
+    bool evict = false;
+
+    vkd3d_mutex_lock(&cache->mutex);
+    cache->size += size;
+    if (cache->size > cache->max_size && !cache->evicting)
+        evict = cache->evicting = true;
+    vkd3d_mutex_unlock(&cache->mutex);
+
+    if (evict)
+        vkd3d_cache_dir_evict(cache);
+}
+
+static void vkd3d_cache_dir_init(struct vkd3d_cache_dir *cache, const char *extension, uint64_t max_size)
+{
+    vkd3d_mutex_init(&cache->mutex);
+    cache->path = NULL;
+    cache->extension = extension;
+    cache->max_size = max_size;
+    cache->size = 0;
+    cache->evicting = false;
+}
+
+static void vkd3d_cache_dir_open(struct vkd3d_cache_dir *cache, const char *path)
+{
+    struct vkd3d_cache_file *files;
+    size_t count;
+
+    cache->path = vkd3d_strdup(path);
+    files = vkd3d_cache_dir_list_files(cache, &count, &cache->size);
+    vkd3d_free(files);
+}
+
+static void vkd3d_cache_dir_cleanup(struct vkd3d_cache_dir *cache)
+{
+    vkd3d_free(cache->path);
+    vkd3d_mutex_destroy(&cache->mutex);
+}
+
+static void vkd3d_get_cache_file_name(char path[PATH_MAX],
+        const char *dir, uint64_t key, const char *suffix)
+{
+#ifdef _WIN32
+    snprintf(path, PATH_MAX, "%s\\%016"PRIx64"%s", dir, key, suffix);
+#else
+    snprintf(path, PATH_MAX, "%s/%016"PRIx64"%s", dir, key, suffix);
+#endif
+}
+
+/* Temporary files are named after the key and the writing process and
+ * thread, so that concurrent writers, in this process or another one sharing
+ * the directory, never use the same file. */
+static void vkd3d_get_cache_tmp_file_name(char path[PATH_MAX], const char *dir, uint64_t key)
+{
+    char suffix[64];
+#ifdef _WIN32
+    snprintf(suffix, sizeof(suffix), ".%lx-%lx.tmp", GetCurrentProcessId(), GetCurrentThreadId());
+#else
+    pthread_t thread = pthread_self();
+
+    snprintf(suffix, sizeof(suffix), ".%lx-%016"PRIx64".tmp", (unsigned long)getpid(),
+            vkd3d_hash_fnv1a(VKD3D_HASH_FNV1A_INIT, &thread, sizeof(thread)));
+#endif
+    vkd3d_get_cache_file_name(path, dir, key, suffix);
+}
+
+/* Pipeline caches are stored in a per-program directory, one file per
+ * pipeline state object, named after the hash of its description. */
+static void d3d12_device_init_pipeline_cache_dir(struct d3d12_device *device)
+{
+    char program_name[PATH_MAX], dir[PATH_MAX];
+
+    vkd3d_cache_dir_init(&device->pipeline_cache_dir, ".bin", VKD3D_PIPELINE_CACHE_MAX_SIZE);
+
+    if (!vkd3d_get_program_name(program_name) || !*program_name)
+        strcpy(program_name, "vkd3d");
+
+    if (!vkd3d_get_cache_directory(dir, "VKD3D_PIPELINE_CACHE_PATH", program_name))
+        return;
+
+    vkd3d_cache_dir_open(&device->pipeline_cache_dir, dir);
+}
+
+/* Returns the pipeline cache data stored on disk for "key", or NULL. The data
+ * is validated by d3d12_device_create_pipeline_cache(). */
+void *d3d12_device_load_pipeline_cache(struct d3d12_device *device, uint64_t key, size_t *size)
+{
+    char path[PATH_MAX];
+    void *data = NULL;
+    long file_size;
+    FILE *f;
+
+    if (!device->pipeline_cache_dir.path)
+        return NULL;
+
+    vkd3d_get_cache_file_name(path, device->pipeline_cache_dir.path, key, ".bin");
+    if (!(f = fopen(path, "rb")))
+        return NULL;
+
+    if (!fseek(f, 0, SEEK_END) && (file_size = ftell(f)) > 0 && !fseek(f, 0, SEEK_SET)
+            && (data = vkd3d_malloc(file_size)) && fread(data, 1, file_size, f) == (size_t)file_size)
+    {
+        TRACE("Loaded %ld bytes of pipeline cache data from %s.\n", file_size, debugstr_a(path));
+        fclose(f);
+        *size = file_size;
+        return data;
+    }
+
+    WARN("Failed to read pipeline cache %s.\n", debugstr_a(path));
+    vkd3d_free(data);
+    fclose(f);
+    return NULL;
+}
+
+/* Write to a temporary file first, so that a concurrently starting process
+ * never reads a partially written file. */
+static bool vkd3d_write_cache_file(const char *path, const char *tmp_path,
+        const void *header, size_t header_size, const void *data, size_t size)
+{
+    bool ret;
+    FILE *f;
+
+    if (!(f = fopen(tmp_path, "wb")))
+        return false;
+
+    ret = fwrite(header, 1, header_size, f) == header_size && fwrite(data, 1, size, f) == size;
+    ret = !fclose(f) && ret;
+#ifdef _WIN32
+    ret = ret && MoveFileExA(tmp_path, path, MOVEFILE_REPLACE_EXISTING);
+#else
+    ret = ret && !rename(tmp_path, path);
+#endif
+    if (!ret)
+        remove(tmp_path);
+
+    return ret;
+}
+
+/* Write "vk_cache" to disk, unless it's no larger than "initial_size", i.e.
+ * nothing was added since it was loaded. */
+void d3d12_device_store_pipeline_cache(struct d3d12_device *device, uint64_t key,
+        VkPipelineCache vk_cache, size_t initial_size)
+{
+    char path[PATH_MAX], tmp_path[PATH_MAX];
+    void *data;
+    size_t size;
+
+    if (!device->pipeline_cache_dir.path)
+        return;
+
+    if (FAILED(d3d12_device_get_pipeline_cache_data(device, vk_cache, key, NULL, &size)) || size <= initial_size)
+        return;
+
+    if (!(data = vkd3d_malloc(size)))
+        return;
+    if (FAILED(d3d12_device_get_pipeline_cache_data(device, vk_cache, key, data, &size)))
+    {
+        vkd3d_free(data);
+        return;
+    }
+
+    vkd3d_get_cache_file_name(path, device->pipeline_cache_dir.path, key, ".bin");
+    vkd3d_get_cache_tmp_file_name(tmp_path, device->pipeline_cache_dir.path, key);
+
+    if (vkd3d_write_cache_file(path, tmp_path, NULL, 0, data, size))
+    {
+        TRACE("Stored %zu bytes of pipeline cache data to %s.\n", size, debugstr_a(path));
+        vkd3d_cache_dir_add(&device->pipeline_cache_dir, size);
+    }
+    else
+    {
+        WARN("Failed to write pipeline cache %s.\n", debugstr_a(path));
+    }
+
+    vkd3d_free(data);
+}
+
+#define VKD3D_SHADER_CACHE_MAGIC VKD3D_MAKE_TAG('V', 'K', 'S', 'C')
+/* Increment this when the layout of the key or of stored entries changes. */
+#define VKD3D_SHADER_CACHE_VERSION 1
+
+struct vkd3d_shader_cache_header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key;
+    uint64_t size;
+    uint64_t checksum;
+};
+
+/* Returns the SPIR-V stored for "key", which should be freed with
+ * vkd3d_free(). */
+bool d3d12_device_load_shader_cache(struct d3d12_device *device, uint64_t key, struct vkd3d_shader_code *spirv)
+{
+    struct vkd3d_shader_cache_header header;
+    char path[PATH_MAX];
+    void *data = NULL;
+    FILE *f;
+
+    if (!device->shader_cache_dir.path)
+        return false;
+
+    vkd3d_get_cache_file_name(path, device->shader_cache_dir.path, key, ".spv");
+    if (!(f = fopen(path, "rb")))
+        return false;
+
+    if (fread(&header, sizeof(header), 1, f) == 1 && header.magic == VKD3D_SHADER_CACHE_MAGIC
+            && header.version == VKD3D_SHADER_CACHE_VERSION && header.key == key
+            && header.size && header.size <= VKD3D_SHADER_CACHE_MAX_SIZE
+            && (data = vkd3d_malloc(header.size)) && fread(data, 1, header.size, f) == header.size
+            && vkd3d_hash_fnv1a(VKD3D_HASH_FNV1A_INIT, data, header.size) == header.checksum)
+    {
+        fclose(f);
+        spirv->code = data;
+        spirv->size = header.size;
+        return true;
+    }
+
+    WARN("Ignoring invalid shader cache entry %s.\n", debugstr_a(path));
+    vkd3d_free(data);
+    fclose(f);
+    return false;
+}
+
+void d3d12_device_store_shader_cache(struct d3d12_device *device, uint64_t key, const struct vkd3d_shader_code *spirv)
+{
+    struct vkd3d_shader_cache_header header;
+    char path[PATH_MAX], tmp_path[PATH_MAX];
+
+    if (!device->shader_cache_dir.path)
+        return;
+
+    header.magic = VKD3D_SHADER_CACHE_MAGIC;
+    header.version = VKD3D_SHADER_CACHE_VERSION;
+    header.key = key;
+    header.size = spirv->size;
+    header.checksum = vkd3d_hash_fnv1a(VKD3D_HASH_FNV1A_INIT, spirv->code, spirv->size);
+
+    vkd3d_get_cache_file_name(path, device->shader_cache_dir.path, key, ".spv");
+    vkd3d_get_cache_tmp_file_name(tmp_path, device->shader_cache_dir.path, key);
+
+    if (!vkd3d_write_cache_file(path, tmp_path, &header, sizeof(header), spirv->code, spirv->size))
+    {
+        WARN("Failed to write shader cache entry %s.\n", debugstr_a(path));
+        return;
+    }
+
+    vkd3d_cache_dir_add(&device->shader_cache_dir, sizeof(header) + spirv->size);
+}
+
+/* SPIR-V translated from DXBC is cached on disk, since identical shaders are
+ * compiled against the same root signatures on every run. The directory is
+ * shared between programs; entries are addressed by a hash of the shader, its
+ * interface, and the vkd3d build, so that's safe. */
+static void d3d12_device_init_shader_cache(struct d3d12_device *device)
+{
+    char dir[PATH_MAX];
+
+    vkd3d_cache_dir_init(&device->shader_cache_dir, ".spv", VKD3D_SHADER_CACHE_MAX_SIZE);
+
+    if (!vkd3d_get_build_id(&device->shader_cache_build_id))
+    {
+        WARN("Failed to get the build id, not caching shaders.\n");
+        return;
+    }
+
+    if (!vkd3d_get_cache_directory(dir, "VKD3D_SHADER_CACHE_PATH", "spirv"))
+        return;
+
+    vkd3d_cache_dir_open(&device->shader_cache_dir, dir);
+}
+
 static HRESULT d3d12_device_init_pipeline_cache(struct d3d12_device *device)
 {
     const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
@@ -2070,6 +2695,10 @@ static HRESULT d3d12_device_init_pipeline_cache(struct d3d12_device *device)
         device->vk_pipeline_cache = VK_NULL_HANDLE;
     }
 
+    d3d12_device_init_pipeline_cache_dir(device);
+
+    d3d12_device_init_shader_cache(device);
+
     return S_OK;
 }
 
@@ -2079,6 +2708,8 @@ static void d3d12_device_destroy_pipeline_cache(struct d3d12_device *device)
 
     if (device->vk_pipeline_cache)
         VK_CALL(vkDestroyPipelineCache(device->vk_device, device->vk_pipeline_cache, NULL));
+    vkd3d_cache_dir_cleanup(&device->pipeline_cache_dir);
+    vkd3d_cache_dir_cleanup(&device->shader_cache_dir);
 
     vkd3d_mutex_destroy(&device->mutex);
 }
@@ -2514,6 +3145,7 @@ static ULONG STDMETHODCALLTYPE d3d12_device_Release(ID3D12Device5 *iface)
         vkd3d_vk_descriptor_heap_layouts_cleanup(device);
         vkd3d_uav_clear_state_cleanup(&device->uav_clear_state, device);
         vkd3d_destroy_null_resources(&device->null_resources, device);
+        vkd3d_memory_allocator_cleanup(&device->memory_allocator, device);
         vkd3d_gpu_va_allocator_cleanup(&device->gpu_va_allocator);
         vkd3d_render_pass_cache_cleanup(&device->render_pass_cache, device);
         d3d12_device_destroy_pipeline_cache(device);
@@ -3130,11 +3762,9 @@ static HRESULT STDMETHODCALLTYPE d3d12_device_CheckFeatureSupport(ID3D12Device5
                 return E_INVALIDARG;
             }
 
-            /* FIXME: The d3d12 documentation states that
-             * D3D12_SHADER_CACHE_SUPPORT_SINGLE_PSO is always supported, but
-             * the CachedPSO field of D3D12_GRAPHICS_PIPELINE_STATE_DESC is
-             * ignored and GetCachedBlob() is a stub. */
-            data->SupportFlags = D3D12_SHADER_CACHE_SUPPORT_NONE;
+            /* Cached PSOs and pipeline libraries are backed by Vulkan
+             * pipeline caches. */
+            data->SupportFlags = D3D12_SHADER_CACHE_SUPPORT_SINGLE_PSO | D3D12_SHADER_CACHE_SUPPORT_LIBRARY;
 
             TRACE("Shader cache support %#x.\n", data->SupportFlags);
             return S_OK;
@@ -3945,9 +4575,20 @@ static LUID * STDMETHODCALLTYPE d3d12_device_GetAdapterLuid(ID3D12Device5 *iface
 static HRESULT STDMETHODCALLTYPE d3d12_device_CreatePipelineLibrary(ID3D12Device5 *iface,
         const void *blob, SIZE_T blob_size, REFIID iid, void **lib)
 {
-    FIXME("iface %p, blob %p, blob_size %lu, iid %s, lib %p stub!\n", iface, blob, blob_size, debugstr_guid(iid), lib);
+    struct d3d12_device *device = impl_from_ID3D12Device5(iface);
+    struct d3d12_pipeline_library *object;
+    HRESULT hr;
+
+    TRACE("iface %p, blob %p, blob_size %lu, iid %s, lib %p.\n", iface, blob, blob_size, debugstr_guid(iid), lib);
+
+    if (blob_size && !blob)
+        return E_INVALIDARG;
+
+    if (FAILED(hr = d3d12_pipeline_library_create(device, blob, blob_size, &object)))
+        return hr;
 
-    return DXGI_ERROR_UNSUPPORTED;
+    return return_interface(&object->ID3D12PipelineLibrary1_iface,
+            &IID_ID3D12PipelineLibrary1, iid, lib);
 }
 
 static HRESULT STDMETHODCALLTYPE d3d12_device_SetEventOnMultipleFenceCompletion(ID3D12Device5 *iface,
@@ -4293,6 +4934,7 @@ static HRESULT d3d12_device_init(struct d3d12_device *device,
 
     vkd3d_render_pass_cache_init(&device->render_pass_cache);
     vkd3d_gpu_va_allocator_init(&device->gpu_va_allocator);
+    vkd3d_memory_allocator_init(&device->memory_allocator);
     vkd3d_time_domains_init(device);
 
     device->blocked_queue_count = 0;
@@ -277,6 +277,236 @@ static HRESULT vkd3d_allocate_image_memory(struct d3d12_device *device, VkImage
     return S_OK;
 }
 
+void vkd3d_memory_allocator_init(struct vkd3d_memory_allocator *allocator)
+{
+    unsigned int i, j, k;
+
+    memset(allocator, 0, sizeof(*allocator));
+    vkd3d_mutex_init(&allocator->mutex);
+
+    for (i = 0; i < ARRAY_SIZE(allocator->slabs); ++i)
+    {
+        for (j = 0; j < ARRAY_SIZE(allocator->slabs[i]); ++j)
+        {
+            for (k = 0; k < ARRAY_SIZE(allocator->slabs[i][j]); ++k)
+                list_init(&allocator->slabs[i][j][k]);
+        }
+    }
+}
+
+static void vkd3d_memory_allocator_trace_statistics(const struct vkd3d_memory_allocator *allocator)
+{
+    if (!TRACE_ON())
+        return;
+
+    /* Memory wasted by rounding allocations up to their slot size, and free
+     * slots scattered across partially used slabs, respectively. */
+    TRACE("%u slabs, %u allocations, reserved %#"PRIx64", used %#"PRIx64", requested %#"PRIx64", "
+            "internal fragmentation %#"PRIx64", free %#"PRIx64".\n",
+            allocator->slab_count, allocator->allocation_count, allocator->reserved_size,
+            allocator->used_size, allocator->requested_size,
+            allocator->used_size - allocator->requested_size,
+            allocator->reserved_size - allocator->used_size);
+}
+
+static void vkd3d_memory_slab_destroy(struct vkd3d_memory_slab *slab, struct d3d12_device *device)
+{
+    const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
+
+    if (slab->map_ptr)
+        VK_CALL(vkUnmapMemory(device->vk_device, slab->vk_memory));
+    VK_CALL(vkFreeMemory(device->vk_device, slab->vk_memory, NULL));
+    vkd3d_free(slab);
+}
+
+static struct vkd3d_memory_slab *vkd3d_memory_slab_create(struct d3d12_device *device,
+        uint32_t vk_memory_type, bool optimal, unsigned int slot_size)
+{
+    const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
+    VkMemoryAllocateInfo allocate_info;
+    struct vkd3d_memory_slab *slab;
+    unsigned int i;
+    VkResult vr;
+
+    if (!(slab = vkd3d_calloc(1, sizeof(*slab))))
+        return NULL;
+
+    allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocate_info.pNext = NULL;
+    allocate_info.allocationSize = VKD3D_MEMORY_SLAB_SIZE;
+    allocate_info.memoryTypeIndex = vk_memory_type;
+    if ((vr = VK_CALL(vkAllocateMemory(device->vk_device, &allocate_info, NULL, &slab->vk_memory))) < 0)
+    {
+        WARN("Failed to allocate slab memory, vr %d.\n", vr);
+        vkd3d_free(slab);
+        return NULL;
+    }
+
+    /* Host visible slabs stay mapped for their whole lifetime. */
+    if (device->memory_properties.memoryTypes[vk_memory_type].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+    {
+        if ((vr = VK_CALL(vkMapMemory(device->vk_device, slab->vk_memory,
+                0, VK_WHOLE_SIZE, 0, &slab->map_ptr))) < 0)
+        {
+            ERR("Failed to map slab memory, vr %d.\n", vr);
+            slab->map_ptr = NULL;
+            vkd3d_memory_slab_destroy(slab, device);
+            return NULL;
+        }
+    }
+
+    slab->vk_memory_type = vk_memory_type;
+    slab->optimal = optimal;
+    slab->slot_size = slot_size;
+    slab->slot_count = VKD3D_MEMORY_SLAB_SIZE / slot_size;
+    slab->used_count = 0;
+    slab->unused_index = 0;
+    for (i = 0; i < slab->slot_count; ++i)
+        slab->free_mask[i / 32] |= 1u << (i % 32);
+
+    TRACE("Created slab %p, memory type %u, slot size %#x.\n", slab, vk_memory_type, slot_size);
+
+    return slab;
+}
+
+static struct list *vkd3d_memory_allocator_get_slab_list(struct vkd3d_memory_allocator *allocator,
+        uint32_t vk_memory_type, bool optimal, unsigned int slot_size)
+{
+    unsigned int class_index = vkd3d_log2i(slot_size) - vkd3d_log2i(VKD3D_MEMORY_SLAB_MIN_SLOT_SIZE);
+
+    return &allocator->slabs[optimal][vk_memory_type][class_index];
+}
+
+/* Returns false if the requirements are not suitable for a slab, or if no
+ * slab memory could be allocated. If "unused_only" is set, only slots which
+ * were never handed out before are used. "unused" returns whether the slot
+ * was never used. */
+static bool vkd3d_memory_allocator_allocate(struct vkd3d_memory_allocator *allocator,
+        struct d3d12_device *device, const VkMemoryRequirements *requirements, uint32_t vk_memory_type,
+        bool optimal, bool unused_only, struct vkd3d_memory_slab **slab, VkDeviceSize *offset, bool *unused)
+{
+    struct vkd3d_memory_slab *s, *best = NULL;
+    unsigned int slot_size, i, index;
+    VkDeviceSize size;
+    struct list *list;
+
+    size = max(requirements->size, requirements->alignment);
+    if (size > VKD3D_MEMORY_SLAB_MAX_SLOT_SIZE)
+        return false;
+    slot_size = max(1u << vkd3d_log2i((unsigned int)size), VKD3D_MEMORY_SLAB_MIN_SLOT_SIZE);
+    if (slot_size < size)
+        slot_size <<= 1;
+
+    vkd3d_mutex_lock(&allocator->mutex);
+
+    /* Prefer the fullest slab with a free slot. This keeps the remaining
+     * slabs as empty as possible, so that they can be released. */
+    list = vkd3d_memory_allocator_get_slab_list(allocator, vk_memory_type, optimal, slot_size);
+    LIST_FOR_EACH_ENTRY(s, list, struct vkd3d_memory_slab, entry)
+    {
+        if ((unused_only ? s->unused_index : s->used_count) < s->slot_count
+                && (!best || s->used_count > best->used_count))
+            best = s;
+    }
+
+    if (!best)
+    {
+        if (!(best = vkd3d_memory_slab_create(device, vk_memory_type, optimal, slot_size)))
+        {
+            vkd3d_mutex_unlock(&allocator->mutex);
+            return false;
+        }
+        list_add_tail(list, &best->entry);
+        ++allocator->slab_count;
+        allocator->reserved_size += VKD3D_MEMORY_SLAB_SIZE;
+        vkd3d_memory_allocator_trace_statistics(allocator);
+    }
+
+    if (unused_only)
+    {
+        index = best->unused_index;
+    }
+    else
+    {
+        i = 0;
+        while (!best->free_mask[i])
+            ++i;
+        index = i * 32 + vkd3d_log2i(best->free_mask[i] & -best->free_mask[i]);
+    }
+    best->free_mask[index / 32] &= ~(1u << (index % 32));
+    ++best->used_count;
+    *unused = index >= best->unused_index;
+    best->unused_index = max(best->unused_index, index + 1);
+
+    ++allocator->allocation_count;
+    allocator->used_size += slot_size;
+    allocator->requested_size += requirements->size;
+
+    *slab = best;
+    *offset = (VkDeviceSize)index * slot_size;
+
+    vkd3d_mutex_unlock(&allocator->mutex);
+
+    return true;
+}
+
+static void vkd3d_memory_allocator_free(struct vkd3d_memory_allocator *allocator, struct d3d12_device *device,
+        struct vkd3d_memory_slab *slab, VkDeviceSize offset, VkDeviceSize size)
+{
+    unsigned int index = offset / slab->slot_size;
+    struct list *list;
+
+    vkd3d_mutex_lock(&allocator->mutex);
+
+    slab->free_mask[index / 32] |= 1u << (index % 32);
+    --slab->used_count;
+
+    --allocator->allocation_count;
+    allocator->used_size -= slab->slot_size;
+    allocator->requested_size -= size;
+
+    /* Keep one slab per size class around to avoid thrashing on repeated
+     * create / release of a single resource. */
+    list = vkd3d_memory_allocator_get_slab_list(allocator, slab->vk_memory_type, slab->optimal, slab->slot_size);
+    if (!slab->used_count && (list_prev(list, &slab->entry) || list_next(list, &slab->entry)))
+    {
+        TRACE("Destroying empty slab %p.\n", slab);
+        list_remove(&slab->entry);
+        --allocator->slab_count;
+        allocator->reserved_size -= VKD3D_MEMORY_SLAB_SIZE;
+        vkd3d_memory_slab_destroy(slab, device);
+        vkd3d_memory_allocator_trace_statistics(allocator);
+    }
+
+    vkd3d_mutex_unlock(&allocator->mutex);
+}
+
+void vkd3d_memory_allocator_cleanup(struct vkd3d_memory_allocator *allocator, struct d3d12_device *device)
+{
+    struct vkd3d_memory_slab *slab, *next;
+    unsigned int i, j, k;
+
+    vkd3d_memory_allocator_trace_statistics(allocator);
+
+    for (i = 0; i < ARRAY_SIZE(allocator->slabs); ++i)
+    {
+        for (j = 0; j < ARRAY_SIZE(allocator->slabs[i]); ++j)
+        {
+            for (k = 0; k < ARRAY_SIZE(allocator->slabs[i][j]); ++k)
+            {
+                LIST_FOR_EACH_ENTRY_SAFE(slab, next, &allocator->slabs[i][j][k], struct vkd3d_memory_slab, entry)
+                {
+                    if (slab->used_count)
+                        WARN("Slab %p still has %u allocations.\n", slab, slab->used_count);
+                    vkd3d_memory_slab_destroy(slab, device);
+                }
+            }
+        }
+    }
+
+    vkd3d_mutex_destroy(&allocator->mutex);
+}
+
 /* ID3D12Heap */
 static inline struct d3d12_heap *impl_from_ID3D12Heap(ID3D12Heap *iface)
 {
@@ -326,10 +556,18 @@ static void d3d12_heap_destroy(struct d3d12_heap *heap)
 
     vkd3d_private_store_destroy(&heap->private_store);
 
-    if (heap->map_ptr)
-        VK_CALL(vkUnmapMemory(device->vk_device, heap->vk_memory));
+    if (heap->slab)
+    {
+        vkd3d_memory_allocator_free(&device->memory_allocator, device,
+                heap->slab, heap->slab_offset, heap->desc.SizeInBytes);
+    }
+    else
+    {
+        if (heap->map_ptr)
+            VK_CALL(vkUnmapMemory(device->vk_device, heap->vk_memory));
 
-    VK_CALL(vkFreeMemory(device->vk_device, heap->vk_memory, NULL));
+        VK_CALL(vkFreeMemory(device->vk_device, heap->vk_memory, NULL));
+    }
 
     vkd3d_mutex_destroy(&heap->mutex);
 
@@ -398,6 +636,10 @@ static HRESULT STDMETHODCALLTYPE d3d12_heap_SetName(ID3D12Heap *iface, const WCH
 
     TRACE("iface %p, name %s.\n", iface, debugstr_w(name, heap->device->wchar_size));
 
+    /* The memory object is shared with other resources. */
+    if (heap->slab)
+        return S_OK;
+
     return vkd3d_set_vk_object_name(heap->device, (uint64_t)heap->vk_memory,
             VK_DEBUG_REPORT_OBJECT_TYPE_DEVICE_MEMORY_EXT, name);
 }
@@ -476,6 +718,113 @@ static VkMemoryPropertyFlags d3d12_heap_get_memory_property_flags(const struct d
     return heap->device->memory_properties.memoryTypes[heap->vk_memory_type].propertyFlags;
 }
 
+/* Try to place the memory of a small committed resource in a slab, instead of
+ * giving it a dedicated allocation. */
+static bool d3d12_heap_suballocate(struct d3d12_heap *heap, struct d3d12_device *device,
+        const struct d3d12_resource *resource, VkDeviceSize *vk_memory_size)
+{
+    const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
+    VkMemoryDedicatedRequirements dedicated_requirements;
+    VkImageMemoryRequirementsInfo2 image_info;
+    VkBufferMemoryRequirementsInfo2 buffer_info;
+    VkMemoryRequirements2 memory_requirements2;
+    VkMemoryRequirements *memory_requirements;
+    struct vkd3d_memory_slab *slab;
+    unsigned int vk_memory_type;
+    bool optimal, zero, cpu_clear, unused;
+    VkDeviceSize offset;
+    VkResult vr;
+
+    if (heap->desc.Flags & (D3D12_HEAP_FLAG_SHARED | D3D12_HEAP_FLAG_SHARED_CROSS_ADAPTER
+            | D3D12_HEAP_FLAG_ALLOW_DISPLAY))
+        return false;
+
+    optimal = !d3d12_resource_is_buffer(resource);
+    if (optimal && resource->desc.Layout != D3D12_TEXTURE_LAYOUT_UNKNOWN)
+        return false;
+
+    memory_requirements = &memory_requirements2.memoryRequirements;
+    if (device->vk_info.KHR_dedicated_allocation)
+    {
+        dedicated_requirements.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS;
+        dedicated_requirements.pNext = NULL;
+
+        memory_requirements2.sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2;
+        memory_requirements2.pNext = &dedicated_requirements;
+
+        if (optimal)
+        {
+            image_info.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_REQUIREMENTS_INFO_2;
+            image_info.pNext = NULL;
+            image_info.image = resource->u.vk_image;
+            VK_CALL(vkGetImageMemoryRequirements2KHR(device->vk_device, &image_info, &memory_requirements2));
+        }
+        else
+        {
+            buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_REQUIREMENTS_INFO_2;
+            buffer_info.pNext = NULL;
+            buffer_info.buffer = resource->u.vk_buffer;
+            VK_CALL(vkGetBufferMemoryRequirements2KHR(device->vk_device, &buffer_info, &memory_requirements2));
+        }
+
+        if (dedicated_requirements.prefersDedicatedAllocation || dedicated_requirements.requiresDedicatedAllocation)
+            return false;
+    }
+    else if (optimal)
+    {
+        VK_CALL(vkGetImageMemoryRequirements(device->vk_device, resource->u.vk_image, memory_requirements));
+    }
+    else
+    {
+        VK_CALL(vkGetBufferMemoryRequirements(device->vk_device, resource->u.vk_buffer, memory_requirements));
+    }
+
+    if (FAILED(vkd3d_select_memory_type(device, memory_requirements->memoryTypeBits,
+            &heap->desc.Properties, heap->desc.Flags, &vk_memory_type)))
+        return false;
+
+    /* Committed resources are zeroed unless D3D12_HEAP_FLAG_CREATE_NOT_ZEROED
+     * is specified. Slots which were never handed out are as clean as a
+     * dedicated allocation, but recycled ones may hold the contents of a
+     * released resource. Those are cleared from the CPU for buffers in
+     * coherent host visible memory; the memory layout of images is opaque,
+     * so they, like anything in device local memory, only get unused slots. */
+    zero = !(heap->desc.Flags & D3D12_HEAP_FLAG_CREATE_NOT_ZEROED);
+    cpu_clear = zero && !optimal && (device->memory_properties.memoryTypes[vk_memory_type].propertyFlags
+            & (VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT))
+            == (VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+    if (!vkd3d_memory_allocator_allocate(&device->memory_allocator, device, memory_requirements,
+            vk_memory_type, optimal, zero && !cpu_clear, &slab, &offset, &unused))
+        return false;
+
+    if (cpu_clear && !unused)
+        memset((uint8_t *)slab->map_ptr + offset, 0, memory_requirements->size);
+
+    if (optimal)
+        vr = VK_CALL(vkBindImageMemory(device->vk_device, resource->u.vk_image, slab->vk_memory, offset));
+    else
+        vr = VK_CALL(vkBindBufferMemory(device->vk_device, resource->u.vk_buffer, slab->vk_memory, offset));
+    if (vr < 0)
+    {
+        WARN("Failed to bind slab memory, vr %d.\n", vr);
+        vkd3d_memory_allocator_free(&device->memory_allocator, device, slab, offset, memory_requirements->size);
+        return false;
+    }
+
+    TRACE("Allocated resource memory from slab %p, offset %#"PRIx64", size %#"PRIx64".\n",
+            slab, offset, memory_requirements->size);
+
+    heap->vk_memory = slab->vk_memory;
+    heap->vk_memory_type = vk_memory_type;
+    heap->map_ptr = slab->map_ptr;
+    heap->slab = slab;
+    heap->slab_offset = offset;
+    *vk_memory_size = memory_requirements->size;
+
+    return true;
+}
+
 static HRESULT d3d12_heap_init(struct d3d12_heap *heap,
         struct d3d12_device *device, const D3D12_HEAP_DESC *desc, const struct d3d12_resource *resource)
 {
@@ -496,6 +845,9 @@ static HRESULT d3d12_heap_init(struct d3d12_heap *heap,
     heap->map_ptr = NULL;
     heap->map_count = 0;
 
+    heap->slab = NULL;
+    heap->slab_offset = 0;
+
     if (!heap->desc.Properties.CreationNodeMask)
         heap->desc.Properties.CreationNodeMask = 1;
     if (!heap->desc.Properties.VisibleNodeMask)
@@ -520,7 +872,11 @@ static HRESULT d3d12_heap_init(struct d3d12_heap *heap,
 
     if (resource)
     {
-        if (d3d12_resource_is_buffer(resource))
+        if (d3d12_heap_suballocate(heap, device, resource, &vk_memory_size))
+        {
+            hr = S_OK;
+        }
+        else if (d3d12_resource_is_buffer(resource))
         {
             hr = vkd3d_allocate_buffer_memory(device, resource->u.vk_buffer,
                     &heap->desc.Properties, heap->desc.Flags,
@@ -558,7 +914,7 @@ static HRESULT d3d12_heap_init(struct d3d12_heap *heap,
     else
         heap->resource_count = 1;
 
-    if (d3d12_heap_get_memory_property_flags(heap) & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+    if (!heap->slab && d3d12_heap_get_memory_property_flags(heap) & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
     {
         if ((vr = VK_CALL(vkMapMemory(device->vk_device,
                 heap->vk_memory, 0, VK_WHOLE_SIZE, 0, &heap->map_ptr))) < 0)
@@ -2079,9 +2435,12 @@ static HRESULT vkd3d_allocate_resource_memory(
     heap_desc.Properties = *heap_properties;
     heap_desc.Alignment = 0;
     heap_desc.Flags = heap_flags;
-    if (SUCCEEDED(hr = d3d12_heap_create(device, &heap_desc, resource, NULL, &resource->heap)))
-        resource->flags |= VKD3D_RESOURCE_DEDICATED_HEAP;
-    return hr;
+    if (FAILED(hr = d3d12_heap_create(device, &heap_desc, resource, NULL, &resource->heap)))
+        return hr;
+
+    resource->flags |= VKD3D_RESOURCE_DEDICATED_HEAP;
+    resource->heap_offset = resource->heap->slab_offset;
+    return S_OK;
 }
 
 HRESULT d3d12_committed_resource_create(struct d3d12_device *device,
@@ -2444,7 +2803,9 @@ static inline void d3d12_desc_replace(struct d3d12_desc *dst, void *view, struct
         vkd3d_view_decref(view, device);
 }
 
-#define VKD3D_DESCRIPTOR_WRITE_BUFFER_SIZE 24
+/* Each batch is one vkUpdateDescriptorSets() call, so batches are large. The
+ * buffer is too large for the stack, and is allocated with the heap instead. */
+#define VKD3D_DESCRIPTOR_WRITE_BUFFER_SIZE 256
 
 struct descriptor_writes
 {
@@ -2612,20 +2973,20 @@ static void d3d12_desc_write_vk_heap(struct d3d12_descriptor_heap *descriptor_he
 void d3d12_desc_flush_vk_heap_updates_locked(struct d3d12_descriptor_heap *descriptor_heap, struct d3d12_device *device)
 {
     const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
+    struct descriptor_writes *writes = descriptor_heap->vk_writes;
     struct d3d12_desc *descriptors, *src;
-    struct descriptor_writes writes;
     union d3d12_desc_object u;
     unsigned int i, next;
 
     if ((i = vkd3d_atomic_exchange(&descriptor_heap->dirty_list_head, UINT_MAX)) == UINT_MAX)
         return;
 
-    writes.null_vk_cbv_info.buffer = VK_NULL_HANDLE;
-    writes.null_vk_cbv_info.offset = 0;
-    writes.null_vk_cbv_info.range = VK_WHOLE_SIZE;
-    writes.null_vk_buffer_view = VK_NULL_HANDLE;
-    writes.count = 0;
-    writes.held_ref_count = 0;
+    writes->null_vk_cbv_info.buffer = VK_NULL_HANDLE;
+    writes->null_vk_cbv_info.offset = 0;
+    writes->null_vk_cbv_info.range = VK_WHOLE_SIZE;
+    writes->null_vk_buffer_view = VK_NULL_HANDLE;
+    writes->count = 0;
+    writes->held_ref_count = 0;
 
     descriptors = (struct d3d12_desc *)descriptor_heap->descriptors;
 
@@ -2642,16 +3003,16 @@ void d3d12_desc_flush_vk_heap_updates_locked(struct d3d12_descriptor_heap *descr
             continue;
         }
 
-        writes.held_refs[writes.held_ref_count++] = u.object;
-        d3d12_desc_write_vk_heap(descriptor_heap, i, &writes, u.object, device);
+        writes->held_refs[writes->held_ref_count++] = u.object;
+        d3d12_desc_write_vk_heap(descriptor_heap, i, writes, u.object, device);
 
         vkd3d_atomic_exchange(&src->next, 0);
     }
 
     /* Avoid thunk calls wherever possible. */
-    if (writes.count)
-        VK_CALL(vkUpdateDescriptorSets(device->vk_device, writes.count, writes.vk_descriptor_writes, 0, NULL));
-    descriptor_writes_free_object_refs(&writes, device);
+    if (writes->count)
+        VK_CALL(vkUpdateDescriptorSets(device->vk_device, writes->count, writes->vk_descriptor_writes, 0, NULL));
+    descriptor_writes_free_object_refs(writes, device);
 }
 
 static void d3d12_desc_mark_as_modified(struct d3d12_desc *dst, struct d3d12_descriptor_heap *descriptor_heap)
@@ -4033,6 +4394,7 @@ static ULONG STDMETHODCALLTYPE d3d12_descriptor_heap_Release(ID3D12DescriptorHea
 
         VK_CALL(vkDestroyDescriptorPool(device->vk_device, heap->vk_descriptor_pool, NULL));
         vkd3d_mutex_destroy(&heap->vk_sets_mutex);
+        vkd3d_free(heap->vk_writes);
 
         vkd3d_free(heap);
 
@@ -4263,6 +4625,14 @@ static HRESULT d3d12_descriptor_heap_init(struct d3d12_descriptor_heap *descript
         return hr;
 
     descriptor_heap->use_vk_heaps = device->use_vk_heaps && (desc->Flags & D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE);
+    descriptor_heap->vk_writes = NULL;
+    if (descriptor_heap->use_vk_heaps && (desc->Type == D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV
+            || desc->Type == D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER)
+            && !(descriptor_heap->vk_writes = vkd3d_malloc(sizeof(*descriptor_heap->vk_writes))))
+    {
+        vkd3d_private_store_destroy(&descriptor_heap->private_store);
+        return E_OUTOFMEMORY;
+    }
     d3d12_descriptor_heap_vk_descriptor_sets_init(descriptor_heap, device, desc);
     vkd3d_mutex_init(&descriptor_heap->vk_sets_mutex);
 
@@ -2026,6 +2026,10 @@ static ULONG STDMETHODCALLTYPE d3d12_pipeline_state_Release(ID3D12PipelineState
 
         d3d12_pipeline_uav_counter_state_cleanup(&state->uav_counters, device);
 
+        d3d12_device_store_pipeline_cache(device, state->cache_key,
+                state->vk_pipeline_cache, state->cache_initial_size);
+        VK_CALL(vkDestroyPipelineCache(device->vk_device, state->vk_pipeline_cache, NULL));
+
         vkd3d_free(state);
 
         d3d12_device_release(device);
@@ -2089,12 +2093,46 @@ static HRESULT STDMETHODCALLTYPE d3d12_pipeline_state_GetDevice(ID3D12PipelineSt
     return d3d12_device_query_interface(state->device, iid, device);
 }
 
+static HRESULT d3d12_pipeline_state_get_cache_data(struct d3d12_pipeline_state *state,
+        void **data, size_t *size)
+{
+    struct d3d12_device *device = state->device;
+    HRESULT hr;
+
+    if (FAILED(hr = d3d12_device_get_pipeline_cache_data(device,
+            state->vk_pipeline_cache, state->cache_key, NULL, size)))
+        return hr;
+    if (!(*data = vkd3d_malloc(*size)))
+        return E_OUTOFMEMORY;
+    if (FAILED(hr = d3d12_device_get_pipeline_cache_data(device,
+            state->vk_pipeline_cache, state->cache_key, *data, size)))
+    {
+        vkd3d_free(*data);
+        return hr;
+    }
+
+    return S_OK;
+}
+
 static HRESULT STDMETHODCALLTYPE d3d12_pipeline_state_GetCachedBlob(ID3D12PipelineState *iface,
         ID3DBlob **blob)
 {
-    FIXME("iface %p, blob %p stub!\n", iface, blob);
+    struct d3d12_pipeline_state *state = impl_from_ID3D12PipelineState(iface);
+    void *data;
+    size_t size;
+    HRESULT hr;
 
-    return E_NOTIMPL;
+    TRACE("iface %p, blob %p.\n", iface, blob);
+
+    if (FAILED(hr = d3d12_pipeline_state_get_cache_data(state, &data, &size)))
+        return hr;
+    if (FAILED(hr = vkd3d_blob_create(data, size, blob)))
+    {
+        vkd3d_free(data);
+        return hr;
+    }
+
+    return S_OK;
 }
 
 static const struct ID3D12PipelineStateVtbl d3d12_pipeline_state_vtbl =
@@ -2129,6 +2167,220 @@ static inline unsigned int typed_uav_compile_option(const struct d3d12_device *d
             : VKD3D_SHADER_COMPILE_OPTION_TYPED_UAV_READ_FORMAT_R32;
 }
 
+static uint64_t vkd3d_hash_data(uint64_t hash, const void *data, size_t size)
+{
+    hash = vkd3d_hash_fnv1a(hash, &size, sizeof(size));
+    return size ? vkd3d_hash_fnv1a(hash, data, size) : hash;
+}
+
+static uint64_t vkd3d_hash_string(uint64_t hash, const char *string)
+{
+    return vkd3d_hash_data(hash, string, string ? strlen(string) : 0);
+}
+
+#define VKD3D_HASH_VALUE(hash, value) ((hash) = vkd3d_hash_fnv1a(hash, &(value), sizeof(value)))
+
+static uint64_t vkd3d_hash_descriptor_binding(uint64_t hash, const struct vkd3d_shader_descriptor_binding *binding)
+{
+    VKD3D_HASH_VALUE(hash, binding->set);
+    VKD3D_HASH_VALUE(hash, binding->binding);
+    VKD3D_HASH_VALUE(hash, binding->count);
+    return hash;
+}
+
+static uint64_t vkd3d_hash_shader_interface(uint64_t hash, const struct vkd3d_shader_interface_info *info)
+{
+    unsigned int i;
+
+    VKD3D_HASH_VALUE(hash, info->binding_count);
+    for (i = 0; i < info->binding_count; ++i)
+    {
+        const struct vkd3d_shader_resource_binding *b = &info->bindings[i];
+
+        VKD3D_HASH_VALUE(hash, b->type);
+        VKD3D_HASH_VALUE(hash, b->register_space);
+        VKD3D_HASH_VALUE(hash, b->register_index);
+        VKD3D_HASH_VALUE(hash, b->shader_visibility);
+        VKD3D_HASH_VALUE(hash, b->flags);
+        hash = vkd3d_hash_descriptor_binding(hash, &b->binding);
+    }
+
+    VKD3D_HASH_VALUE(hash, info->push_constant_buffer_count);
+    for (i = 0; i < info->push_constant_buffer_count; ++i)
+    {
+        const struct vkd3d_shader_push_constant_buffer *p = &info->push_constant_buffers[i];
+
+        VKD3D_HASH_VALUE(hash, p->register_space);
+        VKD3D_HASH_VALUE(hash, p->register_index);
+        VKD3D_HASH_VALUE(hash, p->shader_visibility);
+        VKD3D_HASH_VALUE(hash, p->offset);
+        VKD3D_HASH_VALUE(hash, p->size);
+    }
+
+    VKD3D_HASH_VALUE(hash, info->combined_sampler_count);
+    for (i = 0; i < info->combined_sampler_count; ++i)
+    {
+        const struct vkd3d_shader_combined_resource_sampler *s = &info->combined_samplers[i];
+
+        VKD3D_HASH_VALUE(hash, s->resource_space);
+        VKD3D_HASH_VALUE(hash, s->resource_index);
+        VKD3D_HASH_VALUE(hash, s->sampler_space);
+        VKD3D_HASH_VALUE(hash, s->sampler_index);
+        VKD3D_HASH_VALUE(hash, s->shader_visibility);
+        VKD3D_HASH_VALUE(hash, s->flags);
+        hash = vkd3d_hash_descriptor_binding(hash, &s->binding);
+    }
+
+    VKD3D_HASH_VALUE(hash, info->uav_counter_count);
+    for (i = 0; i < info->uav_counter_count; ++i)
+    {
+        const struct vkd3d_shader_uav_counter_binding *u = &info->uav_counters[i];
+
+        VKD3D_HASH_VALUE(hash, u->register_space);
+        VKD3D_HASH_VALUE(hash, u->register_index);
+        VKD3D_HASH_VALUE(hash, u->shader_visibility);
+        hash = vkd3d_hash_descriptor_binding(hash, &u->binding);
+        VKD3D_HASH_VALUE(hash, u->offset);
+    }
+
+    return hash;
+}
+
+static uint64_t vkd3d_hash_spirv_target_info(uint64_t hash, const struct vkd3d_shader_spirv_target_info *info)
+{
+    unsigned int i;
+
+    hash = vkd3d_hash_string(hash, info->entry_point);
+    VKD3D_HASH_VALUE(hash, info->environment);
+    hash = vkd3d_hash_data(hash, info->extensions, info->extension_count * sizeof(*info->extensions));
+
+    VKD3D_HASH_VALUE(hash, info->parameter_count);
+    for (i = 0; i < info->parameter_count; ++i)
+    {
+        const struct vkd3d_shader_parameter *p = &info->parameters[i];
+
+        VKD3D_HASH_VALUE(hash, p->name);
+        VKD3D_HASH_VALUE(hash, p->type);
+        VKD3D_HASH_VALUE(hash, p->data_type);
+        if (p->type == VKD3D_SHADER_PARAMETER_TYPE_IMMEDIATE_CONSTANT)
+            VKD3D_HASH_VALUE(hash, p->u.immediate_constant.u.u32);
+        else
+            VKD3D_HASH_VALUE(hash, p->u.specialization_constant.id);
+    }
+
+    VKD3D_HASH_VALUE(hash, info->dual_source_blending);
+    return vkd3d_hash_data(hash, info->output_swizzles, info->output_swizzle_count * sizeof(*info->output_swizzles));
+}
+
+static uint64_t vkd3d_hash_transform_feedback_info(uint64_t hash,
+        const struct vkd3d_shader_transform_feedback_info *info)
+{
+    unsigned int i;
+
+    VKD3D_HASH_VALUE(hash, info->element_count);
+    for (i = 0; i < info->element_count; ++i)
+    {
+        const struct vkd3d_shader_transform_feedback_element *e = &info->elements[i];
+
+        VKD3D_HASH_VALUE(hash, e->stream_index);
+        hash = vkd3d_hash_string(hash, e->semantic_name);
+        VKD3D_HASH_VALUE(hash, e->semantic_index);
+        VKD3D_HASH_VALUE(hash, e->component_index);
+        VKD3D_HASH_VALUE(hash, e->component_count);
+        VKD3D_HASH_VALUE(hash, e->output_slot);
+    }
+
+    return vkd3d_hash_data(hash, info->buffer_strides, info->buffer_stride_count * sizeof(*info->buffer_strides));
+}
+
+/* The key covers everything create_shader_stage() passes to
+ * vkd3d_shader_compile(), hashed member by member, so that padding and
+ * pointer values don't end up in it. Compilations using structures not
+ * handled here aren't cached. */
+static bool vkd3d_get_shader_cache_key(const struct d3d12_device *device,
+        const struct vkd3d_shader_compile_info *compile_info, uint64_t *key)
+{
+    const struct vkd3d_shader_interface_info *interface_info = NULL;
+    const struct
+    {
+        enum vkd3d_shader_structure_type type;
+        const void *next;
+    } *ext;
+    uint64_t hash;
+    unsigned int i;
+
+    if (!device->shader_cache_dir.path)
+        return false;
+
+    hash = vkd3d_hash_fnv1a(VKD3D_HASH_FNV1A_INIT, &device->shader_cache_build_id,
+            sizeof(device->shader_cache_build_id));
+    VKD3D_HASH_VALUE(hash, compile_info->source_type);
+    VKD3D_HASH_VALUE(hash, compile_info->target_type);
+    hash = vkd3d_hash_data(hash, compile_info->source.code, compile_info->source.size);
+    for (i = 0; i < compile_info->option_count; ++i)
+    {
+        VKD3D_HASH_VALUE(hash, compile_info->options[i].name);
+        VKD3D_HASH_VALUE(hash, compile_info->options[i].value);
+    }
+
+    for (ext = compile_info->next; ext; ext = ext->next)
+    {
+        VKD3D_HASH_VALUE(hash, ext->type);
+
+        switch (ext->type)
+        {
+            case VKD3D_SHADER_STRUCTURE_TYPE_INTERFACE_INFO:
+                interface_info = (const struct vkd3d_shader_interface_info *)ext;
+                hash = vkd3d_hash_shader_interface(hash, interface_info);
+                break;
+
+            case VKD3D_SHADER_STRUCTURE_TYPE_SPIRV_TARGET_INFO:
+                hash = vkd3d_hash_spirv_target_info(hash, (const struct vkd3d_shader_spirv_target_info *)ext);
+                break;
+
+            case VKD3D_SHADER_STRUCTURE_TYPE_SPIRV_DOMAIN_SHADER_TARGET_INFO:
+            {
+                const struct vkd3d_shader_spirv_domain_shader_target_info *ds_info = (const void *)ext;
+
+                VKD3D_HASH_VALUE(hash, ds_info->output_primitive);
+                VKD3D_HASH_VALUE(hash, ds_info->partitioning);
+                break;
+            }
+
+            case VKD3D_SHADER_STRUCTURE_TYPE_TRANSFORM_FEEDBACK_INFO:
+                hash = vkd3d_hash_transform_feedback_info(hash,
+                        (const struct vkd3d_shader_transform_feedback_info *)ext);
+                break;
+
+            case VKD3D_SHADER_STRUCTURE_TYPE_DESCRIPTOR_OFFSET_INFO:
+            {
+                const struct vkd3d_shader_descriptor_offset_info *offset_info = (const void *)ext;
+
+                /* The offset arrays are sized by the interface info, which
+                 * comes first in the chain. */
+                if (!interface_info)
+                    return false;
+                VKD3D_HASH_VALUE(hash, offset_info->descriptor_table_offset);
+                VKD3D_HASH_VALUE(hash, offset_info->descriptor_table_count);
+                if (offset_info->binding_offsets)
+                    hash = vkd3d_hash_data(hash, offset_info->binding_offsets,
+                            interface_info->binding_count * sizeof(*offset_info->binding_offsets));
+                if (offset_info->uav_counter_offsets)
+                    hash = vkd3d_hash_data(hash, offset_info->uav_counter_offsets,
+                            interface_info->uav_counter_count * sizeof(*offset_info->uav_counter_offsets));
+                break;
+            }
+
+            default:
+                TRACE("Not caching compilation with structure type %#x.\n", ext->type);
+                return false;
+        }
+    }
+
+    *key = hash;
+    return true;
+}
+
 static HRESULT create_shader_stage(struct d3d12_device *device,
         struct VkPipelineShaderStageCreateInfo *stage_desc, enum VkShaderStageFlagBits stage,
         const D3D12_SHADER_BYTECODE *code, const struct vkd3d_shader_interface_info *shader_interface)
@@ -2137,6 +2389,8 @@ static HRESULT create_shader_stage(struct d3d12_device *device,
     struct vkd3d_shader_compile_info compile_info;
     struct VkShaderModuleCreateInfo shader_desc;
     struct vkd3d_shader_code spirv = {0};
+    bool cacheable, cached = false;
+    uint64_t key;
     VkResult vr;
     int ret;
 
@@ -2168,17 +2422,34 @@ static HRESULT create_shader_stage(struct d3d12_device *device,
     compile_info.log_level = VKD3D_SHADER_LOG_NONE;
     compile_info.source_name = NULL;
 
-    if ((ret = vkd3d_shader_parse_dxbc_source_type(&compile_info.source, &compile_info.source_type, NULL)) < 0
-            || (ret = vkd3d_shader_compile(&compile_info, &spirv, NULL)) < 0)
+    if ((ret = vkd3d_shader_parse_dxbc_source_type(&compile_info.source, &compile_info.source_type, NULL)) < 0)
     {
-        WARN("Failed to compile shader, vkd3d result %d.\n", ret);
+        WARN("Failed to parse shader, vkd3d result %d.\n", ret);
         return hresult_from_vkd3d_result(ret);
     }
+
+    if ((cacheable = vkd3d_get_shader_cache_key(device, &compile_info, &key)))
+        cached = d3d12_device_load_shader_cache(device, key, &spirv);
+
+    if (!cached)
+    {
+        if ((ret = vkd3d_shader_compile(&compile_info, &spirv, NULL)) < 0)
+        {
+            WARN("Failed to compile shader, vkd3d result %d.\n", ret);
+            return hresult_from_vkd3d_result(ret);
+        }
+
+        if (cacheable)
+            d3d12_device_store_shader_cache(device, key, &spirv);
+    }
     shader_desc.codeSize = spirv.size;
     shader_desc.pCode = spirv.code;
 
     vr = VK_CALL(vkCreateShaderModule(device->vk_device, &shader_desc, NULL, &stage_desc->module));
-    vkd3d_shader_free_shader_code(&spirv);
+    if (cached)
+        vkd3d_free((void *)spirv.code);
+    else
+        vkd3d_shader_free_shader_code(&spirv);
     if (vr < 0)
     {
         WARN("Failed to create Vulkan shader module, vr %d.\n", vr);
@@ -2218,7 +2489,7 @@ static int vkd3d_scan_dxbc(const struct d3d12_device *device, const D3D12_SHADER
 
 static HRESULT vkd3d_create_compute_pipeline(struct d3d12_device *device,
         const D3D12_SHADER_BYTECODE *code, const struct vkd3d_shader_interface_info *shader_interface,
-        VkPipelineLayout vk_pipeline_layout, VkPipeline *vk_pipeline)
+        VkPipelineLayout vk_pipeline_layout, VkPipelineCache vk_pipeline_cache, VkPipeline *vk_pipeline)
 {
     const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
     VkComputePipelineCreateInfo pipeline_info;
@@ -2236,7 +2507,7 @@ static HRESULT vkd3d_create_compute_pipeline(struct d3d12_device *device,
     pipeline_info.basePipelineIndex = -1;
 
     vr = VK_CALL(vkCreateComputePipelines(device->vk_device,
-            VK_NULL_HANDLE, 1, &pipeline_info, NULL, vk_pipeline));
+            vk_pipeline_cache, 1, &pipeline_info, NULL, vk_pipeline));
     VK_CALL(vkDestroyShaderModule(device->vk_device, pipeline_info.stage.module, NULL));
     if (vr < 0)
     {
@@ -2375,6 +2646,168 @@ static HRESULT d3d12_pipeline_state_find_and_init_uav_counters(struct d3d12_pipe
     return hr;
 }
 
+static uint64_t vkd3d_hash_stencil_op_desc(uint64_t hash, const D3D12_DEPTH_STENCILOP_DESC *desc)
+{
+    VKD3D_HASH_VALUE(hash, desc->StencilFailOp);
+    VKD3D_HASH_VALUE(hash, desc->StencilDepthFailOp);
+    VKD3D_HASH_VALUE(hash, desc->StencilPassOp);
+    VKD3D_HASH_VALUE(hash, desc->StencilFunc);
+    return hash;
+}
+
+/* Hash everything in the description that affects the compiled pipelines,
+ * including the root signature layout, but not the cached PSO. The hash is
+ * the key of the on-disk cache, and is stored in cached PSO blobs and
+ * pipeline library entries, so that they can be checked against the
+ * description they are used with. Structures are hashed member by member,
+ * since some of them have padding. */
+static uint64_t d3d12_pipeline_state_desc_get_hash(const struct d3d12_pipeline_state_desc *desc)
+{
+    const D3D12_SHADER_BYTECODE *shaders[] = {&desc->vs, &desc->ps, &desc->ds, &desc->hs, &desc->gs, &desc->cs};
+    const D3D12_DEPTH_STENCIL_DESC1 *ds_desc = &desc->depth_stencil_state;
+    const D3D12_STREAM_OUTPUT_DESC *so_desc = &desc->stream_output;
+    const struct d3d12_root_signature *root_signature;
+    uint64_t hash = VKD3D_HASH_FNV1A_INIT;
+    unsigned int i;
+
+    if ((root_signature = unsafe_impl_from_ID3D12RootSignature(desc->root_signature)))
+    {
+        VKD3D_HASH_VALUE(hash, root_signature->flags);
+        hash = vkd3d_hash_data(hash, root_signature->descriptor_mapping,
+                root_signature->binding_count * sizeof(*root_signature->descriptor_mapping));
+        if (root_signature->descriptor_offsets)
+            hash = vkd3d_hash_data(hash, root_signature->descriptor_offsets,
+                    root_signature->binding_count * sizeof(*root_signature->descriptor_offsets));
+        if (root_signature->uav_counter_mapping)
+            hash = vkd3d_hash_data(hash, root_signature->uav_counter_mapping,
+                    root_signature->uav_mapping_count * sizeof(*root_signature->uav_counter_mapping));
+        if (root_signature->uav_counter_offsets)
+            hash = vkd3d_hash_data(hash, root_signature->uav_counter_offsets,
+                    root_signature->uav_mapping_count * sizeof(*root_signature->uav_counter_offsets));
+        hash = vkd3d_hash_data(hash, root_signature->root_constants,
+                root_signature->root_constant_count * sizeof(*root_signature->root_constants));
+    }
+
+    for (i = 0; i < ARRAY_SIZE(shaders); ++i)
+        hash = vkd3d_hash_data(hash, shaders[i]->pShaderBytecode, shaders[i]->BytecodeLength);
+
+    VKD3D_HASH_VALUE(hash, so_desc->NumEntries);
+    for (i = 0; i < so_desc->NumEntries; ++i)
+    {
+        const D3D12_SO_DECLARATION_ENTRY *e = &so_desc->pSODeclaration[i];
+
+        VKD3D_HASH_VALUE(hash, e->Stream);
+        hash = vkd3d_hash_string(hash, e->SemanticName);
+        VKD3D_HASH_VALUE(hash, e->SemanticIndex);
+        VKD3D_HASH_VALUE(hash, e->StartComponent);
+        VKD3D_HASH_VALUE(hash, e->ComponentCount);
+        VKD3D_HASH_VALUE(hash, e->OutputSlot);
+    }
+    hash = vkd3d_hash_data(hash, so_desc->pBufferStrides, so_desc->NumStrides * sizeof(*so_desc->pBufferStrides));
+    VKD3D_HASH_VALUE(hash, so_desc->RasterizedStream);
+
+    VKD3D_HASH_VALUE(hash, desc->blend_state.AlphaToCoverageEnable);
+    VKD3D_HASH_VALUE(hash, desc->blend_state.IndependentBlendEnable);
+    for (i = 0; i < ARRAY_SIZE(desc->blend_state.RenderTarget); ++i)
+    {
+        const D3D12_RENDER_TARGET_BLEND_DESC *rt = &desc->blend_state.RenderTarget[i];
+
+        VKD3D_HASH_VALUE(hash, rt->BlendEnable);
+        VKD3D_HASH_VALUE(hash, rt->LogicOpEnable);
+        VKD3D_HASH_VALUE(hash, rt->SrcBlend);
+        VKD3D_HASH_VALUE(hash, rt->DestBlend);
+        VKD3D_HASH_VALUE(hash, rt->BlendOp);
+        VKD3D_HASH_VALUE(hash, rt->SrcBlendAlpha);
+        VKD3D_HASH_VALUE(hash, rt->DestBlendAlpha);
+        VKD3D_HASH_VALUE(hash, rt->BlendOpAlpha);
+        VKD3D_HASH_VALUE(hash, rt->LogicOp);
+        VKD3D_HASH_VALUE(hash, rt->RenderTargetWriteMask);
+    }
+    VKD3D_HASH_VALUE(hash, desc->sample_mask);
+
+    /* D3D12_RASTERIZER_DESC has no padding. */
+    VKD3D_HASH_VALUE(hash, desc->rasterizer_state);
+
+    VKD3D_HASH_VALUE(hash, ds_desc->DepthEnable);
+    VKD3D_HASH_VALUE(hash, ds_desc->DepthWriteMask);
+    VKD3D_HASH_VALUE(hash, ds_desc->DepthFunc);
+    VKD3D_HASH_VALUE(hash, ds_desc->StencilEnable);
+    VKD3D_HASH_VALUE(hash, ds_desc->StencilReadMask);
+    VKD3D_HASH_VALUE(hash, ds_desc->StencilWriteMask);
+    hash = vkd3d_hash_stencil_op_desc(hash, &ds_desc->FrontFace);
+    hash = vkd3d_hash_stencil_op_desc(hash, &ds_desc->BackFace);
+    VKD3D_HASH_VALUE(hash, ds_desc->DepthBoundsTestEnable);
+
+    VKD3D_HASH_VALUE(hash, desc->input_layout.NumElements);
+    for (i = 0; i < desc->input_layout.NumElements; ++i)
+    {
+        const D3D12_INPUT_ELEMENT_DESC *e = &desc->input_layout.pInputElementDescs[i];
+
+        hash = vkd3d_hash_string(hash, e->SemanticName);
+        VKD3D_HASH_VALUE(hash, e->SemanticIndex);
+        VKD3D_HASH_VALUE(hash, e->Format);
+        VKD3D_HASH_VALUE(hash, e->InputSlot);
+        VKD3D_HASH_VALUE(hash, e->AlignedByteOffset);
+        VKD3D_HASH_VALUE(hash, e->InputSlotClass);
+        VKD3D_HASH_VALUE(hash, e->InstanceDataStepRate);
+    }
+
+    VKD3D_HASH_VALUE(hash, desc->strip_cut_value);
+    VKD3D_HASH_VALUE(hash, desc->primitive_topology_type);
+    VKD3D_HASH_VALUE(hash, desc->rtv_formats);
+    VKD3D_HASH_VALUE(hash, desc->dsv_format);
+    VKD3D_HASH_VALUE(hash, desc->sample_desc);
+    VKD3D_HASH_VALUE(hash, desc->view_instancing_desc.ViewInstanceCount);
+    hash = vkd3d_hash_data(hash, desc->view_instancing_desc.pViewInstanceLocations,
+            desc->view_instancing_desc.ViewInstanceCount * sizeof(*desc->view_instancing_desc.pViewInstanceLocations));
+    VKD3D_HASH_VALUE(hash, desc->view_instancing_desc.Flags);
+    VKD3D_HASH_VALUE(hash, desc->node_mask);
+    VKD3D_HASH_VALUE(hash, desc->flags);
+
+    return hash;
+}
+
+static HRESULT d3d12_pipeline_state_init_pipeline_cache(struct d3d12_pipeline_state *state,
+        struct d3d12_device *device, const struct d3d12_pipeline_state_desc *desc)
+{
+    const D3D12_CACHED_PIPELINE_STATE *cached_pso = &desc->cached_pso;
+    size_t size = 0;
+    void *data;
+    HRESULT hr;
+
+    state->cache_key = d3d12_pipeline_state_desc_get_hash(desc);
+    state->cache_initial_size = 0;
+
+    if (cached_pso->CachedBlobSizeInBytes)
+    {
+        if (!cached_pso->pCachedBlob)
+        {
+            WARN("Cached PSO blob is NULL.\n");
+            return E_INVALIDARG;
+        }
+
+        if (FAILED(hr = d3d12_device_create_pipeline_cache(device, state->cache_key,
+                cached_pso->pCachedBlob, cached_pso->CachedBlobSizeInBytes, &state->vk_pipeline_cache)))
+            return hr;
+        state->cache_initial_size = cached_pso->CachedBlobSizeInBytes;
+        return S_OK;
+    }
+
+    if ((data = d3d12_device_load_pipeline_cache(device, state->cache_key, &size)))
+    {
+        hr = d3d12_device_create_pipeline_cache(device, state->cache_key, data, size, &state->vk_pipeline_cache);
+        vkd3d_free(data);
+        if (SUCCEEDED(hr))
+        {
+            state->cache_initial_size = size;
+            return S_OK;
+        }
+        WARN("Ignoring stored pipeline cache, hr %#x.\n", hr);
+    }
+
+    return d3d12_device_create_pipeline_cache(device, state->cache_key, NULL, 0, &state->vk_pipeline_cache);
+}
+
 static HRESULT d3d12_pipeline_state_init_compute(struct d3d12_pipeline_state *state,
         struct d3d12_device *device, const struct d3d12_pipeline_state_desc *desc)
 {
@@ -2439,10 +2872,17 @@ static HRESULT d3d12_pipeline_state_init_compute(struct d3d12_pipeline_state *st
 
     vk_pipeline_layout = state->uav_counters.vk_pipeline_layout
             ? state->uav_counters.vk_pipeline_layout : root_signature->vk_pipeline_layout;
+    if (FAILED(hr = d3d12_pipeline_state_init_pipeline_cache(state, device, desc)))
+    {
+        d3d12_pipeline_uav_counter_state_cleanup(&state->uav_counters, device);
+        return hr;
+    }
+
     if (FAILED(hr = vkd3d_create_compute_pipeline(device, &desc->cs, &shader_interface,
-            vk_pipeline_layout, &state->u.compute.vk_pipeline)))
+            vk_pipeline_layout, state->vk_pipeline_cache, &state->u.compute.vk_pipeline)))
     {
         WARN("Failed to create Vulkan compute pipeline, hr %#x.\n", hr);
+        VK_CALL(vkDestroyPipelineCache(device->vk_device, state->vk_pipeline_cache, NULL));
         d3d12_pipeline_uav_counter_state_cleanup(&state->uav_counters, device);
         return hr;
     }
@@ -2450,6 +2890,7 @@ static HRESULT d3d12_pipeline_state_init_compute(struct d3d12_pipeline_state *st
     if (FAILED(hr = vkd3d_private_store_init(&state->private_store)))
     {
         VK_CALL(vkDestroyPipeline(device->vk_device, state->u.compute.vk_pipeline, NULL));
+        VK_CALL(vkDestroyPipelineCache(device->vk_device, state->vk_pipeline_cache, NULL));
         d3d12_pipeline_uav_counter_state_cleanup(&state->uav_counters, device);
         return hr;
     }
@@ -2460,31 +2901,6 @@ static HRESULT d3d12_pipeline_state_init_compute(struct d3d12_pipeline_state *st
     return S_OK;
 }
 
-HRESULT d3d12_pipeline_state_create_compute(struct d3d12_device *device,
-        const D3D12_COMPUTE_PIPELINE_STATE_DESC *desc, struct d3d12_pipeline_state **state)
-{
-    struct d3d12_pipeline_state_desc pipeline_desc;
-    struct d3d12_pipeline_state *object;
-    HRESULT hr;
-
-    pipeline_state_desc_from_d3d12_compute_desc(&pipeline_desc, desc);
-
-    if (!(object = vkd3d_malloc(sizeof(*object))))
-        return E_OUTOFMEMORY;
-
-    if (FAILED(hr = d3d12_pipeline_state_init_compute(object, device, &pipeline_desc)))
-    {
-        vkd3d_free(object);
-        return hr;
-    }
-
-    TRACE("Created compute pipeline state %p.\n", object);
-
-    *state = object;
-
-    return S_OK;
-}
-
 static enum VkPolygonMode vk_polygon_mode_from_d3d12(D3D12_FILL_MODE mode)
 {
     switch (mode)
@@ -3448,8 +3864,14 @@ static HRESULT d3d12_pipeline_state_init_graphics(struct d3d12_pipeline_state *s
 
     list_init(&graphics->compiled_pipelines);
 
+    if (FAILED(hr = d3d12_pipeline_state_init_pipeline_cache(state, device, desc)))
+        goto fail;
+
     if (FAILED(hr = vkd3d_private_store_init(&state->private_store)))
+    {
+        VK_CALL(vkDestroyPipelineCache(device->vk_device, state->vk_pipeline_cache, NULL));
         goto fail;
+    }
 
     state->vk_bind_point = VK_PIPELINE_BIND_POINT_GRAPHICS;
     d3d12_device_add_ref(state->device = device);
@@ -3468,68 +3890,666 @@ fail:
     return hr;
 }
 
-HRESULT d3d12_pipeline_state_create_graphics(struct d3d12_device *device,
-        const D3D12_GRAPHICS_PIPELINE_STATE_DESC *desc, struct d3d12_pipeline_state **state)
+static HRESULT d3d12_pipeline_state_create_from_desc(struct d3d12_device *device,
+        const struct d3d12_pipeline_state_desc *desc, VkPipelineBindPoint bind_point,
+        struct d3d12_pipeline_state **state)
 {
-    struct d3d12_pipeline_state_desc pipeline_desc;
     struct d3d12_pipeline_state *object;
     HRESULT hr;
 
-    pipeline_state_desc_from_d3d12_graphics_desc(&pipeline_desc, desc);
-
-    if (!(object = vkd3d_malloc(sizeof(*object))))
+    if (!(object = vkd3d_calloc(1, sizeof(*object))))
         return E_OUTOFMEMORY;
 
-    if (FAILED(hr = d3d12_pipeline_state_init_graphics(object, device, &pipeline_desc)))
+    switch (bind_point)
+    {
+        case VK_PIPELINE_BIND_POINT_COMPUTE:
+            hr = d3d12_pipeline_state_init_compute(object, device, desc);
+            break;
+
+        case VK_PIPELINE_BIND_POINT_GRAPHICS:
+            hr = d3d12_pipeline_state_init_graphics(object, device, desc);
+            break;
+
+        default:
+            vkd3d_unreachable();
+    }
+
+    if (FAILED(hr))
     {
         vkd3d_free(object);
         return hr;
     }
 
-    TRACE("Created graphics pipeline state %p.\n", object);
+    TRACE("Created pipeline state %p.\n", object);
 
     *state = object;
-
     return S_OK;
 }
 
+HRESULT d3d12_pipeline_state_create_compute(struct d3d12_device *device,
+        const D3D12_COMPUTE_PIPELINE_STATE_DESC *desc, struct d3d12_pipeline_state **state)
+{
+    struct d3d12_pipeline_state_desc pipeline_desc;
+
+    pipeline_state_desc_from_d3d12_compute_desc(&pipeline_desc, desc);
+
+    return d3d12_pipeline_state_create_from_desc(device, &pipeline_desc, VK_PIPELINE_BIND_POINT_COMPUTE, state);
+}
+
+HRESULT d3d12_pipeline_state_create_graphics(struct d3d12_device *device,
+        const D3D12_GRAPHICS_PIPELINE_STATE_DESC *desc, struct d3d12_pipeline_state **state)
+{
+    struct d3d12_pipeline_state_desc pipeline_desc;
+
+    pipeline_state_desc_from_d3d12_graphics_desc(&pipeline_desc, desc);
+
+    return d3d12_pipeline_state_create_from_desc(device, &pipeline_desc, VK_PIPELINE_BIND_POINT_GRAPHICS, state);
+}
+
 HRESULT d3d12_pipeline_state_create(struct d3d12_device *device,
         const D3D12_PIPELINE_STATE_STREAM_DESC *desc, struct d3d12_pipeline_state **state)
 {
     struct d3d12_pipeline_state_desc pipeline_desc;
-    struct d3d12_pipeline_state *object;
     VkPipelineBindPoint bind_point;
     HRESULT hr;
 
     if (FAILED(hr = pipeline_state_desc_from_d3d12_stream_desc(&pipeline_desc, desc, &bind_point)))
         return hr;
 
-    if (!(object = vkd3d_calloc(1, sizeof(*object))))
-        return E_OUTOFMEMORY;
+    return d3d12_pipeline_state_create_from_desc(device, &pipeline_desc, bind_point, state);
+}
 
-    switch (bind_point)
-    {
-        case VK_PIPELINE_BIND_POINT_COMPUTE:
-            hr = d3d12_pipeline_state_init_compute(object, device, &pipeline_desc);
-            break;
+/* ID3D12PipelineLibrary */
+#define VKD3D_PIPELINE_LIBRARY_MAGIC VKD3D_MAKE_TAG('V', 'K', 'P', 'L')
 
-        case VK_PIPELINE_BIND_POINT_GRAPHICS:
-            hr = d3d12_pipeline_state_init_graphics(object, device, &pipeline_desc);
-            break;
+/* A serialised pipeline library consists of this header, followed by
+ * "entry_count" entries. Each entry is a vkd3d_pipeline_library_entry_header,
+ * the NUL-terminated UTF-8 pipeline name, and the pipeline cache data of the
+ * pipeline state, as returned by GetCachedBlob(). The name and the data are
+ * padded to 8 bytes. */
+struct vkd3d_pipeline_library_header
+{
+    uint32_t magic;
+    uint32_t entry_count;
+};
 
-        default:
-            vkd3d_unreachable();
-    }
+struct vkd3d_pipeline_library_entry_header
+{
+    uint64_t cache_key;
+    uint64_t data_size;
+    uint32_t name_size;
+    uint32_t padding;
+};
 
-    if (FAILED(hr))
-    {
-        vkd3d_free(object);
-        return hr;
-    }
+static inline struct d3d12_pipeline_library *impl_from_ID3D12PipelineLibrary1(ID3D12PipelineLibrary1 *iface)
+{
+    return CONTAINING_RECORD(iface, struct d3d12_pipeline_library, ID3D12PipelineLibrary1_iface);
+}
 
-    TRACE("Created pipeline state %p.\n", object);
+static HRESULT STDMETHODCALLTYPE d3d12_pipeline_library_QueryInterface(ID3D12PipelineLibrary1 *iface,
+        REFIID riid, void **object)
+{
+    TRACE("iface %p, riid %s, object %p.\n", iface, debugstr_guid(riid), object);
+
+    if (IsEqualGUID(riid, &IID_ID3D12PipelineLibrary1)
+            || IsEqualGUID(riid, &IID_ID3D12PipelineLibrary)
+            || IsEqualGUID(riid, &IID_ID3D12DeviceChild)
+            || IsEqualGUID(riid, &IID_ID3D12Object)
+            || IsEqualGUID(riid, &IID_IUnknown))
+    {
+        ID3D12PipelineLibrary1_AddRef(iface);
+        *object = iface;
+        return S_OK;
+    }
+
+    WARN("%s not implemented, returning E_NOINTERFACE.\n", debugstr_guid(riid));
+
+    *object = NULL;
+    return E_NOINTERFACE;
+}
+
+static ULONG STDMETHODCALLTYPE d3d12_pipeline_library_AddRef(ID3D12PipelineLibrary1 *iface)
+{
+    struct d3d12_pipeline_library *library = impl_from_ID3D12PipelineLibrary1(iface);
+    ULONG refcount = InterlockedIncrement(&library->refcount);
+
+    TRACE("%p increasing refcount to %u.\n", library, refcount);
+
+    return refcount;
+}
+
+static void d3d12_pipeline_library_cleanup(struct d3d12_pipeline_library *library)
+{
+    struct d3d12_pipeline_library_entry *entry;
+    size_t i;
+
+    for (i = 0; i < library->entry_count; ++i)
+    {
+        entry = &library->entries[i];
+        if (entry->state)
+            ID3D12PipelineState_Release(&entry->state->ID3D12PipelineState_iface);
+        vkd3d_free(entry->data);
+        vkd3d_free(entry->name);
+    }
+    vkd3d_free(library->entries);
+    vkd3d_mutex_destroy(&library->mutex);
+}
+
+static ULONG STDMETHODCALLTYPE d3d12_pipeline_library_Release(ID3D12PipelineLibrary1 *iface)
+{
+    struct d3d12_pipeline_library *library = impl_from_ID3D12PipelineLibrary1(iface);
+    ULONG refcount = InterlockedDecrement(&library->refcount);
+
+    TRACE("%p decreasing refcount to %u.\n", library, refcount);
+
+    if (!refcount)
+    {
+        struct d3d12_device *device = library->device;
+
+        vkd3d_private_store_destroy(&library->private_store);
+        d3d12_pipeline_library_cleanup(library);
+        vkd3d_free(library);
+
+        d3d12_device_release(device);
+    }
+
+    return refcount;
+}
+
+static HRESULT STDMETHODCALLTYPE d3d12_pipeline_library_GetPrivateData(ID3D12PipelineLibrary1 *iface,
+        REFGUID guid, UINT *data_size, void *data)
+{
+    struct d3d12_pipeline_library *library = impl_from_ID3D12PipelineLibrary1(iface);
+
+    TRACE("iface %p, guid %s, data_size %p, data %p.\n", iface, debugstr_guid(guid), data_size, data);
+
+    return vkd3d_get_private_data(&library->private_store, guid, data_size, data);
+}
+
+static HRESULT STDMETHODCALLTYPE d3d12_pipeline_library_SetPrivateData(ID3D12PipelineLibrary1 *iface,
+        REFGUID guid, UINT data_size, const void *data)
+{
+    struct d3d12_pipeline_library *library = impl_from_ID3D12PipelineLibrary1(iface);
+
+    TRACE("iface %p, guid %s, data_size %u, data %p.\n", iface, debugstr_guid(guid), data_size, data);
+
+    return vkd3d_set_private_data(&library->private_store, guid, data_size, data);
+}
+
+static HRESULT STDMETHODCALLTYPE d3d12_pipeline_library_SetPrivateDataInterface(ID3D12PipelineLibrary1 *iface,
+        REFGUID guid, const IUnknown *data)
+{
+    struct d3d12_pipeline_library *library = impl_from_ID3D12PipelineLibrary1(iface);
+
+    TRACE("iface %p, guid %s, data %p.\n", iface, debugstr_guid(guid), data);
+
+    return vkd3d_set_private_data_interface(&library->private_store, guid, data);
+}
+
+static HRESULT STDMETHODCALLTYPE d3d12_pipeline_library_SetName(ID3D12PipelineLibrary1 *iface, const WCHAR *name)
+{
+    struct d3d12_pipeline_library *library = impl_from_ID3D12PipelineLibrary1(iface);
+
+    TRACE("iface %p, name %s.\n", iface, debugstr_w(name, library->device->wchar_size));
+
+    return name ? S_OK : E_INVALIDARG;
+}
+
+static HRESULT STDMETHODCALLTYPE d3d12_pipeline_library_GetDevice(ID3D12PipelineLibrary1 *iface,
+        REFIID iid, void **device)
+{
+    struct d3d12_pipeline_library *library = impl_from_ID3D12PipelineLibrary1(iface);
+
+    TRACE("iface %p, iid %s, device %p.\n", iface, debugstr_guid(iid), device);
+
+    return d3d12_device_query_interface(library->device, iid, device);
+}
+
+/* Called with the library mutex held. */
+static struct d3d12_pipeline_library_entry *d3d12_pipeline_library_find_entry(
+        struct d3d12_pipeline_library *library, const char *name)
+{
+    size_t i;
+
+    for (i = 0; i < library->entry_count; ++i)
+    {
+        if (!strcmp(library->entries[i].name, name))
+            return &library->entries[i];
+    }
+
+    return NULL;
+}
+
+/* Called with the library mutex held. Takes ownership of "name" and "data". */
+static HRESULT d3d12_pipeline_library_add_entry(struct d3d12_pipeline_library *library, char *name,
+        uint64_t cache_key, struct d3d12_pipeline_state *state, void *data, size_t data_size)
+{
+    struct d3d12_pipeline_library_entry *entry;
+
+    if (d3d12_pipeline_library_find_entry(library, name))
+    {
+        WARN("Pipeline %s already exists.\n", debugstr_a(name));
+        vkd3d_free(name);
+        vkd3d_free(data);
+        return E_INVALIDARG;
+    }
+
+    if (!vkd3d_array_reserve((void **)&library->entries, &library->entries_size,
+            library->entry_count + 1, sizeof(*library->entries)))
+    {
+        vkd3d_free(name);
+        vkd3d_free(data);
+        return E_OUTOFMEMORY;
+    }
+
+    entry = &library->entries[library->entry_count++];
+    entry->name = name;
+    entry->cache_key = cache_key;
+    if ((entry->state = state))
+        ID3D12PipelineState_AddRef(&state->ID3D12PipelineState_iface);
+    entry->data = data;
+    entry->data_size = data_size;
+
+    return S_OK;
+}
+
+/* Called with the library mutex held. */
+static HRESULT d3d12_pipeline_library_entry_update_data(struct d3d12_pipeline_library_entry *entry)
+{
+    void *data;
+    size_t size;
+    HRESULT hr;
+
+    if (!entry->state)
+        return S_OK;
+
+    if (FAILED(hr = d3d12_pipeline_state_get_cache_data(entry->state, &data, &size)))
+        return hr;
+
+    vkd3d_free(entry->data);
+    entry->data = data;
+    entry->data_size = size;
+
+    return S_OK;
+}
+
+static size_t d3d12_pipeline_library_entry_get_serialized_size(const struct d3d12_pipeline_library_entry *entry)
+{
+    return sizeof(struct vkd3d_pipeline_library_entry_header)
+            + align(strlen(entry->name) + 1, sizeof(uint64_t)) + align(entry->data_size, sizeof(uint64_t));
+}
+
+static HRESULT STDMETHODCALLTYPE d3d12_pipeline_library_StorePipeline(ID3D12PipelineLibrary1 *iface,
+        const WCHAR *name, ID3D12PipelineState *pipeline)
+{
+    struct d3d12_pipeline_library *library = impl_from_ID3D12PipelineLibrary1(iface);
+    struct d3d12_pipeline_state *state;
+    char *utf8_name;
+    HRESULT hr;
+
+    TRACE("iface %p, name %s, pipeline %p.\n", iface, debugstr_w(name, library->device->wchar_size), pipeline);
+
+    if (!name || !(state = unsafe_impl_from_ID3D12PipelineState(pipeline)))
+        return E_INVALIDARG;
+
+    if (!(utf8_name = vkd3d_strdup_w_utf8(name, library->device->wchar_size)))
+        return E_OUTOFMEMORY;
+
+    vkd3d_mutex_lock(&library->mutex);
+    hr = d3d12_pipeline_library_add_entry(library, utf8_name, state->cache_key, state, NULL, 0);
+    vkd3d_mutex_unlock(&library->mutex);
+
+    return hr;
+}
+
+/* The description must match the one the pipeline was stored with. The
+ * pipeline is created from its stored cache data, as if that had been passed
+ * as the cached PSO. */
+static HRESULT d3d12_pipeline_library_load_pipeline(struct d3d12_pipeline_library *library,
+        const WCHAR *name, struct d3d12_pipeline_state_desc *desc, VkPipelineBindPoint bind_point,
+        REFIID iid, void **pipeline_state)
+{
+    struct d3d12_pipeline_library_entry *entry;
+    struct d3d12_pipeline_state *object, *state = NULL;
+    const void *data = NULL;
+    void *state_data = NULL;
+    size_t data_size = 0;
+    char *utf8_name;
+    HRESULT hr;
+
+    if (!name)
+        return E_INVALIDARG;
+
+    if (!(utf8_name = vkd3d_strdup_w_utf8(name, library->device->wchar_size)))
+        return E_OUTOFMEMORY;
+
+    vkd3d_mutex_lock(&library->mutex);
+    if (!(entry = d3d12_pipeline_library_find_entry(library, utf8_name)))
+    {
+        WARN("Pipeline %s not found.\n", debugstr_a(utf8_name));
+        hr = E_INVALIDARG;
+    }
+    else if (entry->cache_key != d3d12_pipeline_state_desc_get_hash(desc))
+    {
+        WARN("Pipeline %s was stored with a different description.\n", debugstr_a(utf8_name));
+        hr = E_INVALIDARG;
+    }
+    else
+    {
+        /* Loaded data is never modified or freed until the library is
+         * destroyed, so it can be used without holding the mutex. */
+        if ((state = entry->state))
+            ID3D12PipelineState_AddRef(&state->ID3D12PipelineState_iface);
+        data = entry->data;
+        data_size = entry->data_size;
+        hr = S_OK;
+    }
+    vkd3d_mutex_unlock(&library->mutex);
+    vkd3d_free(utf8_name);
+
+    if (FAILED(hr))
+        return hr;
+
+    if (state)
+    {
+        hr = d3d12_pipeline_state_get_cache_data(state, &state_data, &data_size);
+        ID3D12PipelineState_Release(&state->ID3D12PipelineState_iface);
+        if (FAILED(hr))
+            return hr;
+        data = state_data;
+    }
+
+    desc->cached_pso.pCachedBlob = data;
+    desc->cached_pso.CachedBlobSizeInBytes = data_size;
+    hr = d3d12_pipeline_state_create_from_desc(library->device, desc, bind_point, &object);
+    vkd3d_free(state_data);
+    if (FAILED(hr))
+        return hr;
+
+    return return_interface(&object->ID3D12PipelineState_iface,
+            &IID_ID3D12PipelineState, iid, pipeline_state);
+}
+
+static HRESULT STDMETHODCALLTYPE d3d12_pipeline_library_LoadGraphicsPipeline(ID3D12PipelineLibrary1 *iface,
+        const WCHAR *name, const D3D12_GRAPHICS_PIPELINE_STATE_DESC *desc, REFIID iid, void **pipeline_state)
+{
+    struct d3d12_pipeline_library *library = impl_from_ID3D12PipelineLibrary1(iface);
+    struct d3d12_pipeline_state_desc pipeline_desc;
+
+    TRACE("iface %p, name %s, desc %p, iid %s, pipeline_state %p.\n", iface,
+            debugstr_w(name, library->device->wchar_size), desc, debugstr_guid(iid), pipeline_state);
+
+    if (!desc)
+        return E_INVALIDARG;
+
+    pipeline_state_desc_from_d3d12_graphics_desc(&pipeline_desc, desc);
+
+    return d3d12_pipeline_library_load_pipeline(library, name, &pipeline_desc,
+            VK_PIPELINE_BIND_POINT_GRAPHICS, iid, pipeline_state);
+}
+
+static HRESULT STDMETHODCALLTYPE d3d12_pipeline_library_LoadComputePipeline(ID3D12PipelineLibrary1 *iface,
+        const WCHAR *name, const D3D12_COMPUTE_PIPELINE_STATE_DESC *desc, REFIID iid, void **pipeline_state)
+{
+    struct d3d12_pipeline_library *library = impl_from_ID3D12PipelineLibrary1(iface);
+    struct d3d12_pipeline_state_desc pipeline_desc;
+
+    TRACE("iface %p, name %s, desc %p, iid %s, pipeline_state %p.\n", iface,
+            debugstr_w(name, library->device->wchar_size), desc, debugstr_guid(iid), pipeline_state);
+
+    if (!desc)
+        return E_INVALIDARG;
+
+    pipeline_state_desc_from_d3d12_compute_desc(&pipeline_desc, desc);
+
+    return d3d12_pipeline_library_load_pipeline(library, name, &pipeline_desc,
+            VK_PIPELINE_BIND_POINT_COMPUTE, iid, pipeline_state);
+}
+
+static SIZE_T STDMETHODCALLTYPE d3d12_pipeline_library_GetSerializedSize(ID3D12PipelineLibrary1 *iface)
+{
+    struct d3d12_pipeline_library *library = impl_from_ID3D12PipelineLibrary1(iface);
+    size_t size = sizeof(struct vkd3d_pipeline_library_header);
+    size_t i;
+
+    TRACE("iface %p.\n", iface);
+
+    /* Take a fresh snapshot of the stored pipelines; Serialize() writes
+     * exactly the data measured here. */
+    vkd3d_mutex_lock(&library->mutex);
+    for (i = 0; i < library->entry_count; ++i)
+    {
+        if (FAILED(d3d12_pipeline_library_entry_update_data(&library->entries[i])))
+        {
+            vkd3d_mutex_unlock(&library->mutex);
+            return 0;
+        }
+        size += d3d12_pipeline_library_entry_get_serialized_size(&library->entries[i]);
+    }
+    vkd3d_mutex_unlock(&library->mutex);
+
+    return size;
+}
+
+static HRESULT STDMETHODCALLTYPE d3d12_pipeline_library_Serialize(ID3D12PipelineLibrary1 *iface,
+        void *data, SIZE_T data_size)
+{
+    struct d3d12_pipeline_library *library = impl_from_ID3D12PipelineLibrary1(iface);
+    struct vkd3d_pipeline_library_entry_header *entry_header;
+    struct vkd3d_pipeline_library_header *header = data;
+    const struct d3d12_pipeline_library_entry *entry;
+    size_t size = sizeof(*header), name_size, i;
+    HRESULT hr;
+    char *ptr;
+
+    TRACE("iface %p, data %p, data_size %lu.\n", iface, data, data_size);
+
+    vkd3d_mutex_lock(&library->mutex);
+
+    for (i = 0; i < library->entry_count; ++i)
+    {
+        if (library->entries[i].state && !library->entries[i].data
+                && FAILED(hr = d3d12_pipeline_library_entry_update_data(&library->entries[i])))
+        {
+            vkd3d_mutex_unlock(&library->mutex);
+            return hr;
+        }
+        size += d3d12_pipeline_library_entry_get_serialized_size(&library->entries[i]);
+    }
+
+    if (!data || data_size < size)
+    {
+        vkd3d_mutex_unlock(&library->mutex);
+        WARN("Invalid data size %lu, expected %zu.\n", data_size, size);
+        return E_INVALIDARG;
+    }
+
+    memset(data, 0, size);
+    header->magic = VKD3D_PIPELINE_LIBRARY_MAGIC;
+    header->entry_count = library->entry_count;
+
+    ptr = (char *)(header + 1);
+    for (i = 0; i < library->entry_count; ++i)
+    {
+        entry = &library->entries[i];
+        name_size = strlen(entry->name) + 1;
+
+        entry_header = (struct vkd3d_pipeline_library_entry_header *)ptr;
+        entry_header->cache_key = entry->cache_key;
+        entry_header->data_size = entry->data_size;
+        entry_header->name_size = name_size;
+        ptr = (char *)(entry_header + 1);
+
+        memcpy(ptr, entry->name, name_size);
+        ptr += align(name_size, sizeof(uint64_t));
+        memcpy(ptr, entry->data, entry->data_size);
+        ptr += align(entry->data_size, sizeof(uint64_t));
+    }
+
+    vkd3d_mutex_unlock(&library->mutex);
+
+    return S_OK;
+}
+
+static HRESULT STDMETHODCALLTYPE d3d12_pipeline_library_LoadPipeline(ID3D12PipelineLibrary1 *iface,
+        const WCHAR *name, const D3D12_PIPELINE_STATE_STREAM_DESC *desc, REFIID iid, void **pipeline_state)
+{
+    struct d3d12_pipeline_library *library = impl_from_ID3D12PipelineLibrary1(iface);
+    struct d3d12_pipeline_state_desc pipeline_desc;
+    VkPipelineBindPoint bind_point;
+    HRESULT hr;
+
+    TRACE("iface %p, name %s, desc %p, iid %s, pipeline_state %p.\n", iface,
+            debugstr_w(name, library->device->wchar_size), desc, debugstr_guid(iid), pipeline_state);
+
+    if (!desc)
+        return E_INVALIDARG;
+
+    if (FAILED(hr = pipeline_state_desc_from_d3d12_stream_desc(&pipeline_desc, desc, &bind_point)))
+        return hr;
+
+    return d3d12_pipeline_library_load_pipeline(library, name, &pipeline_desc, bind_point, iid, pipeline_state);
+}
+
+static const struct ID3D12PipelineLibrary1Vtbl d3d12_pipeline_library_vtbl =
+{
+    /* IUnknown methods */
+    d3d12_pipeline_library_QueryInterface,
+    d3d12_pipeline_library_AddRef,
+    d3d12_pipeline_library_Release,
+    /* ID3D12Object methods */
+    d3d12_pipeline_library_GetPrivateData,
+    d3d12_pipeline_library_SetPrivateData,
+    d3d12_pipeline_library_SetPrivateDataInterface,
+    d3d12_pipeline_library_SetName,
+    /* ID3D12DeviceChild methods */
+    d3d12_pipeline_library_GetDevice,
+    /* ID3D12PipelineLibrary methods */
+    d3d12_pipeline_library_StorePipeline,
+    d3d12_pipeline_library_LoadGraphicsPipeline,
+    d3d12_pipeline_library_LoadComputePipeline,
+    d3d12_pipeline_library_GetSerializedSize,
+    d3d12_pipeline_library_Serialize,
+    /* ID3D12PipelineLibrary1 methods */
+    d3d12_pipeline_library_LoadPipeline,
+};
+
+static HRESULT d3d12_pipeline_library_load(struct d3d12_pipeline_library *library,
+        const void *blob, size_t blob_size)
+{
+    const struct vkd3d_pipeline_library_header *header = blob;
+    const struct vkd3d_pipeline_library_entry_header *entry;
+    size_t remaining, name_size, data_size, i;
+    const char *ptr, *name;
+    char *name_copy;
+    void *data;
+    HRESULT hr;
+
+    if (blob_size < sizeof(*header) || header->magic != VKD3D_PIPELINE_LIBRARY_MAGIC)
+    {
+        WARN("Invalid pipeline library blob.\n");
+        return E_INVALIDARG;
+    }
+
+    ptr = (const char *)(header + 1);
+    remaining = blob_size - sizeof(*header);
+    for (i = 0; i < header->entry_count; ++i)
+    {
+        entry = (const struct vkd3d_pipeline_library_entry_header *)ptr;
+        if (remaining < sizeof(*entry))
+            goto invalid;
+        remaining -= sizeof(*entry);
+        name = (const char *)(entry + 1);
+
+        name_size = align(entry->name_size, sizeof(uint64_t));
+        if (!entry->name_size || name_size > remaining || name[entry->name_size - 1]
+                || strlen(name) != entry->name_size - 1)
+            goto invalid;
+        remaining -= name_size;
+
+        if (entry->data_size > remaining || align(entry->data_size, sizeof(uint64_t)) > remaining)
+            goto invalid;
+        data_size = entry->data_size;
+        remaining -= align(data_size, sizeof(uint64_t));
+
+        if (FAILED(hr = d3d12_device_validate_pipeline_cache_data(library->device,
+                entry->cache_key, name + name_size, data_size)))
+            return hr;
+
+        if (!(name_copy = vkd3d_strdup(name)))
+            return E_OUTOFMEMORY;
+        if (!(data = vkd3d_malloc(data_size)))
+        {
+            vkd3d_free(name_copy);
+            return E_OUTOFMEMORY;
+        }
+        memcpy(data, name + name_size, data_size);
+
+        if (FAILED(hr = d3d12_pipeline_library_add_entry(library, name_copy,
+                entry->cache_key, NULL, data, data_size)))
+            return hr;
+
+        ptr = name + name_size + align(data_size, sizeof(uint64_t));
+    }
+
+    return S_OK;
+
+invalid:
+    WARN("Invalid pipeline library entry %zu.\n", i);
+    return E_INVALIDARG;
+}
+
+static HRESULT d3d12_pipeline_library_init(struct d3d12_pipeline_library *library,
+        struct d3d12_device *device, const void *blob, size_t blob_size)
+{
+    HRESULT hr;
+
+    library->ID3D12PipelineLibrary1_iface.lpVtbl = &d3d12_pipeline_library_vtbl;
+    library->refcount = 1;
+
+    library->entries = NULL;
+    library->entries_size = 0;
+    library->entry_count = 0;
+    library->device = device;
+
+    vkd3d_mutex_init(&library->mutex);
+
+    if (blob_size && FAILED(hr = d3d12_pipeline_library_load(library, blob, blob_size)))
+    {
+        d3d12_pipeline_library_cleanup(library);
+        return hr;
+    }
+
+    if (FAILED(hr = vkd3d_private_store_init(&library->private_store)))
+    {
+        d3d12_pipeline_library_cleanup(library);
+        return hr;
+    }
+
+    d3d12_device_add_ref(device);
+
+    return S_OK;
+}
+
+HRESULT d3d12_pipeline_library_create(struct d3d12_device *device, const void *blob, size_t blob_size,
+        struct d3d12_pipeline_library **library)
+{
+    struct d3d12_pipeline_library *object;
+    HRESULT hr;
+
+    if (!(object = vkd3d_malloc(sizeof(*object))))
+        return E_OUTOFMEMORY;
+
+    if (FAILED(hr = d3d12_pipeline_library_init(object, device, blob, blob_size)))
+    {
+        vkd3d_free(object);
+        return hr;
+    }
+
+    TRACE("Created pipeline library %p.\n", object);
+
+    *library = object;
 
-    *state = object;
     return S_OK;
 }
 
@@ -3830,7 +4850,7 @@ VkPipeline d3d12_pipeline_state_get_or_create_pipeline(struct d3d12_pipeline_sta
 
     *vk_render_pass = pipeline_desc.renderPass;
 
-    if ((vr = VK_CALL(vkCreateGraphicsPipelines(device->vk_device, device->vk_pipeline_cache,
+    if ((vr = VK_CALL(vkCreateGraphicsPipelines(device->vk_device, state->vk_pipeline_cache,
             1, &pipeline_desc, NULL, &vk_pipeline))) < 0)
     {
         WARN("Failed to create Vulkan graphics pipeline, vr %d.\n", vr);
@@ -4037,7 +5057,7 @@ HRESULT vkd3d_uav_clear_state_init(struct vkd3d_uav_clear_state *state, struct d
             binding.flags = VKD3D_SHADER_BINDING_FLAG_IMAGE;
 
         hr = vkd3d_create_compute_pipeline(device, &(D3D12_SHADER_BYTECODE){dxbc.code, dxbc.size},
-                &shader_interface, *pipelines[i].pipeline_layout, pipelines[i].pipeline);
+                &shader_interface, *pipelines[i].pipeline_layout, VK_NULL_HANDLE, pipelines[i].pipeline);
         vkd3d_shader_free_shader_code(&dxbc);
         if (FAILED(hr))
         {
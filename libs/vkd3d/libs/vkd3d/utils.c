@@ -877,6 +877,28 @@ bool vkd3d_get_program_name(char program_name[PATH_MAX])
     return true;
 }
 
+#elif defined(_WIN32)
+
+bool vkd3d_get_program_name(char program_name[PATH_MAX])
+{
+    char path[MAX_PATH], *name;
+
+    if (!GetModuleFileNameA(NULL, path, ARRAY_SIZE(path)))
+    {
+        *program_name = '\0';
+        return false;
+    }
+
+    if ((name = strrchr(path, '\\')))
+        ++name;
+    else
+        name = path;
+
+    strncpy(program_name, name, PATH_MAX);
+    program_name[PATH_MAX - 1] = '\0';
+    return true;
+}
+
 #else
 
 bool vkd3d_get_program_name(char program_name[PATH_MAX])
@@ -887,6 +909,44 @@ bool vkd3d_get_program_name(char program_name[PATH_MAX])
 
 #endif  /* HAVE_DECL_PROGRAM_INVOCATION_NAME */
 
+#ifdef _WIN32
+
+/* Identify the build by the path, size and modification time of the module
+ * vkd3d is linked into, so that on-disk caches of compiled shaders are
+ * invalidated when the library is rebuilt or updated. */
+bool vkd3d_get_build_id(uint64_t *id)
+{
+    WIN32_FILE_ATTRIBUTE_DATA attributes;
+    const char *version;
+    char path[MAX_PATH];
+    HMODULE module;
+    DWORD len;
+
+    if (!GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+            (const char *)vkd3d_get_build_id, &module)
+            || !(len = GetModuleFileNameA(module, path, ARRAY_SIZE(path)))
+            || !GetFileAttributesExA(path, GetFileExInfoStandard, &attributes))
+        return false;
+
+    version = vkd3d_shader_get_version(NULL, NULL);
+    *id = vkd3d_hash_fnv1a(VKD3D_HASH_FNV1A_INIT, version, strlen(version));
+    *id = vkd3d_hash_fnv1a(*id, path, len);
+    *id = vkd3d_hash_fnv1a(*id, &attributes.nFileSizeHigh, sizeof(attributes.nFileSizeHigh));
+    *id = vkd3d_hash_fnv1a(*id, &attributes.nFileSizeLow, sizeof(attributes.nFileSizeLow));
+    *id = vkd3d_hash_fnv1a(*id, &attributes.ftLastWriteTime, sizeof(attributes.ftLastWriteTime));
+
+    return true;
+}
+
+#else
+
+bool vkd3d_get_build_id(uint64_t *id)
+{
+    return false;
+}
+
+#endif  /* _WIN32 */
+
 static struct vkd3d_private_data *vkd3d_private_store_get_private_data(
         const struct vkd3d_private_store *store, const GUID *tag)
 {
@@ -519,6 +519,51 @@ D3D12_GPU_VIRTUAL_ADDRESS vkd3d_gpu_va_allocator_allocate(struct vkd3d_gpu_va_al
 void *vkd3d_gpu_va_allocator_dereference(struct vkd3d_gpu_va_allocator *allocator, D3D12_GPU_VIRTUAL_ADDRESS address);
 void vkd3d_gpu_va_allocator_free(struct vkd3d_gpu_va_allocator *allocator, D3D12_GPU_VIRTUAL_ADDRESS address);
 
+#define VKD3D_MEMORY_SLAB_SIZE              0x400000u
+#define VKD3D_MEMORY_SLAB_MIN_SLOT_SIZE     0x1000u
+#define VKD3D_MEMORY_SLAB_MAX_SLOT_SIZE     0x40000u
+#define VKD3D_MEMORY_SLAB_CLASS_COUNT       7
+#define VKD3D_MEMORY_SLAB_MAX_SLOT_COUNT    (VKD3D_MEMORY_SLAB_SIZE / VKD3D_MEMORY_SLAB_MIN_SLOT_SIZE)
+
+/* A block of device memory divided into slots of a single power-of-two size.
+ * Slots are naturally aligned, so any resource whose size and alignment fit
+ * in a slot can be bound to one. */
+struct vkd3d_memory_slab
+{
+    struct list entry;
+    VkDeviceMemory vk_memory;
+    void *map_ptr;
+    uint32_t vk_memory_type;
+    bool optimal;
+    unsigned int slot_size;
+    unsigned int slot_count;
+    unsigned int used_count;
+    /* Slots from this index on have never been handed out. */
+    unsigned int unused_index;
+    uint32_t free_mask[VKD3D_MEMORY_SLAB_MAX_SLOT_COUNT / 32];
+};
+
+struct vkd3d_memory_allocator
+{
+    struct vkd3d_mutex mutex;
+
+    /* Buffers and optimally tiled images never share a slab, which avoids
+     * having to deal with bufferImageGranularity. */
+    struct list slabs[2][VK_MAX_MEMORY_TYPES][VKD3D_MEMORY_SLAB_CLASS_COUNT];
+
+    /* Statistics. "reserved" is the size of all slabs, "used" the size of all
+     * allocated slots, and "requested" the size actually required by the
+     * resources bound to them. */
+    unsigned int slab_count;
+    unsigned int allocation_count;
+    uint64_t reserved_size;
+    uint64_t used_size;
+    uint64_t requested_size;
+};
+
+void vkd3d_memory_allocator_init(struct vkd3d_memory_allocator *allocator);
+void vkd3d_memory_allocator_cleanup(struct vkd3d_memory_allocator *allocator, struct d3d12_device *device);
+
 struct vkd3d_render_pass_key
 {
     unsigned int attachment_count;
@@ -676,6 +721,12 @@ struct d3d12_heap
     unsigned int map_count;
     uint32_t vk_memory_type;
 
+    /* Private heaps of small committed resources may be sub-allocated from a
+     * slab. "vk_memory" and "map_ptr" are then those of the whole slab, and
+     * the resource's heap offset is the slab offset. */
+    struct vkd3d_memory_slab *slab;
+    VkDeviceSize slab_offset;
+
     struct d3d12_device *device;
 
     struct vkd3d_private_store private_store;
@@ -1057,6 +1108,8 @@ struct d3d12_descriptor_heap
     VkDescriptorPool vk_descriptor_pool;
     struct d3d12_descriptor_heap_vk_set vk_descriptor_sets[VKD3D_SET_INDEX_COUNT];
     struct vkd3d_mutex vk_sets_mutex;
+    /* Scratch space for flushing updates, protected by vk_sets_mutex. */
+    struct descriptor_writes *vk_writes;
 
     unsigned int volatile dirty_list_head;
 
@@ -1290,6 +1343,13 @@ struct d3d12_pipeline_state
 
     struct d3d12_pipeline_uav_counter_state uav_counters;
 
+    /* Pipelines are created with a cache of their own. It's initialised from
+     * the CachedPSO blob, or from the on-disk cache entry for "cache_key",
+     * which is a hash of the pipeline state description. */
+    VkPipelineCache vk_pipeline_cache;
+    uint64_t cache_key;
+    size_t cache_initial_size;
+
     struct d3d12_device *device;
 
     struct vkd3d_private_store private_store;
@@ -1353,6 +1413,37 @@ VkPipeline d3d12_pipeline_state_get_or_create_pipeline(struct d3d12_pipeline_sta
         D3D12_PRIMITIVE_TOPOLOGY topology, const uint32_t *strides, VkFormat dsv_format, VkRenderPass *vk_render_pass);
 struct d3d12_pipeline_state *unsafe_impl_from_ID3D12PipelineState(ID3D12PipelineState *iface);
 
+/* ID3D12PipelineLibrary */
+struct d3d12_pipeline_library_entry
+{
+    char *name;
+    uint64_t cache_key;
+    /* Pipelines stored with StorePipeline() keep a reference to the pipeline
+     * state; their cache data is only taken when the library is serialised.
+     * Otherwise "data" holds the cache data loaded from the library blob. */
+    struct d3d12_pipeline_state *state;
+    void *data;
+    size_t data_size;
+};
+
+struct d3d12_pipeline_library
+{
+    ID3D12PipelineLibrary1 ID3D12PipelineLibrary1_iface;
+    LONG refcount;
+
+    struct vkd3d_mutex mutex;
+    struct d3d12_pipeline_library_entry *entries;
+    size_t entries_size;
+    size_t entry_count;
+
+    struct d3d12_device *device;
+
+    struct vkd3d_private_store private_store;
+};
+
+HRESULT d3d12_pipeline_library_create(struct d3d12_device *device, const void *blob, size_t blob_size,
+        struct d3d12_pipeline_library **library);
+
 struct vkd3d_buffer
 {
     VkBuffer vk_buffer;
@@ -1507,6 +1598,12 @@ struct d3d12_command_list
     struct d3d12_descriptor_heap *descriptor_heaps[64];
     unsigned int descriptor_heap_count;
 
+    VkWriteDescriptorSet *descriptor_writes;
+    size_t descriptor_writes_size;
+    VkDescriptorImageInfo *descriptor_image_infos;
+    size_t descriptor_image_infos_size;
+    size_t descriptor_write_count;
+
     struct vkd3d_private_store private_store;
 };
 
@@ -1741,6 +1838,20 @@ struct vkd3d_desc_object_cache
     size_t size;
 };
 
+/* An on-disk cache directory, holding files with "extension" up to about
+ * "max_size" bytes in total. */
+struct vkd3d_cache_dir
+{
+    char *path;
+    const char *extension;
+    uint64_t max_size;
+    /* Protects size and evicting. The cache files themselves are accessed
+     * without holding it. */
+    struct vkd3d_mutex mutex;
+    uint64_t size;
+    bool evicting;
+};
+
 #define VKD3D_DESCRIPTOR_POOL_COUNT 6
 
 /* ID3D12Device */
@@ -1756,12 +1867,16 @@ struct d3d12_device
     size_t wchar_size;
 
     struct vkd3d_gpu_va_allocator gpu_va_allocator;
+    struct vkd3d_memory_allocator memory_allocator;
 
     struct vkd3d_mutex mutex;
     struct vkd3d_desc_object_cache view_desc_cache;
     struct vkd3d_desc_object_cache cbuffer_desc_cache;
     struct vkd3d_render_pass_cache render_pass_cache;
     VkPipelineCache vk_pipeline_cache;
+    struct vkd3d_cache_dir pipeline_cache_dir;
+    struct vkd3d_cache_dir shader_cache_dir;
+    uint64_t shader_cache_build_id;
 
     VkPhysicalDeviceMemoryProperties memory_properties;
 
@@ -1813,6 +1928,17 @@ bool d3d12_device_is_uma(struct d3d12_device *device, bool *coherent);
 void d3d12_device_mark_as_removed(struct d3d12_device *device, HRESULT reason,
         const char *message, ...) VKD3D_PRINTF_FUNC(3, 4);
 struct d3d12_device *unsafe_impl_from_ID3D12Device5(ID3D12Device5 *iface);
+HRESULT d3d12_device_get_pipeline_cache_data(struct d3d12_device *device,
+        VkPipelineCache vk_cache, uint64_t key, void *data, size_t *size);
+HRESULT d3d12_device_create_pipeline_cache(struct d3d12_device *device,
+        uint64_t key, const void *data, size_t size, VkPipelineCache *vk_cache);
+void *d3d12_device_load_pipeline_cache(struct d3d12_device *device, uint64_t key, size_t *size);
+HRESULT d3d12_device_validate_pipeline_cache_data(struct d3d12_device *device,
+        uint64_t key, const void *data, size_t size);
+void d3d12_device_store_pipeline_cache(struct d3d12_device *device, uint64_t key,
+        VkPipelineCache vk_cache, size_t initial_size);
+bool d3d12_device_load_shader_cache(struct d3d12_device *device, uint64_t key, struct vkd3d_shader_code *spirv);
+void d3d12_device_store_shader_cache(struct d3d12_device *device, uint64_t key, const struct vkd3d_shader_code *spirv);
 
 static inline HRESULT d3d12_device_query_interface(struct d3d12_device *device, REFIID iid, void **object)
 {
@@ -1962,7 +2088,25 @@ HRESULT vkd3d_load_vk_device_procs(struct vkd3d_vk_device_procs *procs,
 
 extern const char vkd3d_build[];
 
+#define VKD3D_HASH_FNV1A_INIT 0xcbf29ce484222325ull
+
+/* 64-bit FNV-1a. */
+static inline uint64_t vkd3d_hash_fnv1a(uint64_t hash, const void *data, size_t size)
+{
+    const uint8_t *ptr = data;
+    size_t i;
+
+    for (i = 0; i < size; ++i)
+    {
+        hash ^= ptr[i];
+        hash *= 0x100000001b3ull;
+    }
+
+    return hash;
+}
+
 bool vkd3d_get_program_name(char program_name[PATH_MAX]);
+bool vkd3d_get_build_id(uint64_t *id);
 
 VkResult vkd3d_set_vk_object_name_utf8(struct d3d12_device *device, uint64_t vk_object,
         VkDebugReportObjectTypeEXT vk_object_type, const char *name);
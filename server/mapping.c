@@ -1273,6 +1273,22 @@ struct object *create_user_data_mapping( struct object *root, const struct unico
     return &mapping->obj;
 }
 
+/* create an anonymous mapping that the server keeps mapped for writing */
+struct object *create_shared_mapping( mem_size_t size, void **ptr )
+{
+    struct mapping *mapping;
+
+    if (!(mapping = create_mapping( NULL, NULL, 0, size, SEC_COMMIT, 0,
+                                    FILE_READ_DATA | FILE_WRITE_DATA, NULL ))) return NULL;
+    *ptr = mmap( NULL, mapping->size, PROT_READ | PROT_WRITE, MAP_SHARED, get_unix_fd( mapping->fd ), 0 );
+    if (*ptr == MAP_FAILED)
+    {
+        release_object( mapping );
+        return NULL;
+    }
+    return &mapping->obj;
+}
+
 /* create a file mapping */
 DECL_HANDLER(create_mapping)
 {
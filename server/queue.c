@@ -26,6 +26,7 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <poll.h>
+#include <sys/mman.h>
 
 #include "ntstatus.h"
 #define WIN32_NO_STATUS
@@ -33,6 +34,7 @@
 #include "winbase.h"
 #include "wingdi.h"
 #include "winuser.h"
+#include "dde.h"
 #include "winternl.h"
 #include "ntuser.h"
 #include "hidusage.h"
@@ -129,6 +131,7 @@ struct msg_queue
     int                    paint_count;     /* pending paint messages count */
     int                    hotkey_count;    /* pending hotkey messages count */
     int                    quit_message;    /* is there a pending quit message? */
+    unsigned int           prefetched;      /* posted messages prefetched by the client */
     int                    exit_code;       /* exit code of pending quit message */
     int                    cursor_count;    /* per-queue cursor show count */
     struct list            msg_list[NB_MSG_KINDS];  /* lists of messages */
@@ -143,6 +146,8 @@ struct msg_queue
     struct hook_table     *hooks;           /* hook table */
     timeout_t              last_get_msg;    /* time of last get message call */
     int                    keystate_lock;   /* owns an input keystate lock */
+    struct object         *shm_mapping;     /* mapping of the shared queue state */
+    volatile queue_shm_t  *shm;             /* shared queue state */
 };
 
 struct hotkey
@@ -303,6 +308,7 @@ static struct msg_queue *create_msg_queue( struct thread *thread, struct thread_
         queue->paint_count     = 0;
         queue->hotkey_count    = 0;
         queue->quit_message    = 0;
+        queue->prefetched      = 0;
         queue->cursor_count    = 0;
         queue->recv_result     = NULL;
         queue->next_timer_id   = 0x7fff;
@@ -311,6 +317,8 @@ static struct msg_queue *create_msg_queue( struct thread *thread, struct thread_
         queue->hooks           = NULL;
         queue->last_get_msg    = current_time;
         queue->keystate_lock   = 0;
+        queue->shm_mapping     = NULL;
+        queue->shm             = NULL;
         list_init( &queue->send_result );
         list_init( &queue->callback_result );
         list_init( &queue->pending_timers );
@@ -592,6 +600,7 @@ static inline void set_queue_bits( struct msg_queue *queue, unsigned int bits )
     }
     queue->wake_bits |= bits;
     queue->changed_bits |= bits;
+    if (queue->shm) queue->shm->wake_bits = queue->wake_bits;
     if (is_signaled( queue )) wake_up( &queue->obj, 0 );
 }
 
@@ -600,6 +609,7 @@ static inline void clear_queue_bits( struct msg_queue *queue, unsigned int bits
 {
     queue->wake_bits &= ~bits;
     queue->changed_bits &= ~bits;
+    if (queue->shm) queue->shm->wake_bits = queue->wake_bits;
     if (!(queue->wake_bits & (QS_KEY | QS_MOUSEBUTTON)))
     {
         if (queue->keystate_lock) unlock_input_keystate( queue->input );
@@ -812,7 +822,7 @@ static void remove_queue_message( struct msg_queue *queue, struct message *msg,
         if (list_empty( &queue->msg_list[kind] )) clear_queue_bits( queue, QS_SENDMESSAGE );
         break;
     case POST_MESSAGE:
-        if (list_empty( &queue->msg_list[kind] ) && !queue->quit_message)
+        if (list_empty( &queue->msg_list[kind] ) && !queue->quit_message && !queue->prefetched)
             clear_queue_bits( queue, QS_POSTMESSAGE|QS_ALLPOSTMESSAGE );
         if (msg->msg == WM_HOTKEY && --queue->hotkey_count == 0)
             clear_queue_bits( queue, QS_HOTKEY );
@@ -964,10 +974,87 @@ static int match_window( user_handle_t win, user_handle_t msg_win )
     return is_child_window( win, msg_win );
 }
 
+/* check if a posted message can be prefetched by the client */
+static inline int is_prefetchable_message( const struct message *msg )
+{
+    if (msg->type != MSG_POSTED || msg->data_size) return 0;
+    if (msg->msg & 0x80000000) return 0;  /* internal messages are handled by the client */
+    if (msg->msg == WM_HOTKEY) return 0;
+    return msg->msg < WM_DDE_FIRST || msg->msg > WM_DDE_LAST;
+}
+
+/* remove the posted messages at the head of the queue and return them to the client */
+static void prefetch_posted_messages( struct msg_queue *queue, unsigned int max,
+                                      struct get_message_reply *reply )
+{
+    struct message *msg, *next;
+    posted_message_t *data;
+    unsigned int count = 0;
+
+    max = min( max, MAX_PREFETCHED_MESSAGES );
+    max = min( max, get_reply_max_size() / sizeof(*data) );
+
+    LIST_FOR_EACH_ENTRY( msg, &queue->msg_list[POST_MESSAGE], struct message, entry )
+    {
+        if (count == max || !is_prefetchable_message( msg )) break;
+        count++;
+    }
+    if (!count || !(data = set_reply_data_size( count * sizeof(*data) ))) return;
+
+    reply->prefetched = count;
+    LIST_FOR_EACH_ENTRY_SAFE( msg, next, &queue->msg_list[POST_MESSAGE], struct message, entry )
+    {
+        if (!count--) break;
+        data->win    = msg->win;
+        data->msg    = msg->msg;
+        data->wparam = msg->wparam;
+        data->lparam = msg->lparam;
+        data->x      = msg->x;
+        data->y      = msg->y;
+        data->time   = msg->time;
+        data->__pad  = 0;
+        data++;
+        queue->prefetched++;
+        remove_queue_message( queue, msg, POST_MESSAGE );
+    }
+}
+
+/* put the prefetched messages given back by the client in front of the queue again */
+static void requeue_prefetched_messages( struct msg_queue *queue, const posted_message_t *data,
+                                         unsigned int count )
+{
+    struct message *msg;
+
+    while (count--)
+    {
+        const posted_message_t *posted = &data[count];
+
+        /* messages for windows destroyed in the meantime are dropped, like cleanup_window does */
+        if (posted->win && !get_user_object( posted->win, USER_WINDOW )) continue;
+        if (!(msg = mem_alloc( sizeof(*msg) ))) break;
+        msg->type      = MSG_POSTED;
+        msg->win       = posted->win;
+        msg->msg       = posted->msg;
+        msg->wparam    = posted->wparam;
+        msg->lparam    = posted->lparam;
+        msg->x         = posted->x;
+        msg->y         = posted->y;
+        msg->time      = posted->time;
+        msg->data      = NULL;
+        msg->data_size = 0;
+        msg->unique_id = 0;
+        msg->result    = NULL;
+        list_add_head( &queue->msg_list[POST_MESSAGE], &msg->entry );
+    }
+    queue->prefetched = 0;
+    if (list_empty( &queue->msg_list[POST_MESSAGE] ) && !queue->quit_message)
+        clear_queue_bits( queue, QS_POSTMESSAGE|QS_ALLPOSTMESSAGE );
+}
+
 /* retrieve a posted message */
 static int get_posted_message( struct msg_queue *queue, user_handle_t win,
                                unsigned int first, unsigned int last, unsigned int flags,
-                               struct get_message_reply *reply )
+                               unsigned int prefetch, struct get_message_reply *reply )
 {
     struct message *msg;
 
@@ -999,13 +1086,18 @@ found:
 
     if (flags & PM_REMOVE)
     {
+        /* the client can only keep messages in order if we start from the head of the queue */
+        if (prefetch && list_head( &queue->msg_list[POST_MESSAGE] ) != &msg->entry) prefetch = 0;
+
         if (msg->data)
         {
             set_reply_data_ptr( msg->data, msg->data_size );
             msg->data = NULL;
             msg->data_size = 0;
+            prefetch = 0;
         }
         remove_queue_message( queue, msg, POST_MESSAGE );
+        if (prefetch) prefetch_posted_messages( queue, prefetch, reply );
     }
     else if (msg->data) set_reply_data( msg->data, msg->data_size );
 
@@ -1029,7 +1121,7 @@ static int get_quit_message( struct msg_queue *queue, unsigned int flags,
         if (flags & PM_REMOVE)
         {
             queue->quit_message = 0;
-            if (list_empty( &queue->msg_list[POST_MESSAGE] ))
+            if (list_empty( &queue->msg_list[POST_MESSAGE] ) && !queue->prefetched)
                 clear_queue_bits( queue, QS_POSTMESSAGE|QS_ALLPOSTMESSAGE );
         }
         return 1;
@@ -1182,6 +1274,8 @@ static void msg_queue_destroy( struct object *obj )
     release_object( queue->input );
     if (queue->hooks) release_object( queue->hooks );
     if (queue->fd) release_object( queue->fd );
+    if (queue->shm) munmap( (void *)queue->shm, sizeof(*queue->shm) );
+    if (queue->shm_mapping) release_object( queue->shm_mapping );
 }
 
 static void msg_queue_poll_event( struct fd *fd, int event )
@@ -2843,6 +2937,11 @@ DECL_HANDLER(get_message)
     queue->last_get_msg = current_time;
     if (!filter) filter = QS_ALLINPUT;
 
+    /* the client gives back the prefetched messages it couldn't use, so that the
+     * filters below see the queue in the same order as if nothing had been prefetched */
+    if (queue->prefetched)
+        requeue_prefetched_messages( queue, get_req_data(), get_req_data_size() / sizeof(posted_message_t) );
+
     /* first check for sent messages */
     if ((ptr = list_head( &queue->msg_list[SEND_MESSAGE] )))
     {
@@ -2862,12 +2961,13 @@ DECL_HANDLER(get_message)
 
     /* then check for posted messages */
     if ((filter & QS_POSTMESSAGE) &&
-        get_posted_message( queue, get_win, req->get_first, req->get_last, req->flags, reply ))
+        get_posted_message( queue, get_win, req->get_first, req->get_last, req->flags,
+                            req->prefetch, reply ))
         return;
 
     if ((filter & QS_HOTKEY) && queue->hotkey_count &&
         req->get_first <= WM_HOTKEY && req->get_last >= WM_HOTKEY &&
-        get_posted_message( queue, get_win, WM_HOTKEY, WM_HOTKEY, req->flags, reply ))
+        get_posted_message( queue, get_win, WM_HOTKEY, WM_HOTKEY, req->flags, 0, reply ))
         return;
 
     /* only check for quit messages if not posted messages pending */
@@ -3644,3 +3744,20 @@ DECL_HANDLER(update_rawinput_devices)
     process->rawinput_mouse = find_rawinput_device( process, MAKELONG(HID_USAGE_GENERIC_MOUSE, HID_USAGE_PAGE_GENERIC) );
     process->rawinput_kbd = find_rawinput_device( process, MAKELONG(HID_USAGE_GENERIC_KEYBOARD, HID_USAGE_PAGE_GENERIC) );
 }
+
+
+/* get a handle to the state of the current thread queue */
+DECL_HANDLER(get_queue_shm)
+{
+    struct msg_queue *queue = get_current_queue();
+    void *ptr;
+
+    if (!queue) return;
+    if (!queue->shm_mapping)
+    {
+        if (!(queue->shm_mapping = create_shared_mapping( sizeof(*queue->shm), &ptr ))) return;
+        queue->shm = ptr;
+        queue->shm->wake_bits = queue->wake_bits;
+    }
+    reply->handle = alloc_handle( current->process, queue->shm_mapping, SECTION_MAP_READ, 0 );
+}
@@ -261,6 +261,8 @@ DECL_HANDLER(set_named_pipe_info);
 DECL_HANDLER(create_window);
 DECL_HANDLER(destroy_window);
 DECL_HANDLER(get_desktop_window);
+DECL_HANDLER(get_queue_shm);
+DECL_HANDLER(get_desktop_window_shm);
 DECL_HANDLER(set_window_owner);
 DECL_HANDLER(get_window_info);
 DECL_HANDLER(set_window_info);
@@ -551,6 +553,8 @@ static const req_handler req_handlers[REQ_NB_REQUESTS] =
     (req_handler)req_create_window,
     (req_handler)req_destroy_window,
     (req_handler)req_get_desktop_window,
+    (req_handler)req_get_queue_shm,
+    (req_handler)req_get_desktop_window_shm,
     (req_handler)req_set_window_owner,
     (req_handler)req_get_window_info,
     (req_handler)req_set_window_info,
@@ -1408,7 +1412,8 @@ C_ASSERT( FIELD_OFFSET(struct get_message_request, get_last) == 24 );
 C_ASSERT( FIELD_OFFSET(struct get_message_request, hw_id) == 28 );
 C_ASSERT( FIELD_OFFSET(struct get_message_request, wake_mask) == 32 );
 C_ASSERT( FIELD_OFFSET(struct get_message_request, changed_mask) == 36 );
-C_ASSERT( sizeof(struct get_message_request) == 40 );
+C_ASSERT( FIELD_OFFSET(struct get_message_request, prefetch) == 40 );
+C_ASSERT( sizeof(struct get_message_request) == 48 );
 C_ASSERT( FIELD_OFFSET(struct get_message_reply, win) == 8 );
 C_ASSERT( FIELD_OFFSET(struct get_message_reply, msg) == 12 );
 C_ASSERT( FIELD_OFFSET(struct get_message_reply, wparam) == 16 );
@@ -1419,7 +1424,8 @@ C_ASSERT( FIELD_OFFSET(struct get_message_reply, y) == 40 );
 C_ASSERT( FIELD_OFFSET(struct get_message_reply, time) == 44 );
 C_ASSERT( FIELD_OFFSET(struct get_message_reply, active_hooks) == 48 );
 C_ASSERT( FIELD_OFFSET(struct get_message_reply, total) == 52 );
-C_ASSERT( sizeof(struct get_message_reply) == 56 );
+C_ASSERT( FIELD_OFFSET(struct get_message_reply, prefetched) == 56 );
+C_ASSERT( sizeof(struct get_message_reply) == 64 );
 C_ASSERT( FIELD_OFFSET(struct reply_message_request, remove) == 12 );
 C_ASSERT( FIELD_OFFSET(struct reply_message_request, result) == 16 );
 C_ASSERT( sizeof(struct reply_message_request) == 24 );
@@ -1539,6 +1545,12 @@ C_ASSERT( sizeof(struct get_desktop_window_request) == 16 );
 C_ASSERT( FIELD_OFFSET(struct get_desktop_window_reply, top_window) == 8 );
 C_ASSERT( FIELD_OFFSET(struct get_desktop_window_reply, msg_window) == 12 );
 C_ASSERT( sizeof(struct get_desktop_window_reply) == 16 );
+C_ASSERT( sizeof(struct get_queue_shm_request) == 16 );
+C_ASSERT( FIELD_OFFSET(struct get_queue_shm_reply, handle) == 8 );
+C_ASSERT( sizeof(struct get_queue_shm_reply) == 16 );
+C_ASSERT( sizeof(struct get_desktop_window_shm_request) == 16 );
+C_ASSERT( FIELD_OFFSET(struct get_desktop_window_shm_reply, handle) == 8 );
+C_ASSERT( sizeof(struct get_desktop_window_shm_reply) == 16 );
 C_ASSERT( FIELD_OFFSET(struct set_window_owner_request, handle) == 12 );
 C_ASSERT( FIELD_OFFSET(struct set_window_owner_request, owner) == 16 );
 C_ASSERT( sizeof(struct set_window_owner_request) == 24 );
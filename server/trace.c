@@ -1000,6 +1000,25 @@ static void dump_varargs_message_data( const char *prefix, data_size_t size )
     dump_varargs_bytes( prefix, size );
 }
 
+static void dump_varargs_posted_messages( const char *prefix, data_size_t size )
+{
+    const posted_message_t *msg = cur_data;
+    data_size_t len = size / sizeof(*msg);
+
+    fprintf( stderr, "%s{", prefix );
+    while (len > 0)
+    {
+        fprintf( stderr, "{win=%08x,msg=%08x", msg->win, msg->msg );
+        dump_uint64( ",wparam=", &msg->wparam );
+        dump_uint64( ",lparam=", &msg->lparam );
+        fprintf( stderr, ",x=%d,y=%d,time=%u}", msg->x, msg->y, msg->time );
+        msg++;
+        if (--len) fputc( ',', stderr );
+    }
+    fputc( '}', stderr );
+    remove_data( size );
+}
+
 static void dump_varargs_properties( const char *prefix, data_size_t size )
 {
     const property_data_t *prop = cur_data;
@@ -2733,6 +2752,8 @@ static void dump_get_message_request( const struct get_message_request *req )
     fprintf( stderr, ", hw_id=%08x", req->hw_id );
     fprintf( stderr, ", wake_mask=%08x", req->wake_mask );
     fprintf( stderr, ", changed_mask=%08x", req->changed_mask );
+    fprintf( stderr, ", prefetch=%08x", req->prefetch );
+    dump_varargs_posted_messages( ", prefetched=", cur_size );
 }
 
 static void dump_get_message_reply( const struct get_message_reply *req )
@@ -2747,6 +2768,7 @@ static void dump_get_message_reply( const struct get_message_reply *req )
     fprintf( stderr, ", time=%08x", req->time );
     fprintf( stderr, ", active_hooks=%08x", req->active_hooks );
     fprintf( stderr, ", total=%u", req->total );
+    fprintf( stderr, ", prefetched=%08x", req->prefetched );
     dump_varargs_message_data( ", data=", cur_size );
 }
 
@@ -2981,6 +3003,24 @@ static void dump_get_desktop_window_reply( const struct get_desktop_window_reply
     fprintf( stderr, ", msg_window=%08x", req->msg_window );
 }
 
+static void dump_get_queue_shm_request( const struct get_queue_shm_request *req )
+{
+}
+
+static void dump_get_queue_shm_reply( const struct get_queue_shm_reply *req )
+{
+    fprintf( stderr, " handle=%04x", req->handle );
+}
+
+static void dump_get_desktop_window_shm_request( const struct get_desktop_window_shm_request *req )
+{
+}
+
+static void dump_get_desktop_window_shm_reply( const struct get_desktop_window_shm_reply *req )
+{
+    fprintf( stderr, " handle=%04x", req->handle );
+}
+
 static void dump_set_window_owner_request( const struct set_window_owner_request *req )
 {
     fprintf( stderr, " handle=%08x", req->handle );
@@ -4732,6 +4772,8 @@ static const dump_func req_dumpers[REQ_NB_REQUESTS] = {
     (dump_func)dump_create_window_request,
     (dump_func)dump_destroy_window_request,
     (dump_func)dump_get_desktop_window_request,
+    (dump_func)dump_get_queue_shm_request,
+    (dump_func)dump_get_desktop_window_shm_request,
     (dump_func)dump_set_window_owner_request,
     (dump_func)dump_get_window_info_request,
     (dump_func)dump_set_window_info_request,
@@ -5019,6 +5061,8 @@ static const dump_func reply_dumpers[REQ_NB_REQUESTS] = {
     (dump_func)dump_create_window_reply,
     NULL,
     (dump_func)dump_get_desktop_window_reply,
+    (dump_func)dump_get_queue_shm_reply,
+    (dump_func)dump_get_desktop_window_shm_reply,
     (dump_func)dump_set_window_owner_reply,
     (dump_func)dump_get_window_info_reply,
     (dump_func)dump_set_window_info_reply,
@@ -5306,6 +5350,8 @@ static const char * const req_names[REQ_NB_REQUESTS] = {
     "create_window",
     "destroy_window",
     "get_desktop_window",
+    "get_queue_shm",
+    "get_desktop_window_shm",
     "set_window_owner",
     "get_window_info",
     "set_window_info",
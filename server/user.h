@@ -76,6 +76,8 @@ struct desktop
     unsigned int         users;            /* processes and threads using this desktop */
     struct global_cursor cursor;           /* global cursor information */
     unsigned char        keystate[256];    /* asynchronous key state */
+    struct object       *window_shm_mapping; /* mapping of the window information shared with the clients */
+    volatile desktop_window_shm_t *window_shm; /* server view of the shared window information */
 };
 
 /* user handles functions */
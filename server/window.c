@@ -30,6 +30,8 @@
 #include "ntuser.h"
 
 #include "object.h"
+#include "file.h"
+#include "handle.h"
 #include "request.h"
 #include "thread.h"
 #include "process.h"
@@ -201,6 +203,76 @@ static inline int is_desktop_window( const struct window *win )
     return !win->parent;  /* only desktop windows have no parent */
 }
 
+/* window information shared with the clients of the desktop, if they asked for it */
+static inline volatile window_shm_t *get_window_shm( const struct window *win )
+{
+    if (!win->desktop->window_shm || !win->handle) return NULL;
+    return &win->desktop->window_shm->windows[((win->handle & 0xffff) - FIRST_USER_HANDLE) >> 1];
+}
+
+/* the clients retry their reads while a sequence number is odd or if it changed during the read;
+ * the desktop sequence number lets them read several windows consistently */
+static inline void begin_window_shm_update( struct window *win, volatile window_shm_t *shm )
+{
+    win->desktop->window_shm->seq++;
+    shm->seq++;
+    __atomic_thread_fence( __ATOMIC_RELEASE );
+}
+
+static inline void end_window_shm_update( struct window *win, volatile window_shm_t *shm )
+{
+    __atomic_thread_fence( __ATOMIC_RELEASE );
+    shm->seq++;
+    win->desktop->window_shm->seq++;
+}
+
+/* update the shared information after the window changed */
+static void update_window_shm( struct window *win )
+{
+    volatile window_shm_t *shm;
+
+    /* windows being destroyed have already been removed */
+    if (win->is_orphan || !(shm = get_window_shm( win ))) return;
+
+    begin_window_shm_update( win, shm );
+    shm->handle    = win->handle;
+    shm->pid       = win->thread ? get_process_id( win->thread->process ) : 0;
+    shm->tid       = win->thread ? get_thread_id( win->thread ) : 0;
+    shm->parent    = win->parent ? win->parent->handle : 0;
+    shm->owner     = win->owner;
+    shm->style     = win->style;
+    shm->ex_style  = win->ex_style;
+    shm->id        = win->id;
+    shm->instance  = win->instance;
+    shm->user_data = win->user_data;
+    shm->window    = win->window_rect;
+    shm->client    = win->client_rect;
+    shm->dpi       = win->dpi;
+    end_window_shm_update( win, shm );
+}
+
+/* clear the shared information when the window handle is freed */
+static void remove_window_shm( struct window *win )
+{
+    volatile window_shm_t *shm = get_window_shm( win );
+
+    if (!shm) return;
+
+    begin_window_shm_update( win, shm );
+    shm->handle = 0;
+    end_window_shm_update( win, shm );
+}
+
+/* fill the shared information of a window and all its children */
+static void fill_window_shm( struct window *win )
+{
+    struct window *child;
+
+    update_window_shm( win );
+    LIST_FOR_EACH_ENTRY( child, &win->children, struct window, entry ) fill_window_shm( child );
+    LIST_FOR_EACH_ENTRY( child, &win->unlinked, struct window, entry ) fill_window_shm( child );
+}
+
 /* check if window is orphaned */
 static int is_orphan_window( struct window *win )
 {
@@ -309,6 +381,7 @@ static int link_window( struct window *win, struct window *previous )
     }
 
     win->is_linked = 1;
+    update_window_shm( win );
     return old_prev != win->entry.prev;
 }
 
@@ -354,6 +427,7 @@ static int set_parent_window( struct window *win, struct window *parent )
         win->is_linked = 0;
         win->is_orphan = 1;
     }
+    update_window_shm( win );
     return 1;
 }
 
@@ -626,6 +700,7 @@ static struct window *create_window( struct window *parent, struct window *owner
     }
 
     current->desktop_users++;
+    update_window_shm( win );
     return win;
 
 failed:
@@ -1825,8 +1900,10 @@ static void set_window_pos( struct window *win, struct window *previous,
             offset_rect( &child->visible_rect, new_size - old_size, 0 );
             offset_rect( &child->surface_rect, new_size - old_size, 0 );
             offset_rect( &child->client_rect, new_size - old_size, 0 );
+            update_window_shm( child );
         }
     }
+    update_window_shm( win );
 
     /* reset cursor clip rectangle when the desktop changes size */
     if (win == win->desktop->top_window) set_clip_rectangle( win->desktop, NULL, SET_CURSOR_NOCLIP, 1 );
@@ -1991,6 +2068,7 @@ void free_window_handle( struct window *win )
     {
         struct region *vis_rgn = get_visible_region( win, DCX_WINDOW );
         win->style &= ~WS_VISIBLE;
+        update_window_shm( win );
         if (vis_rgn)
         {
             struct region *exposed_rgn = expose_window( win, &win->window_rect, vis_rgn, 0 );
@@ -2039,6 +2117,8 @@ void free_window_handle( struct window *win )
         post_message( win->parent->handle, WM_PARENTNOTIFY, WM_DESTROY, win->handle );
     }
 
+    /* the thread reference to the desktop is released when detaching */
+    remove_window_shm( win );
     detach_window_thread( win );
 
     if (win->parent) set_parent_window( win, NULL );
@@ -2097,6 +2177,7 @@ DECL_HANDLER(create_window)
     }
     win->style = req->style;
     win->ex_style = req->ex_style;
+    update_window_shm( win );
 
     reply->handle    = win->handle;
     reply->parent    = win->parent ? win->parent->handle : 0;
@@ -2141,7 +2222,11 @@ DECL_HANDLER(destroy_window)
     else if ((win = get_window( req->handle )))
     {
         if (!is_desktop_window(win)) free_window_handle( win );
-        else if (win->thread == current) detach_window_thread( win );
+        else if (win->thread == current)
+        {
+            detach_window_thread( win );
+            update_window_shm( win );
+        }
         else set_error( STATUS_ACCESS_DENIED );
     }
 }
@@ -2160,6 +2245,7 @@ DECL_HANDLER(get_desktop_window)
         {
             detach_window_thread( desktop->top_window );
             desktop->top_window->style  = WS_POPUP | WS_VISIBLE | WS_CLIPSIBLINGS | WS_CLIPCHILDREN;
+            update_window_shm( desktop->top_window );
         }
     }
 
@@ -2172,6 +2258,7 @@ DECL_HANDLER(get_desktop_window)
         {
             detach_window_thread( desktop->msg_window );
             desktop->msg_window->style = WS_POPUP | WS_CLIPSIBLINGS | WS_CLIPCHILDREN;
+            update_window_shm( desktop->msg_window );
         }
     }
 
@@ -2181,6 +2268,29 @@ DECL_HANDLER(get_desktop_window)
 }
 
 
+/* get a handle to the window information shared with the clients of the thread desktop */
+DECL_HANDLER(get_desktop_window_shm)
+{
+    struct desktop *desktop = get_thread_desktop( current, 0 );
+    void *ptr;
+
+    if (!desktop) return;
+
+    if (!desktop->window_shm_mapping)
+    {
+        if ((desktop->window_shm_mapping = create_shared_mapping( sizeof(*desktop->window_shm), &ptr )))
+        {
+            desktop->window_shm = ptr;
+            if (desktop->top_window) fill_window_shm( desktop->top_window );
+            if (desktop->msg_window) fill_window_shm( desktop->msg_window );
+        }
+    }
+    if (desktop->window_shm_mapping)
+        reply->handle = alloc_handle( current->process, desktop->window_shm_mapping, SECTION_MAP_READ, 0 );
+    release_object( desktop );
+}
+
+
 /* set a window owner */
 DECL_HANDLER(set_window_owner)
 {
@@ -2207,6 +2317,7 @@ DECL_HANDLER(set_window_owner)
 
     reply->prev_owner = win->owner;
     reply->full_owner = win->owner = owner ? owner->handle : 0;
+    update_window_shm( win );
 }
 
 
@@ -2281,6 +2392,7 @@ DECL_HANDLER(set_window_info)
 
     /* changing window style triggers a non-client paint */
     if (req->flags & SET_WIN_STYLE) win->paint_flags |= PAINT_NONCLIENT;
+    if (req->flags) update_window_shm( win );
 }
 
 
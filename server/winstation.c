@@ -23,6 +23,7 @@
 #include <stdio.h>
 #include <stdarg.h>
 #include <sys/types.h>
+#include <sys/mman.h>
 
 #include "ntstatus.h"
 #define WIN32_NO_STATUS
@@ -248,6 +249,8 @@ static struct desktop *create_desktop( const struct unicode_str *name, unsigned
             desktop->users = 0;
             memset( &desktop->cursor, 0, sizeof(desktop->cursor) );
             memset( desktop->keystate, 0, sizeof(desktop->keystate) );
+            desktop->window_shm_mapping = NULL;
+            desktop->window_shm = NULL;
             list_add_tail( &winstation->desktops, &desktop->entry );
             list_init( &desktop->hotkeys );
         }
@@ -306,6 +309,8 @@ static void desktop_destroy( struct object *obj )
     if (desktop->msg_window) free_window_handle( desktop->msg_window );
     if (desktop->global_hooks) release_object( desktop->global_hooks );
     if (desktop->close_timeout) remove_timeout_user( desktop->close_timeout );
+    if (desktop->window_shm) munmap( (void *)desktop->window_shm, sizeof(*desktop->window_shm) );
+    if (desktop->window_shm_mapping) release_object( desktop->window_shm_mapping );
     list_remove( &desktop->entry );
     release_object( desktop->winstation );
 }